@@ -171,6 +171,9 @@ UNAME_S := $(shell uname -s)
 LD = $(CC)
 ifeq ($(CI_MODE),1)
 COPT = -DPBDRV_CONFIG_RUN_ON_CI
+ifeq ($(VIRTUAL_CLOCK),1)
+COPT += -DPBDRV_CONFIG_RUN_ON_CI_VIRTUAL_CLOCK
+endif
 else
 endif
 CFLAGS += $(INC) -Wall -Werror -Wdouble-promotion -Wfloat-conversion -std=gnu99 $(COPT) -D_GNU_SOURCE
@@ -148,15 +148,6 @@ typedef struct {
     /** mpy data follows thereafter. */
 } mpy_info_t;
 
-// Program data is a concatenation of multiple mpy files. This sets a reference
-// to the first script and the total size so we can search for modules.
-static mpy_info_t *mpy_first;
-static mpy_info_t *mpy_end;
-static inline void mpy_data_init(pbsys_main_program_t *program) {
-    mpy_first = (mpy_info_t *)program->code_start;
-    mpy_end = (mpy_info_t *)program->code_end;
-}
-
 /**
  * Gets a reference to the mpy data of a script.
  * @param [in]  info    A pointer to an mpy info header.
@@ -167,6 +158,84 @@ static uint8_t *mpy_data_get_buf(mpy_info_t *info) {
     return (uint8_t *)info + sizeof(info->mpy_size) + strlen(info->mpy_name) + 1;
 }
 
+/**
+ * Gets the next script in the program data.
+ * @param [in]  info    A pointer to an mpy info header.
+ * @return              A pointer to the header that follows it.
+ */
+static mpy_info_t *mpy_data_get_next(mpy_info_t *info) {
+    return (mpy_info_t *)(mpy_data_get_buf(info) + pbio_get_uint32_le(info->mpy_size));
+}
+
+// Program data is a concatenation of multiple mpy files. This sets a reference
+// to the first script and the total size so we can search for modules.
+static mpy_info_t *mpy_first;
+static mpy_info_t *mpy_end;
+
+#define MPY_DATA_FOR_EACH(info) \
+    for (mpy_info_t *info = mpy_first; (uintptr_t)info + sizeof(uint32_t) < (uintptr_t)mpy_end; info = mpy_data_get_next(info))
+
+// Hash table of all modules in the program data, so imports don't need to
+// walk the whole program. It uses open addressing with linear probing. Empty
+// slots are NULL. It is NULL if there was no room to build it.
+static mpy_info_t **mpy_index;
+static size_t mpy_index_mask;
+
+static size_t mpy_data_hash(const char *name, size_t len) {
+    return qstr_compute_hash((const byte *)name, len);
+}
+
+/**
+ * Sets the program data reference and indexes the modules it contains.
+ *
+ * The index is placed in user RAM right after the program data, so this
+ * must be called before the MicroPython heap is initialized.
+ *
+ * @param [in]  program The program to run.
+ * @return              Start of the remaining free user RAM.
+ */
+static void *mpy_data_init(pbsys_main_program_t *program) {
+    mpy_first = (mpy_info_t *)program->code_start;
+    mpy_end = (mpy_info_t *)program->code_end;
+    mpy_index = NULL;
+
+    // Use at least twice as many slots as there are modules, so probe
+    // sequences stay short.
+    size_t num_modules = 0;
+    MPY_DATA_FOR_EACH(info) {
+        num_modules++;
+    }
+    size_t num_slots = 1;
+    while (num_slots < num_modules * 2) {
+        num_slots <<= 1;
+    }
+
+    uintptr_t start = ((uintptr_t)program->user_ram_start + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+    uintptr_t end = start + num_slots * sizeof(mpy_info_t *);
+
+    // Without room for an index, imports fall back to a linear search.
+    if (end > (uintptr_t)program->user_ram_end) {
+        return program->user_ram_start;
+    }
+
+    mpy_index = (mpy_info_t **)start;
+    mpy_index_mask = num_slots - 1;
+    memset(mpy_index, 0, num_slots * sizeof(mpy_info_t *));
+
+    MPY_DATA_FOR_EACH(info) {
+        size_t i = mpy_data_hash(info->mpy_name, strlen(info->mpy_name)) & mpy_index_mask;
+        while (mpy_index[i] && strcmp(mpy_index[i]->mpy_name, info->mpy_name) != 0) {
+            i = (i + 1) & mpy_index_mask;
+        }
+        // If a name appears twice, the first one wins, as with a linear search.
+        if (!mpy_index[i]) {
+            mpy_index[i] = info;
+        }
+    }
+
+    return (void *)end;
+}
+
 /**
  * Finds a MicroPython module in the program data.
  * @param [in]  name    The fully qualified name of the module.
@@ -174,12 +243,21 @@ static uint8_t *mpy_data_get_buf(mpy_info_t *info) {
  *                      module was not found.
  */
 static mpy_info_t *mpy_data_find(qstr name) {
-    const char *name_str = qstr_str(name);
+    size_t len;
+    const char *name_str = (const char *)qstr_data(name, &len);
+
+    if (!mpy_index) {
+        MPY_DATA_FOR_EACH(info) {
+            if (strcmp(info->mpy_name, name_str) == 0) {
+                return info;
+            }
+        }
+        return NULL;
+    }
 
-    for (mpy_info_t *info = mpy_first; (uintptr_t)info + sizeof(uint32_t) < (uintptr_t)mpy_end;
-         info = (mpy_info_t *)(mpy_data_get_buf(info) + pbio_get_uint32_le(info->mpy_size))) {
-        if (strcmp(info->mpy_name, name_str) == 0) {
-            return info;
+    for (size_t i = mpy_data_hash(name_str, len) & mpy_index_mask; mpy_index[i]; i = (i + 1) & mpy_index_mask) {
+        if (strcmp(mpy_index[i]->mpy_name, name_str) == 0) {
+            return mpy_index[i];
         }
     }
 
@@ -358,12 +436,12 @@ void pbsys_main_run_program(pbsys_main_program_t *program) {
     mp_cstack_init_with_sp_here(1024 * 1024);
     #endif
 
-    // MicroPython heap is the free RAM after program data.
-    gc_init(program->user_ram_start, program->user_ram_end);
-
     // Set program data reference to first script. This is used to run main,
-    // and to set the starting point for finding downloaded modules.
-    mpy_data_init(program);
+    // and to index the downloaded modules.
+    void *heap_start = mpy_data_init(program);
+
+    // MicroPython heap is the free RAM after program data and its index.
+    gc_init(heap_start, program->user_ram_end);
 
     // Initialize MicroPython.
     mp_init();
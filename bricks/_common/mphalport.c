@@ -10,6 +10,7 @@
 #include <pbdrv/clock.h>
 #include <pbdrv/config.h>
 #include <pbio/main.h>
+#include <pbio/os.h>
 #include <pbsys/host.h>
 
 #include "py/runtime.h"
@@ -22,6 +23,8 @@
 void mp_hal_delay_ms(mp_uint_t Delay) {
     // Use systick counter to do the delay
     uint32_t start = pbdrv_clock_get_ms();
+    // Don't let the system sleep past the end of the delay.
+    pbio_os_request_wakeup(start + Delay);
     // Wraparound of tick is taken care of by 2's complement arithmetic.
     do {
         // This macro will execute the necessary idle behaviour.  It may
@@ -68,5 +68,6 @@
 #define PYBRICKS_OPT_EXTRA_LEVEL2               (1)
 #define PYBRICKS_OPT_CUSTOM_IMPORT              (1)
 #define PYBRICKS_OPT_NATIVE_MOD                 (1)
+#define PYBRICKS_OPT_ASYNC_POOL_SIZE            (16)
 
 #include "../_common/mpconfigport.h"
@@ -63,5 +63,6 @@
 #define PYBRICKS_OPT_EXTRA_LEVEL2               (0)
 #define PYBRICKS_OPT_CUSTOM_IMPORT              (1)
 #define PYBRICKS_OPT_NATIVE_MOD                 (0)
+#define PYBRICKS_OPT_ASYNC_POOL_SIZE            (8)
 
 #include "../_common/mpconfigport.h"
@@ -63,6 +63,7 @@
 #define PYBRICKS_OPT_EXTRA_LEVEL2               (1)
 #define PYBRICKS_OPT_CUSTOM_IMPORT              (0)
 #define PYBRICKS_OPT_NATIVE_MOD                 (0)
+#define PYBRICKS_OPT_ASYNC_POOL_SIZE            (16)
 
 // The Virtual Hub has no hardware interrupt that requests polling every 1ms.
 // We solve this by polling manually as appropriate for the simulation, as
@@ -83,9 +84,12 @@
 // request polling. This is done at the end of pbio_os_hook_wait_for_interrupt.
 // As above, we also need something to move it along with blocking user loops.
 // Instead of guessing with a number of instructions, here we can just poll
-// whenever the wall clock changes.
+// whenever the wall clock changes. If the virtual clock is used instead, it is
+// advanced every couple of byte codes like in the CI variant.
 #define PYBRICKS_VM_HOOK_LOOP_EXTRA \
     do { \
+        extern void pbdrv_clock_linux_virtual_advance_eventually(void); \
+        pbdrv_clock_linux_virtual_advance_eventually(); \
         static uint32_t clock_last; \
         extern uint32_t pbdrv_clock_get_ms(void); \
         uint32_t clock_now = pbdrv_clock_get_ms(); \
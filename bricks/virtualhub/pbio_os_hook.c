@@ -42,6 +42,80 @@ void pbio_os_hook_enable_irq(pbio_os_irq_flags_t flags) {
     pthread_sigmask(SIG_SETMASK, &origmask, NULL);
 }
 
+#if PBDRV_CONFIG_CLOCK_LINUX_TICKLESS
+
+#include <pbdrv/clock.h>
+
+#if PBDRV_CONFIG_BLUETOOTH_BTSTACK_POSIX
+#include <pbdrv/../../drv/bluetooth/bluetooth_btstack_posix.h>
+#endif
+
+#if PBDRV_CONFIG_CLOCK_LINUX_VIRTUAL
+#include <pbdrv/../../drv/clock/clock_linux.h>
+#endif
+
+// Provided by the USB simulation driver.
+extern int pbdrv_usb_simulation_get_fd(void);
+
+void pbio_os_hook_wait_for_interrupt(pbio_os_irq_flags_t flags) {
+
+    // Sleep until the next deadline instead of waking up periodically. If
+    // nothing waits for a deadline, sleep until there is new input or a
+    // signal.
+    struct timespec timeout;
+    struct timespec *timeout_ptr = NULL;
+    uint32_t deadline;
+    if (pbio_os_timer_get_next_deadline(&deadline)) {
+        int32_t sleep_us = (int32_t)(deadline * 1000 - pbdrv_clock_get_us());
+        if (sleep_us < 0) {
+            sleep_us = 0;
+        }
+
+        #if PBDRV_CONFIG_CLOCK_LINUX_VIRTUAL
+        // With the virtual clock, jump ahead to the deadline instead of
+        // waiting for it. We only wait as needed to match the requested speed.
+        if (pbdrv_clock_linux_virtual_is_enabled()) {
+            sleep_us = pbdrv_clock_linux_virtual_advance(sleep_us);
+        }
+        #endif
+
+        timeout.tv_sec = sleep_us / 1000000;
+        timeout.tv_nsec = (sleep_us % 1000000) * 1000;
+        timeout_ptr = &timeout;
+    }
+
+    // Also wake up as soon as there is new input.
+    fd_set read_fds;
+    fd_set write_fds;
+    FD_ZERO(&read_fds);
+    FD_ZERO(&write_fds);
+    int nfds = 0;
+
+    int stdin_fd = pbdrv_usb_simulation_get_fd();
+    if (stdin_fd >= 0) {
+        FD_SET(stdin_fd, &read_fds);
+        nfds = stdin_fd + 1;
+    }
+
+    #if PBDRV_CONFIG_BLUETOOTH_BTSTACK_POSIX
+    int bt_nfds = pbdrv_bluetooth_btstack_posix_get_fds(&read_fds, &write_fds);
+    if (bt_nfds > nfds) {
+        nfds = bt_nfds;
+    }
+    #endif
+
+    // "sleep" with "interrupts" enabled
+    sigset_t origmask = flags;
+    MP_THREAD_GIL_EXIT();
+    pselect(nfds, &read_fds, &write_fds, NULL, timeout_ptr, &origmask);
+    MP_THREAD_GIL_ENTER();
+
+    // A deadline has passed or there is new data to handle.
+    pbio_os_request_poll();
+}
+
+#else // PBDRV_CONFIG_CLOCK_LINUX_TICKLESS
+
 void pbio_os_hook_wait_for_interrupt(pbio_os_irq_flags_t flags) {
 
     struct timespec timeout = {
@@ -58,4 +132,6 @@ void pbio_os_hook_wait_for_interrupt(pbio_os_irq_flags_t flags) {
     pbio_os_request_poll();
 }
 
+#endif // PBDRV_CONFIG_CLOCK_LINUX_TICKLESS
+
 #endif
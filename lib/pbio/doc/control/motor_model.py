@@ -112,22 +112,22 @@ HEADER = textwrap.dedent(
     #define PRESCALE_TORQUE ({PRESCALE_TORQUE})
 
     typedef struct _pbio_observer_model_t {{
-        int32_t d_angle_d_speed;
-        int32_t d_speed_d_speed;
-        int32_t d_current_d_speed;
-        int32_t d_angle_d_current;
-        int32_t d_speed_d_current;
-        int32_t d_current_d_current;
-        int32_t d_angle_d_voltage;
-        int32_t d_speed_d_voltage;
-        int32_t d_current_d_voltage;
-        int32_t d_angle_d_torque;
-        int32_t d_speed_d_torque;
-        int32_t d_current_d_torque;
-        int32_t d_voltage_d_torque;
-        int32_t d_torque_d_voltage;
-        int32_t d_torque_d_speed;
-        int32_t d_torque_d_acceleration;
+        pbio_int_math_reciprocal_t d_angle_d_speed;
+        pbio_int_math_reciprocal_t d_speed_d_speed;
+        pbio_int_math_reciprocal_t d_current_d_speed;
+        pbio_int_math_reciprocal_t d_angle_d_current;
+        pbio_int_math_reciprocal_t d_speed_d_current;
+        pbio_int_math_reciprocal_t d_current_d_current;
+        pbio_int_math_reciprocal_t d_angle_d_voltage;
+        pbio_int_math_reciprocal_t d_speed_d_voltage;
+        pbio_int_math_reciprocal_t d_current_d_voltage;
+        pbio_int_math_reciprocal_t d_angle_d_torque;
+        pbio_int_math_reciprocal_t d_speed_d_torque;
+        pbio_int_math_reciprocal_t d_current_d_torque;
+        pbio_int_math_reciprocal_t d_voltage_d_torque;
+        pbio_int_math_reciprocal_t d_torque_d_voltage;
+        pbio_int_math_reciprocal_t d_torque_d_speed;
+        pbio_int_math_reciprocal_t d_torque_d_acceleration;
         int32_t torque_friction;
         int32_t feedback_gain;
     }} pbio_observer_model_t;"""
@@ -176,22 +176,22 @@ def make_model(name, *, V, tau_0, tau_x, w_0, w_x, i_0, i_x, a, Lm, h):
     return textwrap.dedent(
         f"""
         static const pbio_observer_model_t model_{name} = {{
-            .d_angle_d_speed = {round(PRESCALE_SPEED / A[0, 1])},
-            .d_speed_d_speed = {round(PRESCALE_SPEED / A[1, 1])},
-            .d_current_d_speed = {round(PRESCALE_SPEED / A[2, 1])},
-            .d_angle_d_current = {round(PRESCALE_CURRENT / A[0, 2])},
-            .d_speed_d_current = {round(PRESCALE_CURRENT / A[1, 2])},
-            .d_current_d_current = {round(PRESCALE_CURRENT / A[2, 2])},
-            .d_angle_d_voltage = {round(PRESCALE_VOLTAGE / B[0, 0])},
-            .d_speed_d_voltage = {round(PRESCALE_VOLTAGE / B[1, 0])},
-            .d_current_d_voltage = {round(PRESCALE_VOLTAGE / B[2, 0])},
-            .d_angle_d_torque = {round(PRESCALE_TORQUE / B[0, 1])},
-            .d_speed_d_torque = {round(PRESCALE_TORQUE / B[1, 1])},
-            .d_current_d_torque = {round(PRESCALE_TORQUE / B[2, 1])},
-            .d_voltage_d_torque = {round(PRESCALE_TORQUE / dv_dtau.subs(model).evalf())},
-            .d_torque_d_voltage = {round(PRESCALE_VOLTAGE / dtau_dv.subs(model).evalf())},
-            .d_torque_d_speed = {round(PRESCALE_SPEED / dtau_dw.subs(model).evalf())},
-            .d_torque_d_acceleration = {round(PRESCALE_ACCELERATION / dtau_da.subs(model).evalf())},
+            .d_angle_d_speed = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_SPEED / A[0, 1])}),
+            .d_speed_d_speed = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_SPEED / A[1, 1])}),
+            .d_current_d_speed = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_SPEED / A[2, 1])}),
+            .d_angle_d_current = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_CURRENT / A[0, 2])}),
+            .d_speed_d_current = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_CURRENT / A[1, 2])}),
+            .d_current_d_current = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_CURRENT / A[2, 2])}),
+            .d_angle_d_voltage = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_VOLTAGE / B[0, 0])}),
+            .d_speed_d_voltage = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_VOLTAGE / B[1, 0])}),
+            .d_current_d_voltage = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_VOLTAGE / B[2, 0])}),
+            .d_angle_d_torque = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_TORQUE / B[0, 1])}),
+            .d_speed_d_torque = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_TORQUE / B[1, 1])}),
+            .d_current_d_torque = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_TORQUE / B[2, 1])}),
+            .d_voltage_d_torque = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_TORQUE / dv_dtau.subs(model).evalf())}),
+            .d_torque_d_voltage = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_VOLTAGE / dtau_dv.subs(model).evalf())}),
+            .d_torque_d_speed = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_SPEED / dtau_dw.subs(model).evalf())}),
+            .d_torque_d_acceleration = PBIO_INT_MATH_RECIPROCAL({round(PRESCALE_ACCELERATION / dtau_da.subs(model).evalf())}),
             .torque_friction = {round(tau_s * c_tau)},
         }};"""
     )
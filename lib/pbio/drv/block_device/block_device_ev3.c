@@ -632,7 +632,16 @@ static pbio_error_t flash_wait_write(pbio_os_state_t *state) {
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
 
-static pbio_error_t pbdrv_block_device_write_disk(pbio_os_state_t *state, const uint8_t *buffer, uint32_t size) {
+/**
+ * Erases and writes the sectors that overlap with the given range.
+ *
+ * @param [in] state    Protothread state.
+ * @param [in] buffer   Data of the whole disk.
+ * @param [in] size     Used size of the disk.
+ * @param [in] start    Offset of the first byte to write.
+ * @param [in] end      Offset just after the last byte to write.
+ */
+static pbio_error_t pbdrv_block_device_write_disk(pbio_os_state_t *state, const uint8_t *buffer, uint32_t size, uint32_t start, uint32_t end) {
 
     static pbio_os_state_t sub;
     static uint32_t offset;
@@ -647,8 +656,13 @@ static pbio_error_t pbdrv_block_device_write_disk(pbio_os_state_t *state, const
         return PBIO_ERROR_INVALID_ARG;
     }
 
+    // Nothing changed.
+    if (start >= end) {
+        return PBIO_SUCCESS;
+    }
+
     // Erase sector by sector.
-    for (offset = 0; offset < size; offset += FLASH_SIZE_ERASE) {
+    for (offset = start; offset < end; offset += FLASH_SIZE_ERASE) {
         // Enable writing
         err = spi_begin_for_flash(cmd_write_enable, sizeof(cmd_write_enable), 0, 0, 0);
         if (err != PBIO_SUCCESS) {
@@ -672,8 +686,8 @@ static pbio_error_t pbdrv_block_device_write_disk(pbio_os_state_t *state, const
     }
 
     // Write page by page.
-    for (size_done = 0; size_done < size; size_done += size_now) {
-        size_now = pbio_int_math_min(size - size_done, FLASH_SIZE_WRITE);
+    for (size_done = start; size_done < end; size_done += size_now) {
+        size_now = pbio_int_math_min(end - size_done, FLASH_SIZE_WRITE);
 
         // Enable writing
         err = spi_begin_for_flash(cmd_write_enable, sizeof(cmd_write_enable), 0, 0, 0);
@@ -869,6 +883,12 @@ static struct {
     };
 } ramdisk __attribute__((aligned(PBDRV_CACHE_LINE_SZ), section(".noinit"), used));
 
+/**
+ * Range of the ramdisk to write on shutdown, aligned to whole sectors.
+ */
+static uint32_t write_start;
+static uint32_t write_end;
+
 uint32_t pbdrv_block_device_get_writable_size(void) {
     return PBDRV_CONFIG_BLOCK_DEVICE_EV3_SIZE - sizeof(ramdisk.saved_size);
 }
@@ -883,6 +903,11 @@ pbio_error_t pbdrv_block_device_get_data(pbsys_storage_data_map_t **data) {
     return pbdrv_block_device_load_err;
 }
 
+pbio_error_t pbdrv_block_device_get_mapped_data(const pbsys_storage_data_map_t **data) {
+    // External storage can't be read in place.
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
 static pbio_os_process_t ev3_spi_process;
 
 pbio_error_t ev3_spi_process_thread(pbio_os_state_t *state, void *context) {
@@ -943,13 +968,13 @@ pbio_error_t ev3_spi_process_thread(pbio_os_state_t *state, void *context) {
         // Await for transfer to complete.
         PBIO_OS_AWAIT_WHILE(state, (spi_dev.status & SPI_STATUS_WAIT_ANY));
 
-        PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_is_expired(&timer));
+        PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_await(&timer));
         pbio_os_timer_extend(&timer);
     }
 
     // Now that the ADC loop has ended, we can use the SPI bus to save user
     // data to persistent storage.
-    PBIO_OS_AWAIT(state, &sub, err = pbdrv_block_device_write_disk(&sub, (uint8_t *)&ramdisk, ramdisk.saved_size));
+    PBIO_OS_AWAIT(state, &sub, err = pbdrv_block_device_write_disk(&sub, (uint8_t *)&ramdisk, ramdisk.saved_size, write_start, write_end));
 
     // Poll the process that awaits on us to complete.
     pbio_os_request_poll();
@@ -957,11 +982,27 @@ pbio_error_t ev3_spi_process_thread(pbio_os_state_t *state, void *context) {
     PBIO_OS_ASYNC_END(err);
 }
 
-pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_data_size) {
+pbio_error_t pbdrv_block_device_write_range(pbio_os_state_t *state, uint32_t used_data_size, uint32_t dirty_start, uint32_t dirty_end) {
+    uint32_t size = used_data_size + sizeof(ramdisk.saved_size);
+
     PBIO_OS_ASYNC_BEGIN(state);
 
-    // Store the new size so we know how much to load on next boot.
-    ramdisk.saved_size = used_data_size + sizeof(ramdisk.saved_size);
+    // Changed range on flash, which starts with the size field.
+    write_start = dirty_start + sizeof(ramdisk.saved_size);
+    write_end = pbio_int_math_min(dirty_end + sizeof(ramdisk.saved_size), size);
+
+    // Store the new size so we know how much to load on next boot. It is in
+    // the first sector, so that has to be written too if it changed.
+    if (ramdisk.saved_size != size) {
+        ramdisk.saved_size = size;
+        write_start = 0;
+    }
+
+    // Whole sectors are erased, so write everything in them that is used.
+    if (write_start < write_end) {
+        write_start = write_start / FLASH_SIZE_ERASE * FLASH_SIZE_ERASE;
+        write_end = pbio_int_math_min((write_end + FLASH_SIZE_ERASE - 1) / FLASH_SIZE_ERASE * FLASH_SIZE_ERASE, size);
+    }
 
     // Rather than write here, we ask the common SPI process to start writing
     // when it is ready for it, and wait for the whole process to complete.
@@ -971,6 +1012,10 @@ pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
 
+pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_data_size) {
+    return pbdrv_block_device_write_range(state, used_data_size, 0, used_data_size);
+}
+
 void pbdrv_block_device_init(void) {
     spi_bus_init();
     pbio_busy_count_up();
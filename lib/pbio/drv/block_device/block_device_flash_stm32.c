@@ -20,6 +20,7 @@
 
 #include <pbio/busy_count.h>
 #include <pbio/error.h>
+#include <pbio/int_math.h>
 #include <pbio/util.h>
 
 #include STM32_HAL_H
@@ -70,6 +71,8 @@ void pbdrv_block_device_init(void) {
         // This error will be retrieved when higher level code requests the
         // ramdisk, so that it can reset data to firmware defaults.
         init_err = PBIO_ERROR_INVALID_ARG;
+        // Nothing was loaded, so everything must be written on shutdown.
+        ramdisk.saved_size = 0;
         return;
     }
 
@@ -82,6 +85,18 @@ pbio_error_t pbdrv_block_device_get_data(pbsys_storage_data_map_t **data) {
     return init_err;
 }
 
+pbio_error_t pbdrv_block_device_get_mapped_data(const pbsys_storage_data_map_t **data) {
+    // Nothing valid was loaded, so the data in flash is not usable.
+    if (init_err != PBIO_SUCCESS) {
+        return PBIO_ERROR_NOT_SUPPORTED;
+    }
+
+    // Internal flash is memory mapped. The data map follows the header, just
+    // like in the RAM copy.
+    *data = (const pbsys_storage_data_map_t *)(_pbdrv_block_device_storage_start + header_size);
+    return PBIO_SUCCESS;
+}
+
 // Updates checksum in data map to satisfy bootloader requirements.
 static void pbdrv_block_device_update_ramdisk_size_and_checksum(uint32_t used_data_size) {
 
@@ -116,13 +131,14 @@ static void pbdrv_block_device_update_ramdisk_size_and_checksum(uint32_t used_da
     ramdisk.checksum_complement = 0xFFFFFFFF - checksum + 1;
 }
 
-pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_data_size) {
+pbio_error_t pbdrv_block_device_write_range(pbio_os_state_t *state, uint32_t used_data_size, uint32_t dirty_start, uint32_t dirty_end) {
 
     // NB: This function is called as an awaitable for compatibility with other
     // external storage mediums. This implementation is blocking, but we only
     // use it during shutdown so this is acceptable.
 
     // Account for header size and make valid checksum.
+    uint32_t old_size = ramdisk.saved_size;
     pbdrv_block_device_update_ramdisk_size_and_checksum(used_data_size);
     uint32_t size = ramdisk.saved_size;
 
@@ -133,13 +149,24 @@ pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_
         return PBIO_ERROR_INVALID_ARG;
     }
 
+    // The checksum assumes that everything after the used data is erased, so
+    // erase the whole user storage area if the size changed. Otherwise, erase
+    // from the first page, which has the new checksum, up to the last page
+    // with changed data.
+    uint32_t erase_size = PBDRV_CONFIG_BLOCK_DEVICE_FLASH_STM32_SIZE;
+    if (size == old_size) {
+        uint32_t end = pbio_int_math_min(dirty_end + header_size, size);
+        erase_size = (end + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE * FLASH_PAGE_SIZE;
+    }
+    uint32_t write_size = pbio_int_math_min(erase_size, size);
+
     // Unlock flash for writing.
     HAL_StatusTypeDef hal_err = HAL_FLASH_Unlock();
     if (hal_err != HAL_OK) {
         return PBIO_ERROR_IO;
     }
 
-    // Erase the whole user storage area.
+    // Erase the requested part of the user storage area.
     FLASH_EraseInitTypeDef erase_init = {
         #if defined(STM32F0)
         .PageAddress = base_address,
@@ -149,7 +176,7 @@ pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_
         #else
         #error "Unsupported target."
         #endif
-        .NbPages = PBDRV_CONFIG_BLOCK_DEVICE_FLASH_STM32_SIZE / FLASH_PAGE_SIZE,
+        .NbPages = erase_size / FLASH_PAGE_SIZE,
         .TypeErase = FLASH_TYPEERASE_PAGES
     };
 
@@ -168,7 +195,7 @@ pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_
 
     // Write data chunk by chunk.
     uint32_t done = 0;
-    while (done < size) {
+    while (done < write_size) {
 
         // Disable interrupts while writing as above.
         irq = __get_PRIMASK();
@@ -192,4 +219,10 @@ pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_
     return PBIO_SUCCESS;
 }
 
+pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_data_size) {
+    // Invalidate the size to erase and write everything.
+    ramdisk.saved_size = 0;
+    return pbdrv_block_device_write_range(state, used_data_size, 0, used_data_size);
+}
+
 #endif // PBDRV_CONFIG_BLOCK_DEVICE_FLASH_STM32
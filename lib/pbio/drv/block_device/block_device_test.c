@@ -80,6 +80,11 @@ pbio_error_t pbdrv_block_device_get_data(pbsys_storage_data_map_t **data) {
     return PBIO_SUCCESS;
 }
 
+pbio_error_t pbdrv_block_device_get_mapped_data(const pbsys_storage_data_map_t **data) {
+    // Nothing is stored in this implementation.
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
 void pbdrv_block_device_init(void) {
     ramdisk.data_map.slot_info[0].size = sizeof(_program_data);
     memcpy(ramdisk.data_map.stored_firmware_hash, MICROPY_GIT_HASH, sizeof(ramdisk.data_map.stored_firmware_hash));
@@ -91,4 +96,8 @@ pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_
     return PBIO_ERROR_NOT_IMPLEMENTED;
 }
 
+pbio_error_t pbdrv_block_device_write_range(pbio_os_state_t *state, uint32_t used_data_size, uint32_t dirty_start, uint32_t dirty_end) {
+    return PBIO_ERROR_NOT_IMPLEMENTED;
+}
+
 #endif // PBDRV_CONFIG_BLOCK_DEVICE_TEST
@@ -58,6 +58,11 @@ pbio_error_t pbdrv_block_device_get_data(pbsys_storage_data_map_t **data) {
     return pbdrv_block_device_w25qxx_stm32_init_process.err;
 }
 
+pbio_error_t pbdrv_block_device_get_mapped_data(const pbsys_storage_data_map_t **data) {
+    // External storage can't be read in place.
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
 /**
  * SPI bus state.
  */
@@ -468,12 +473,13 @@ static pbio_error_t flash_erase_or_write(pbio_os_state_t *state, uint32_t addres
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
 
-pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_data_size) {
+pbio_error_t pbdrv_block_device_write_range(pbio_os_state_t *state, uint32_t used_data_size, uint32_t dirty_start, uint32_t dirty_end) {
 
     static pbio_os_state_t sub;
+    static uint32_t start;
+    static uint32_t end;
     static uint32_t offset;
     static uint32_t size_now;
-    static uint32_t size_done;
     pbio_error_t err;
 
     // We're going to write the used portion of the ramdisk to flash. Includes
@@ -488,11 +494,28 @@ pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_
         return PBIO_ERROR_INVALID_ARG;
     }
 
-    // Store the new size so we know how much to load on next boot.
-    ramdisk.saved_size = size;
+    // Changed range on flash, which starts with the size field.
+    start = dirty_start + sizeof(ramdisk.saved_size);
+    end = pbio_int_math_min(dirty_end + sizeof(ramdisk.saved_size), size);
+
+    // Store the new size so we know how much to load on next boot. It is in
+    // the first sector, so that has to be written too if it changed.
+    if (ramdisk.saved_size != size) {
+        ramdisk.saved_size = size;
+        start = 0;
+    }
+
+    // Nothing changed.
+    if (start >= end) {
+        return PBIO_SUCCESS;
+    }
+
+    // Whole sectors are erased, so write everything in them that is used.
+    start = start / FLASH_SIZE_ERASE * FLASH_SIZE_ERASE;
+    end = pbio_int_math_min((end + FLASH_SIZE_ERASE - 1) / FLASH_SIZE_ERASE * FLASH_SIZE_ERASE, size);
 
     // Erase sector by sector.
-    for (offset = 0; offset < size; offset += FLASH_SIZE_ERASE) {
+    for (offset = start; offset < end; offset += FLASH_SIZE_ERASE) {
         // Writing size 0 means erase.
         PBIO_OS_AWAIT(state, &sub, err = flash_erase_or_write(&sub,
             PBDRV_CONFIG_BLOCK_DEVICE_W25QXX_STM32_START_ADDRESS + offset, NULL, 0));
@@ -502,10 +525,10 @@ pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_
     }
 
     // Write page by page.
-    for (size_done = 0; size_done < size; size_done += size_now) {
-        size_now = pbio_int_math_min(size - size_done, FLASH_SIZE_WRITE);
+    for (offset = start; offset < end; offset += size_now) {
+        size_now = pbio_int_math_min(end - offset, FLASH_SIZE_WRITE);
         PBIO_OS_AWAIT(state, &sub, err = flash_erase_or_write(&sub,
-            PBDRV_CONFIG_BLOCK_DEVICE_W25QXX_STM32_START_ADDRESS + size_done, buffer + size_done, size_now));
+            PBDRV_CONFIG_BLOCK_DEVICE_W25QXX_STM32_START_ADDRESS + offset, buffer + offset, size_now));
         if (err != PBIO_SUCCESS) {
             return err;
         }
@@ -514,6 +537,10 @@ pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
 
+pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_data_size) {
+    return pbdrv_block_device_write_range(state, used_data_size, 0, used_data_size);
+}
+
 pbio_error_t pbdrv_block_device_w25qxx_stm32_init_process_thread(pbio_os_state_t *state, void *context) {
 
     pbio_error_t err;
@@ -41,11 +41,37 @@ void pbdrv_bluetooth_set_receive_handler(pbdrv_bluetooth_receive_handler_t handl
 //
 
 /**
- * Each event has a buffer of maximum packet size. They are prioritized by
- * ascending event number, so status gets sent first, then stdout, etc.
+ * Events are queued per event type, so several producers can send events
+ * without waiting for each other. They are prioritized by ascending event
+ * number, so status gets sent first, then stdout, etc.
  */
-static uint32_t pbdrv_bluetooth_noti_size[PBIO_PYBRICKS_EVENT_NUM_EVENTS];
-static uint8_t pbdrv_bluetooth_noti_buf[PBIO_PYBRICKS_EVENT_NUM_EVENTS][PBDRV_BLUETOOTH_MAX_CHAR_SIZE];
+typedef struct {
+    uint8_t buf[PBDRV_BLUETOOTH_NUM_EVENT_SLOTS][PBDRV_BLUETOOTH_MAX_CHAR_SIZE - 1];
+    uint8_t size[PBDRV_BLUETOOTH_NUM_EVENT_SLOTS];
+    uint8_t first;
+    uint8_t count;
+} pbdrv_bluetooth_noti_queue_t;
+
+static pbdrv_bluetooth_noti_queue_t pbdrv_bluetooth_noti_queue[PBIO_PYBRICKS_EVENT_NUM_EVENTS];
+
+/**
+ * Notification that is currently being sent, starting with the event byte.
+ * This is as big as the negotiated MTU allows, so stdout and queued events
+ * can be combined into fewer notifications.
+ */
+static uint8_t pbdrv_bluetooth_noti_buf[PBDRV_BLUETOOTH_MAX_MTU_SIZE - 3];
+static uint32_t pbdrv_bluetooth_noti_size;
+
+/**
+ * Tests if several events of this type may be combined into one notification.
+ * This is only the case for events with a payload that is a stream of bytes
+ * or of self-delimiting samples.
+ */
+static bool pbdrv_bluetooth_event_can_pack(pbio_pybricks_event_t event) {
+    return event == PBIO_PYBRICKS_EVENT_WRITE_STDOUT ||
+           event == PBIO_PYBRICKS_EVENT_WRITE_TELEMETRY ||
+           event == PBIO_PYBRICKS_EVENT_WRITE_LOG;
+}
 
 /**
  * Buffer scheduled status.
@@ -66,15 +92,37 @@ void pbdrv_bluetooth_schedule_status_update(const uint8_t *status_msg) {
 }
 
 /**
- * Buffer for scheduled stdout.
+ * Buffer for scheduled stdout. By default, this holds at least two packets,
+ * one currently being sent and one to be ready as soon as the previous one
+ * completes. The extra byte is for the ring buf pointer.
  */
 static lwrb_t stdout_ring_buf;
+static uint8_t stdout_buf[PBDRV_BLUETOOTH_STDOUT_BUF_SIZE + 1];
+static uint32_t stdout_high_watermark;
+
+/**
+ * Whether the stdout buffer size should go back to the default as soon as
+ * the buffer is empty.
+ */
+static bool stdout_buf_restore_pending;
+
+static void pbdrv_bluetooth_tx_init_buffer(uint32_t size) {
+    lwrb_init(&stdout_ring_buf, stdout_buf, size + 1);
+    stdout_high_watermark = 0;
+    stdout_buf_restore_pending = false;
+}
+
+/**
+ * Restores the default stdout buffer size if requested and nothing is queued.
+ */
+static void pbdrv_bluetooth_tx_restore_buffer_size(void) {
+    if (stdout_buf_restore_pending && lwrb_get_full(&stdout_ring_buf) == 0) {
+        pbdrv_bluetooth_tx_init_buffer(PBDRV_BLUETOOTH_STDOUT_BUF_SIZE);
+    }
+}
 
 void pbdrv_bluetooth_init(void) {
-    // enough for two packets, one currently being sent and one to be ready
-    // as soon as the previous one completes + 1 byte for ring buf pointer
-    static uint8_t stdout_buf[PBDRV_BLUETOOTH_MAX_CHAR_SIZE * 2 + 1];
-    lwrb_init(&stdout_ring_buf, stdout_buf, PBIO_ARRAY_SIZE(stdout_buf));
+    pbdrv_bluetooth_tx_init_buffer(PBDRV_BLUETOOTH_STDOUT_BUF_SIZE);
 
     pbdrv_bluetooth_init_hci();
 }
@@ -92,6 +140,11 @@ pbio_error_t pbdrv_bluetooth_tx(const uint8_t *data, uint32_t *size) {
         return PBIO_ERROR_AGAIN;
     }
 
+    uint32_t queued = lwrb_get_full(&stdout_ring_buf);
+    if (queued > stdout_high_watermark) {
+        stdout_high_watermark = queued;
+    }
+
     // poke the process to start tx soon-ish. This way, we can accumulate up to
     // PBDRV_BLUETOOTH_MAX_CHAR_SIZE bytes before actually transmitting
     pbio_os_request_poll();
@@ -107,12 +160,38 @@ uint32_t pbdrv_bluetooth_tx_available(void) {
     return lwrb_get_free(&stdout_ring_buf);
 }
 
+pbio_error_t pbdrv_bluetooth_tx_set_buffer_size(uint32_t size) {
+    if (size < PBDRV_BLUETOOTH_MAX_CHAR_SIZE || size > PBDRV_BLUETOOTH_STDOUT_BUF_SIZE) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    // Can only resize when nothing is queued.
+    if (lwrb_get_full(&stdout_ring_buf) != 0) {
+        return PBIO_ERROR_BUSY;
+    }
+
+    pbdrv_bluetooth_tx_init_buffer(size);
+    return PBIO_SUCCESS;
+}
+
+uint32_t pbdrv_bluetooth_tx_get_buffer_size(void) {
+    return stdout_ring_buf.size - 1;
+}
+
+uint32_t pbdrv_bluetooth_tx_get_high_watermark(void) {
+    return stdout_high_watermark;
+}
+
 bool pbdrv_bluetooth_tx_is_idle(void) {
     if (!pbdrv_bluetooth_is_connected(PBDRV_BLUETOOTH_CONNECTION_PYBRICKS)) {
         return true;
     }
 
-    return lwrb_get_full(&stdout_ring_buf) == 0 && !pbdrv_bluetooth_noti_size[PBIO_PYBRICKS_EVENT_WRITE_STDOUT];
+    if (lwrb_get_full(&stdout_ring_buf) != 0 || pbdrv_bluetooth_noti_queue[PBIO_PYBRICKS_EVENT_WRITE_STDOUT].count) {
+        return false;
+    }
+
+    return !pbdrv_bluetooth_noti_size || pbdrv_bluetooth_noti_buf[0] != PBIO_PYBRICKS_EVENT_WRITE_STDOUT;
 }
 
 pbio_error_t pbdrv_bluetooth_send_event_notification(pbio_os_state_t *state, pbio_pybricks_event_t event_type, const uint8_t *data, size_t size) {
@@ -122,24 +201,35 @@ pbio_error_t pbdrv_bluetooth_send_event_notification(pbio_os_state_t *state, pbi
         return PBIO_ERROR_INVALID_OP;
     }
 
-    if (size + 1 > PBIO_ARRAY_SIZE(pbdrv_bluetooth_noti_buf[0]) || event_type >= PBIO_PYBRICKS_EVENT_NUM_EVENTS) {
+    if (size + 1 > PBDRV_BLUETOOTH_MAX_CHAR_SIZE || event_type >= PBIO_PYBRICKS_EVENT_NUM_EVENTS) {
         return PBIO_ERROR_INVALID_ARG;
     }
 
-    // Existing notification waiting to be sent first.
-    if (pbdrv_bluetooth_noti_size[event_type]) {
-        return PBIO_ERROR_BUSY;
+    // Await until a slot for this event is free. If all slots are in use,
+    // this waits for the main process to send one of them.
+    PBIO_OS_AWAIT_UNTIL(state, pbdrv_bluetooth_noti_queue[event_type].count < PBDRV_BLUETOOTH_NUM_EVENT_SLOTS ||
+        !pbdrv_bluetooth_is_connected(PBDRV_BLUETOOTH_CONNECTION_PYBRICKS));
+
+    // Disconnected while waiting, so there is nobody to send it to.
+    if (!pbdrv_bluetooth_is_connected(PBDRV_BLUETOOTH_CONNECTION_PYBRICKS)) {
+        return PBIO_ERROR_INVALID_OP;
     }
 
-    // Copy to local buffer and set size so main thread knows to handle it.
-    pbdrv_bluetooth_noti_size[event_type] = size + 1;
-    pbdrv_bluetooth_noti_buf[event_type][0] = event_type;
-    memcpy(&pbdrv_bluetooth_noti_buf[event_type][1], data, size);
+    // Copy to next free slot so main thread knows to handle it.
+    pbdrv_bluetooth_noti_queue_t *queue = &pbdrv_bluetooth_noti_queue[event_type];
+    uint8_t slot = (queue->first + queue->count) % PBDRV_BLUETOOTH_NUM_EVENT_SLOTS;
+    memcpy(queue->buf[slot], data, size);
+    queue->size[slot] = size;
+    queue->count++;
     pbio_os_request_poll();
 
-    // Await until main process has finished sending user data. If it
-    // disconnected while sending, this completes as well.
-    PBIO_OS_AWAIT_WHILE(state, pbdrv_bluetooth_noti_size[event_type]);
+    // The data was copied, so the caller does not have to wait for it to be
+    // sent. Yield once to give the main process a chance to send it, and
+    // await until there is room for the next event of this type, so a caller
+    // that sends events back to back can always copy its data right away. If
+    // it disconnects while waiting, the queue is emptied, so this completes.
+    PBIO_OS_AWAIT_ONCE(state);
+    PBIO_OS_AWAIT_UNTIL(state, pbdrv_bluetooth_noti_queue[event_type].count < PBDRV_BLUETOOTH_NUM_EVENT_SLOTS);
 
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
@@ -451,52 +541,84 @@ pbio_error_t pbdrv_bluetooth_await_advertise_or_scan_command(pbio_os_state_t *st
 }
 
 /**
- * Updates send buffers by draining relevant data buffers and find which event
- * has the highest priority to send.
+ * Drains queued event slots into the send buffer, combining them if allowed.
+ *
+ * @param [in] event    Event type with at least one queued slot.
+ * @param [in] max      Maximum notification size.
+ */
+static void pbdrv_bluetooth_noti_drain_queue(pbio_pybricks_event_t event, uint32_t max) {
+    pbdrv_bluetooth_noti_queue_t *queue = &pbdrv_bluetooth_noti_queue[event];
+
+    // Message always starts with event byte.
+    pbdrv_bluetooth_noti_buf[0] = event;
+    pbdrv_bluetooth_noti_size = 1;
+
+    do {
+        memcpy(&pbdrv_bluetooth_noti_buf[pbdrv_bluetooth_noti_size], queue->buf[queue->first], queue->size[queue->first]);
+        pbdrv_bluetooth_noti_size += queue->size[queue->first];
+        queue->first = (queue->first + 1) % PBDRV_BLUETOOTH_NUM_EVENT_SLOTS;
+        queue->count--;
+    } while (queue->count && pbdrv_bluetooth_event_can_pack(event) &&
+             pbdrv_bluetooth_noti_size + queue->size[queue->first] <= max);
+
+    // Slots were freed, so producers waiting for one can continue.
+    pbio_os_request_poll();
+}
+
+/**
+ * Prepares the next notification by draining relevant data buffers for the
+ * event that has the highest priority to send.
+ *
+ * @return  True if the send buffer is ready to be sent, false if there is
+ *          nothing to send.
  */
-static bool update_and_get_event_buffer(uint8_t **buf, uint32_t **len) {
+static bool pbdrv_bluetooth_noti_prepare(void) {
 
     static pbio_os_timer_t status_timer;
 
     // Prepare status.
     if (status_data_pending || pbio_os_timer_is_expired(&status_timer)) {
-        // When a status is pending, drain it here while we write it out,
-        // so a new status can be set in the mean time without losing it.
-        memcpy(pbdrv_bluetooth_noti_buf[PBIO_PYBRICKS_EVENT_STATUS_REPORT], status_data, PBIO_PYBRICKS_EVENT_STATUS_REPORT_SIZE);
-        pbdrv_bluetooth_noti_size[PBIO_PYBRICKS_EVENT_STATUS_REPORT] = PBIO_PYBRICKS_EVENT_STATUS_REPORT_SIZE;
+        // Drain it here while we write it out, so a new status can be set in
+        // the mean time without losing it.
+        memcpy(pbdrv_bluetooth_noti_buf, status_data, PBIO_PYBRICKS_EVENT_STATUS_REPORT_SIZE);
+        pbdrv_bluetooth_noti_size = PBIO_PYBRICKS_EVENT_STATUS_REPORT_SIZE;
         status_data_pending = false;
         pbio_os_timer_set(&status_timer, PBDRV_BLUETOOTH_STATUS_UPDATE_INTERVAL);
+        return true;
     }
 
-    // Prepare stdout, drain into chunk of maximum send size.
-    if (lwrb_get_full(&stdout_ring_buf) != 0) {
-        // Message always starts with event byte.
-        if (!pbdrv_bluetooth_noti_size[PBIO_PYBRICKS_EVENT_WRITE_STDOUT]) {
-            pbdrv_bluetooth_noti_buf[PBIO_PYBRICKS_EVENT_WRITE_STDOUT][0] = PBIO_PYBRICKS_EVENT_WRITE_STDOUT;
-            pbdrv_bluetooth_noti_size[PBIO_PYBRICKS_EVENT_WRITE_STDOUT] = 1;
-        }
-        // Drain ring buffer to send buffer as much as we can.
-        uint32_t stdout_free = sizeof(pbdrv_bluetooth_noti_buf[PBIO_PYBRICKS_EVENT_WRITE_STDOUT]) - pbdrv_bluetooth_noti_size[PBIO_PYBRICKS_EVENT_WRITE_STDOUT];
-        if (stdout_free) {
-            uint8_t *dest = &pbdrv_bluetooth_noti_buf[PBIO_PYBRICKS_EVENT_WRITE_STDOUT][sizeof(pbdrv_bluetooth_noti_buf[PBIO_PYBRICKS_EVENT_WRITE_STDOUT]) - stdout_free];
-            pbdrv_bluetooth_noti_size[PBIO_PYBRICKS_EVENT_WRITE_STDOUT] += lwrb_read(&stdout_ring_buf, dest, stdout_free);
-        }
-    }
+    // Notifications can be as big as the connection allows.
+    uint32_t max = pbio_int_math_bind(pbdrv_bluetooth_get_pybricks_mtu() - 3,
+        PBDRV_BLUETOOTH_MAX_CHAR_SIZE, sizeof(pbdrv_bluetooth_noti_buf));
 
-    // Other events are awaited as-is and don't allow setting new data until
-    // they have been transmitted, so don't need further processing/draining.
+    // Return highest priority pending event, ready for sending.
+    for (pbio_pybricks_event_t event = 0; event < PBIO_PYBRICKS_EVENT_NUM_EVENTS; event++) {
+        if (pbdrv_bluetooth_noti_queue[event].count) {
+            pbdrv_bluetooth_noti_drain_queue(event, max);
+            return true;
+        }
 
-    // Return highest priority pending event, ready for sending.s
-    for (uint32_t i = 0; i < PBIO_PYBRICKS_EVENT_NUM_EVENTS; i++) {
-        if (pbdrv_bluetooth_noti_size[i]) {
-            *len = &pbdrv_bluetooth_noti_size[i];
-            *buf = pbdrv_bluetooth_noti_buf[i];
+        // Drain stdout into chunk of maximum send size, so bursts of stdout
+        // need fewer notifications.
+        if (event == PBIO_PYBRICKS_EVENT_WRITE_STDOUT && lwrb_get_full(&stdout_ring_buf) != 0) {
+            pbdrv_bluetooth_noti_buf[0] = PBIO_PYBRICKS_EVENT_WRITE_STDOUT;
+            pbdrv_bluetooth_noti_size = 1 + lwrb_read(&stdout_ring_buf, &pbdrv_bluetooth_noti_buf[1], max - 1);
+            pbdrv_bluetooth_tx_restore_buffer_size();
             return true;
         }
     }
     return false;
 }
 
+/**
+ * Discards queued events, so they are not sent to the next host.
+ */
+static void pbdrv_bluetooth_noti_reset(void) {
+    for (pbio_pybricks_event_t event = 0; event < PBIO_PYBRICKS_EVENT_NUM_EVENTS; event++) {
+        pbdrv_bluetooth_noti_queue[event].count = 0;
+    }
+}
+
 #if PBDRV_CONFIG_BLUETOOTH_NUM_CLASSIC_CONNECTIONS
 static pbdrv_bluetooth_classic_task_context_t pbdrv_bluetooth_classic_task_context;
 
@@ -603,11 +725,11 @@ init:
         PBIO_OS_AWAIT_MS(state, &timer, 1);
 
         // Send one event notification (status, stdout, ...)
-        static uint32_t *noti_size;
-        static uint8_t *noti_buf;
-        if (can_send && update_and_get_event_buffer(&noti_buf, &noti_size)) {
-            PBIO_OS_AWAIT(state, &sub, pbdrv_bluetooth_send_pybricks_value_notification(&sub, noti_buf, *noti_size));
-            *noti_size = 0;
+        if (!can_send) {
+            pbdrv_bluetooth_noti_reset();
+        } else if (pbdrv_bluetooth_noti_prepare()) {
+            PBIO_OS_AWAIT(state, &sub, pbdrv_bluetooth_send_pybricks_value_notification(&sub, pbdrv_bluetooth_noti_buf, pbdrv_bluetooth_noti_size));
+            pbdrv_bluetooth_noti_size = 0;
         }
 
         // Handle pending advertising/scan enable/disable task, if any.
@@ -681,6 +803,11 @@ pbio_error_t pbdrv_bluetooth_close_user_tasks(pbio_os_state_t *state, pbio_os_ti
 
     PBIO_OS_ASYNC_BEGIN(state);
 
+    // The next program starts with the default stdout buffer size. If output
+    // of this program is still being sent, this is done once it is sent.
+    stdout_buf_restore_pending = true;
+    pbdrv_bluetooth_tx_restore_buffer_size();
+
     // Requests peripheral operations to cancel, if they support it.
     pbdrv_bluetooth_cancel_operation_request();
 
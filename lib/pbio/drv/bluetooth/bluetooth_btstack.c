@@ -562,6 +562,15 @@ pbio_error_t pbdrv_bluetooth_stop_advertising_func(pbio_os_state_t *state, void
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
 
+uint16_t pbdrv_bluetooth_get_pybricks_mtu(void) {
+    #if PBDRV_CONFIG_BLUETOOTH_BTSTACK_LE_SERVER
+    if (pybricks_con_handle != HCI_CON_HANDLE_INVALID) {
+        return att_server_get_mtu(pybricks_con_handle);
+    }
+    #endif
+    return ATT_DEFAULT_MTU;
+}
+
 typedef struct {
     const uint8_t *data;
     uint16_t size;
@@ -629,7 +638,7 @@ pbio_error_t pbdrv_bluetooth_peripheral_scan_and_connect_func(pbio_os_state_t *s
 start_scan:
 
     // Wait for advertisement that matches the filter unless timed out or cancelled.
-    PBIO_OS_AWAIT_UNTIL(state, (peri->config->timeout && pbio_os_timer_is_expired(&peri->timer)) ||
+    PBIO_OS_AWAIT_UNTIL(state, (peri->config->timeout && pbio_os_timer_await(&peri->timer)) ||
         peri->cancel || (hci_event_is_type(event_packet, GAP_EVENT_ADVERTISING_REPORT) && ({
 
         uint8_t event_type = gap_event_advertising_report_get_advertising_event_type(event_packet);
@@ -665,7 +674,7 @@ start_scan:
     pbio_os_timer_set(&peri->timer, PERIPHERAL_TIMEOUT_MS_SCAN_RESPONSE);
 
     // Wait for advertising response that matches the filter unless timed out or cancelled.
-    PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_is_expired(&peri->timer) || peri->cancel ||
+    PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_await(&peri->timer) || peri->cancel ||
         (hci_event_is_type(event_packet, GAP_EVENT_ADVERTISING_REPORT) && ({
 
         uint8_t event_type = gap_event_advertising_report_get_advertising_event_type(event_packet);
@@ -708,7 +717,7 @@ start_scan:
     if (btstack_error != ERROR_CODE_SUCCESS) {
         return att_error_to_pbio_error(btstack_error);
     }
-    PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_is_expired(&peri->timer) || peri->cancel ||
+    PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_await(&peri->timer) || peri->cancel ||
         hci_event_le_peripheral_did_connect(event_packet));
 
     // If we timed out or were cancelled, abort the connection. We have to check
@@ -746,7 +755,7 @@ start_pairing:
     sm_request_pairing(peri->con_handle);
 
     // Wait for pairing to complete unless timed out, cancelled, or disconnected.
-    PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_is_expired(&peri->timer) || peri->cancel ||
+    PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_await(&peri->timer) || peri->cancel ||
         !pbdrv_bluetooth_peripheral_is_connected(peri) ||
         hci_event_le_peripheral_pairing_did_complete(event_packet, peri->con_handle));
 
@@ -1275,13 +1284,20 @@ static pbio_error_t pbdrv_bluetooth_hci_process_thread(pbio_os_state_t *state, v
 
     pbdrv_bluetooth_btstack_platform_poll();
 
-    static pbio_os_timer_t btstack_timer = {
-        .duration = 1,
-    };
-
-    if (pbio_os_timer_is_expired(&btstack_timer)) {
-        pbio_os_timer_extend(&btstack_timer);
-        btstack_run_loop_base_process_timers(pbdrv_clock_get_ms());
+    // Handle btstack timers that are due.
+    uint32_t now = pbdrv_clock_get_ms();
+    btstack_run_loop_base_process_timers(now);
+
+    // Make sure we get polled again when the next btstack timer is due, even
+    // if the system is otherwise idle.
+    int32_t timeout = btstack_run_loop_base_get_time_until_timeout(now);
+    if (timeout >= 0) {
+        static pbio_os_timer_t btstack_timer;
+        btstack_timer.start = now;
+        btstack_timer.duration = timeout;
+        if (pbio_os_timer_await(&btstack_timer)) {
+            pbio_os_request_poll();
+        }
     }
 
     // Also propagate non-btstack events like polls or timers.
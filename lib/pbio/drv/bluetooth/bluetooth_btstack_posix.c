@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/select.h>
 
 #include "btstack.h"
 #include "ble/le_device_db_tlv.h"
@@ -252,6 +253,39 @@ void pbdrv_bluetooth_btstack_platform_poll(void) {
     }
 }
 
+/**
+ * Adds the file descriptors of btstack data sources to the given sets, so the
+ * caller can sleep until one of them is ready.
+ *
+ * @param [in, out] read_fds    Descriptors to watch for reading.
+ * @param [in, out] write_fds   Descriptors to watch for writing.
+ * @return                      The highest descriptor plus one, or 0 if none.
+ */
+int pbdrv_bluetooth_btstack_posix_get_fds(fd_set *read_fds, fd_set *write_fds) {
+
+    int nfds = 0;
+
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, &btstack_run_loop_base_data_sources);
+    while (btstack_linked_list_iterator_has_next(&it)) {
+        btstack_data_source_t *ds = (void *)btstack_linked_list_iterator_next(&it);
+        int fd = ds->source.fd;
+        if (fd < 0 || fd >= FD_SETSIZE) {
+            continue;
+        }
+        if (ds->flags & DATA_SOURCE_CALLBACK_READ) {
+            FD_SET(fd, read_fds);
+        }
+        if (ds->flags & DATA_SOURCE_CALLBACK_WRITE) {
+            FD_SET(fd, write_fds);
+        }
+        if ((ds->flags & (DATA_SOURCE_CALLBACK_READ | DATA_SOURCE_CALLBACK_WRITE)) && fd >= nfds) {
+            nfds = fd + 1;
+        }
+    }
+    return nfds;
+}
+
 void pbdrv_bluetooth_btstack_platform_packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size) {
 
     switch (hci_event_packet_get_type(packet)) {
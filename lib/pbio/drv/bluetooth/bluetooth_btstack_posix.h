@@ -1,6 +1,8 @@
 #ifndef PBDRV_BLUETOOTH_BLUETOOTH_BTSTACK_POSIX_H
 #define PBDRV_BLUETOOTH_BLUETOOTH_BTSTACK_POSIX_H
 
+#include <sys/select.h>
+
 #include <btstack.h>
 
 const btstack_control_t *pbdrv_bluetooth_btstack_posix_control_instance(void);
@@ -9,4 +11,6 @@ const hci_transport_t *pbdrv_bluetooth_btstack_posix_transport_instance(void);
 
 const void *pbdrv_bluetooth_btstack_posix_transport_config(void);
 
+int pbdrv_bluetooth_btstack_posix_get_fds(fd_set *read_fds, fd_set *write_fds);
+
 #endif
@@ -364,6 +364,10 @@ bool pbdrv_bluetooth_is_connected(pbdrv_bluetooth_connection_t connection) {
     return false;
 }
 
+uint16_t pbdrv_bluetooth_get_pybricks_mtu(void) {
+    return conn_mtu;
+}
+
 pbio_error_t pbdrv_bluetooth_send_pybricks_value_notification(pbio_os_state_t *state, const uint8_t *data, uint16_t size) {
 
     static attHandleValueNoti_t notification;
@@ -1898,7 +1902,7 @@ pbio_error_t pbdrv_bluetooth_controller_initialize(pbio_os_state_t *state, pbio_
     // should be false, if not wait a while and try resetting the chip.
     if (spi_srdy) {
         pbio_os_timer_set(timer, 500);
-        PBIO_OS_AWAIT_UNTIL(state, !spi_srdy || pbio_os_timer_is_expired(timer));
+        PBIO_OS_AWAIT_UNTIL(state, !spi_srdy || pbio_os_timer_await(timer));
         if (spi_srdy) {
             // This will make main Bluetooth thread reset and retry.
             return PBIO_ERROR_IO;
@@ -50,7 +50,7 @@ pbio_error_t pbdrv_button_process_thread(pbio_os_state_t *state, void *context)
     pbio_os_timer_set(&timer, 10);
 
     for (;;) {
-        PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_is_expired(&timer));
+        PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_await(&timer));
 
         next = pbdrv_button_gpio_read();
 
@@ -5,12 +5,15 @@
 
 #if PBDRV_CONFIG_CLOCK_LINUX
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <time.h>
 #include <unistd.h>
 
 #include <pbio/os.h>
 
+static void pbdrv_clock_linux_virtual_init(void);
+
 // The SIGNAL option adds a timer that acts as the 1ms tick on embedded systems.
 
 #if PBDRV_CONFIG_CLOCK_LINUX_SIGNAL
@@ -43,6 +46,8 @@ void pbdrv_clock_init(void) {
     static timer_t clock_timer;
     int err;
 
+    pbdrv_clock_linux_virtual_init();
+
     main_thread = pthread_self();
 
     // set up 1ms tick using signal
@@ -87,26 +92,146 @@ void pbdrv_clock_init(void) {
 #else // PBDRV_CONFIG_CLOCK_LINUX_SIGNAL
 
 void pbdrv_clock_init(void) {
+    pbdrv_clock_linux_virtual_init();
 }
 
 #endif // PBDRV_CONFIG_CLOCK_LINUX_SIGNAL
 
-uint32_t pbdrv_clock_get_ms(void) {
+/**
+ * Gets the wall clock time in microseconds.
+ */
+static uint64_t pbdrv_clock_linux_get_wall_us(void) {
     struct timespec time_val;
     clock_gettime(CLOCK_MONOTONIC_RAW, &time_val);
-    return time_val.tv_sec * 1000 + time_val.tv_nsec / 1000000;
+    return (uint64_t)time_val.tv_sec * 1000000 + time_val.tv_nsec / 1000;
+}
+
+// The VIRTUAL option replaces the wall clock with a clock that only advances
+// when the system is idle, so simulations run as fast as possible and give
+// the same results on every run.
+
+#if PBDRV_CONFIG_CLOCK_LINUX_VIRTUAL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "clock_linux.h"
+
+// Largest step of the virtual clock while idle. This bounds how late a
+// process sees a timer expire if it polls the timer instead of awaiting it.
+#define VIRTUAL_MAX_STEP_US (10000)
+
+static bool virtual_enabled;
+
+// Ratio of virtual time to wall time, or 0 to run as fast as possible.
+static double virtual_speed;
+
+static uint64_t virtual_us;
+
+// Wall time at which the virtual clock was started.
+static uint64_t virtual_wall_start_us;
+
+/**
+ * Enables the virtual clock if requested by the PBIO_VIRTUAL_HUB_SPEED
+ * environment variable. This may be "max" to run as fast as possible or a
+ * positive speed multiplier such as "10" or "0.5".
+ */
+static void pbdrv_clock_linux_virtual_init(void) {
+    const char *speed = getenv("PBIO_VIRTUAL_HUB_SPEED");
+    if (!speed) {
+        return;
+    }
+
+    virtual_enabled = true;
+    virtual_wall_start_us = pbdrv_clock_linux_get_wall_us();
+
+    if (strcmp(speed, "max") == 0) {
+        virtual_speed = 0.0;
+        return;
+    }
+
+    virtual_speed = strtod(speed, NULL);
+    if (!(virtual_speed > 0.0)) {
+        fprintf(stderr, "Invalid PBIO_VIRTUAL_HUB_SPEED, using max.\n");
+        virtual_speed = 0.0;
+    }
+}
+
+bool pbdrv_clock_linux_virtual_is_enabled(void) {
+    return virtual_enabled;
+}
+
+/**
+ * Advances the virtual clock while the system is idle.
+ *
+ * @param [in]  step_us     Time until the next deadline.
+ * @return                  How long to wait on the wall clock to keep up
+ *                          with the requested speed, in microseconds.
+ */
+uint32_t pbdrv_clock_linux_virtual_advance(uint32_t step_us) {
+    if (step_us > VIRTUAL_MAX_STEP_US) {
+        step_us = VIRTUAL_MAX_STEP_US;
+    }
+    virtual_us += step_us;
+
+    if (virtual_speed == 0.0) {
+        return 0;
+    }
+
+    // Pace against the start time so that time spent running code (and
+    // rounding) doesn't accumulate.
+    uint64_t target_us = virtual_wall_start_us + (uint64_t)((double)virtual_us / virtual_speed);
+    uint64_t now_us = pbdrv_clock_linux_get_wall_us();
+    if (now_us >= target_us) {
+        return 0;
+    }
+    return (uint32_t)(target_us - now_us);
+}
+
+/**
+ * Simulates incrementing the clock after a certain number of CPU cycles.
+ *
+ * This is called from the MicroPython VM so that user loops without any waits
+ * still see time pass. Since this counts instructions instead of measuring
+ * them, it is the same on every run.
+ */
+void pbdrv_clock_linux_virtual_advance_eventually(void) {
+
+    static uint32_t count = 0;
+
+    if (!virtual_enabled || ++count % 16) {
+        return;
+    }
+
+    virtual_us += 1000;
+}
+
+static uint64_t pbdrv_clock_linux_get_time_us(void) {
+    return virtual_enabled ? virtual_us : pbdrv_clock_linux_get_wall_us();
+}
+
+#else // PBDRV_CONFIG_CLOCK_LINUX_VIRTUAL
+
+static void pbdrv_clock_linux_virtual_init(void) {
+}
+
+static uint64_t pbdrv_clock_linux_get_time_us(void) {
+    return pbdrv_clock_linux_get_wall_us();
+}
+
+#endif // PBDRV_CONFIG_CLOCK_LINUX_VIRTUAL
+
+uint32_t pbdrv_clock_get_ms(void) {
+    return pbdrv_clock_linux_get_time_us() / 1000;
 }
 
 uint32_t pbdrv_clock_get_100us(void) {
-    struct timespec time_val;
-    clock_gettime(CLOCK_MONOTONIC_RAW, &time_val);
-    return time_val.tv_sec * 10000 + time_val.tv_nsec / 100000;
+    return pbdrv_clock_linux_get_time_us() / 100;
 }
 
 uint32_t pbdrv_clock_get_us(void) {
-    struct timespec time_val;
-    clock_gettime(CLOCK_MONOTONIC_RAW, &time_val);
-    return time_val.tv_sec * 1000000 + time_val.tv_nsec / 1000;
+    return pbdrv_clock_linux_get_time_us();
 }
 
 #endif // PBDRV_CONFIG_CLOCK_LINUX
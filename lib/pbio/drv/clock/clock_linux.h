@@ -0,0 +1,20 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+#ifndef _INTERNAL_PBDRV_CLOCK_LINUX_H_
+#define _INTERNAL_PBDRV_CLOCK_LINUX_H_
+
+#include <pbdrv/config.h>
+
+#if PBDRV_CONFIG_CLOCK_LINUX_VIRTUAL
+
+#include <stdbool.h>
+#include <stdint.h>
+
+bool pbdrv_clock_linux_virtual_is_enabled(void);
+uint32_t pbdrv_clock_linux_virtual_advance(uint32_t step_us);
+void pbdrv_clock_linux_virtual_advance_eventually(void);
+
+#endif // PBDRV_CONFIG_CLOCK_LINUX_VIRTUAL
+
+#endif // _INTERNAL_PBDRV_CLOCK_LINUX_H_
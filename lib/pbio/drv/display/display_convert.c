@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include <pbdrv/config.h>
+
+#if PBDRV_CONFIG_DISPLAY_EV3 || PBDRV_CONFIG_DISPLAY_NXT || PBIO_TEST_BUILD
+
+#include <stdint.h>
+#include <string.h>
+
+#include "display_convert.h"
+
+/**
+ * Encode a triplet of pixels into a single byte in the format of the ST7586S.
+ *
+ * Three pixels are encoded in one byte as  (MSB) | A B C | A B C | A B | (LSB)
+ *
+ * A  B (C)
+ * --------------------
+ * 0  0  0  Empty
+ * 0  1  0  Light Grey
+ * 1  0  0  Dark Grey
+ * 1  1  1  Black
+ *
+ * Column C is essentially redundant, but required for the first and second
+ * pixel in each triplet.
+ *
+ * @param p0 First pixel.
+ * @param p1 Second pixel.
+ * @param p2 Third pixel.
+ *
+ * @return Encoded triplet.
+ */
+uint8_t pbdrv_display_st7586s_encode_triplet(uint8_t p0, uint8_t p1, uint8_t p2) {
+    // As described above, the first two pixels are the normal binary
+    // representation shifted left by one, with an extra bit set for black.
+    // The third pixel is not shifted, so contains just two bits.
+    p0 = p0 >= PBDRV_DISPLAY_ST7586S_VALUE_MAX ? 0b111 : (p0 << 1);
+    p1 = p1 >= PBDRV_DISPLAY_ST7586S_VALUE_MAX ? 0b111 : (p1 << 1);
+    p2 = p2 >= PBDRV_DISPLAY_ST7586S_VALUE_MAX ? 0b11 : p2;
+
+    // Three pixels are then concatenated to one byte.
+    return p0 << 5 | p1 << 2 | p2;
+}
+
+/**
+ * Build the lookup tables used to encode triplets.
+ *
+ * Each table gives the bits of one pixel of a triplet, for every possible
+ * pixel value. A triplet is encoded by combining one entry of each table,
+ * which is equivalent to ::pbdrv_display_st7586s_encode_triplet without
+ * branches.
+ *
+ * @param [out] lut     The tables for the first, second, and third pixel.
+ */
+void pbdrv_display_st7586s_init_encode_lut(uint8_t lut[3][256]) {
+    for (uint32_t value = 0; value < 256; value++) {
+        lut[0][value] = pbdrv_display_st7586s_encode_triplet(value, 0, 0);
+        lut[1][value] = pbdrv_display_st7586s_encode_triplet(0, value, 0);
+        lut[2][value] = pbdrv_display_st7586s_encode_triplet(0, 0, value);
+    }
+}
+
+/**
+ * Convert a page of 8 rows to the format of the UC1601.
+ *
+ * Every byte describes a column of 8 pixels, where the least significant bit
+ * is used for the top pixel and the most significant bit is used for the
+ * bottom pixel. Any nonzero pixel is black.
+ *
+ * @param [out] dst         Buffer of @p num_cols bytes for the page.
+ * @param [in]  src         First of 8 rows of @p num_cols pixels. Must be word
+ *                          aligned.
+ * @param [in]  num_cols    Number of columns. Must be a multiple of 4.
+ */
+void pbdrv_display_uc1601_convert_page(uint8_t *dst, const uint8_t *src, uint32_t num_cols) {
+    memset(dst, 0, num_cols);
+    // Rows are scanned in memory order, setting one bit of every column byte
+    // per row.
+    for (uint32_t y = 0; y < 8; y++) {
+        const uint8_t *row = &src[y * num_cols];
+        const uint32_t *words = (const uint32_t *)row;
+        uint8_t bit = 1 << y;
+        for (uint32_t x = 0; x < num_cols; x += 4) {
+            // Skip four empty pixels at once, which is the common case.
+            if (!words[x / 4]) {
+                continue;
+            }
+            for (uint32_t i = x; i < x + 4; i++) {
+                if (row[i]) {
+                    dst[i] |= bit;
+                }
+            }
+        }
+    }
+}
+
+#endif // PBDRV_CONFIG_DISPLAY_EV3 || PBDRV_CONFIG_DISPLAY_NXT || PBIO_TEST_BUILD
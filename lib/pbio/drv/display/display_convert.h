@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+// Conversion of the user frame buffer to the native format of the displays.
+// These are independent of the hardware so that they can be tested.
+
+#ifndef _INTERNAL_PBDRV_DISPLAY_CONVERT_H_
+#define _INTERNAL_PBDRV_DISPLAY_CONVERT_H_
+
+#include <stdint.h>
+
+/**
+ * Maximum pixel value of the ST7586S display. Higher values are black too.
+ */
+#define PBDRV_DISPLAY_ST7586S_VALUE_MAX (3)
+
+uint8_t pbdrv_display_st7586s_encode_triplet(uint8_t p0, uint8_t p1, uint8_t p2);
+
+void pbdrv_display_st7586s_init_encode_lut(uint8_t lut[3][256]);
+
+void pbdrv_display_uc1601_convert_page(uint8_t *dst, const uint8_t *src, uint32_t num_cols);
+
+#endif // _INTERNAL_PBDRV_DISPLAY_CONVERT_H_
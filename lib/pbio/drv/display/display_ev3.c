@@ -33,6 +33,7 @@
 #include <tiam1808/armv5/am1808/interrupt.h>
 
 #include "../drv/gpio/gpio_ev3.h"
+#include "display_convert.h"
 #include <tiam1808/hw/hw_syscfg0_AM1808.h>
 
 /* ST7586 Commands */
@@ -126,7 +127,7 @@ static volatile spi_status_t spi_status = SPI_STATUS_ERROR;
 /**
  * Maximum pixel value.
  */
-#define ST7586S_VALUE_MAX 3
+#define ST7586S_VALUE_MAX PBDRV_DISPLAY_ST7586S_VALUE_MAX
 
 /**
  * User frame buffer. Each value is one pixel with value:
@@ -146,6 +147,12 @@ static uint8_t pbdrv_display_user_frame[PBDRV_CONFIG_DISPLAY_NUM_ROWS][ST7586S_N
  */
 static bool pbdrv_display_user_frame_update_requested;
 
+/**
+ * Region of the user frame modified by drawing functions since it was last
+ * sent to the display driver.
+ */
+static pbio_image_dirty_t pbdrv_display_user_frame_dirty;
+
 /**
  * Display buffer in the format ready for sending to the st7586s display driver.
  *
@@ -167,44 +174,40 @@ static bool pbdrv_display_user_frame_update_requested;
  *
  * Even in monochrome mode, you can only have 3 pixels per byte, so there is no
  * savings in using it. We might as well support gray scale.
+ *
+ * Only the modified window is encoded, so rows are packed using the window
+ * width rather than the full display width.
  */
 static uint8_t st7586s_send_buf[ST7586S_NUM_COL_TRIPLETS * ST7586S_NUM_ROWS] __attribute__((section(".noinit"), used));
 
 /**
- * Encode a triplet of pixels into a single byte in the format descrived above.
- *
- * @param p0 First pixel.
- * @param p1 Second pixel.
- * @param p2 Third pixel.
- *
- * @return Encoded triplet.
+ * Lookup tables giving the bits of each pixel of a triplet, for every possible
+ * pixel value. See ::pbdrv_display_st7586s_init_encode_lut.
  */
-static uint8_t encode_triplet(uint8_t p0, uint8_t p1, uint8_t p2) {
-    // As described above, the first two pixels are the normal binary
-    // representation shifted left by one, with an extra bit set for black.
-    // The third pixel is not shifted, so contains just two bits.
-    p0 = p0 >= ST7586S_VALUE_MAX ? 0b111 : (p0 << 1);
-    p1 = p1 >= ST7586S_VALUE_MAX ? 0b111 : (p1 << 1);
-    p2 = p2 >= ST7586S_VALUE_MAX ? 0b11 : p2;
-
-    // Three pixels are then concatenated to one byte.
-    return p0 << 5 | p1 << 2 | p2;
-}
+static uint8_t encode_lut[3][256];
 
 /**
- * Encode the user frame buffer into the display buffer.
+ * Encode a window of the user frame buffer into the display buffer.
+ *
+ * @param [in] triplet_start First column triplet.
+ * @param [in] triplet_end   Last column triplet, included.
+ * @param [in] row_start     First row.
+ * @param [in] row_end       Last row, included.
+ *
+ * @return Number of encoded bytes.
  */
-void pbdrv_display_st7586s_encode_user_frame(void) {
+static uint32_t pbdrv_display_st7586s_encode_user_frame(uint32_t triplet_start, uint32_t triplet_end, uint32_t row_start, uint32_t row_end) {
+    uint8_t *dst = st7586s_send_buf;
     // Iterating over display rows (and ST7586S rows are the same).
-    for (size_t row = 0; row < PBDRV_CONFIG_DISPLAY_NUM_ROWS; row++) {
+    for (uint32_t row = row_start; row <= row_end; row++) {
         // Iterating ST7586S column-triplets, which are 3 columns each.
-        for (size_t triplet = 0; triplet < ST7586S_NUM_COL_TRIPLETS; triplet++) {
-            uint8_t p0 = pbdrv_display_user_frame[row][triplet * 3];
-            uint8_t p1 = pbdrv_display_user_frame[row][triplet * 3 + 1];
-            uint8_t p2 = pbdrv_display_user_frame[row][triplet * 3 + 2];
-            st7586s_send_buf[row * ST7586S_NUM_COL_TRIPLETS + triplet] = encode_triplet(p0, p1, p2);
+        const uint8_t *src = &pbdrv_display_user_frame[row][triplet_start * 3];
+        for (uint32_t triplet = triplet_start; triplet <= triplet_end; triplet++) {
+            *dst++ = encode_lut[0][src[0]] | encode_lut[1][src[1]] | encode_lut[2][src[2]];
+            src += 3;
         }
     }
+    return dst - st7586s_send_buf;
 }
 
 /**
@@ -261,24 +264,45 @@ static const pbdrv_display_st7586s_action_t init_script[] = {
     { ST7586S_ACTION_WRITE_COMMAND, ST7586_DISPON},
     { ST7586S_ACTION_DELAY, 100},
     #endif // ST7586S_DO_RESET_AND_INIT
+    { ST7586S_ACTION_WRITE_COMMAND, ST7586_DSPGRAY},
+};
+
+/**
+ * Index of the column start in the window script.
+ */
+#define WINDOW_SCRIPT_TRIPLET_START (2)
+
+/**
+ * Index of the column end in the window script.
+ */
+#define WINDOW_SCRIPT_TRIPLET_END (4)
+
+/**
+ * Index of the row start in the window script.
+ */
+#define WINDOW_SCRIPT_ROW_START (7)
+
+/**
+ * Index of the row end in the window script.
+ */
+#define WINDOW_SCRIPT_ROW_END (9)
+
+/**
+ * Script to select the display window written by the next frame data. The
+ * window payloads are updated before each frame, only the modified region is
+ * sent.
+ */
+static pbdrv_display_st7586s_action_t window_script[] = {
     { ST7586S_ACTION_WRITE_COMMAND, ST7586_CASET},
     { ST7586S_ACTION_WRITE_DATA, 0x00},
     { ST7586S_ACTION_WRITE_DATA, 0x00},
     { ST7586S_ACTION_WRITE_DATA, 0x00},
-    // This differs from the official firmware and ev3dev, which use 0x7f and
-    // reset it to the value below on every new frame.
     { ST7586S_ACTION_WRITE_DATA, ST7586S_NUM_COL_TRIPLETS - 1},
     { ST7586S_ACTION_WRITE_COMMAND, ST7586_RASET},
     { ST7586S_ACTION_WRITE_DATA, 0x00},
     { ST7586S_ACTION_WRITE_DATA, 0x00},
     { ST7586S_ACTION_WRITE_DATA, 0x00},
-    // This differs from the official firmware and ev3dev, which use 0x9f and
-    // reset it to the value below on every new frame.
     { ST7586S_ACTION_WRITE_DATA, ST7586S_NUM_ROWS - 1},
-    { ST7586S_ACTION_WRITE_COMMAND, ST7586_DSPGRAY},
-    // This differs from the official firmware and ev3dev, which write this on
-    // every frame. By enteringthis mode right away we can keep sending new
-    // frame data without switching back to command mode.
     { ST7586S_ACTION_WRITE_COMMAND, ST7586_RAMWR},
 };
 
@@ -388,13 +412,15 @@ static void pbdrv_display_ev3_spi_init(void) {
     SPIEnable(SOC_SPI_1_REGS);
 }
 
-static pbio_os_process_t pbdrv_display_ev3_process;
-
 /**
- * Display driver process. Initializes the display and updates the display
- * with the user frame buffer if the user data was updated.
+ * Run a script of commands, data, and delays.
+ *
+ * @param [in] state       Protothread state.
+ * @param [in] script      Actions to run.
+ * @param [in] script_size Number of actions.
+ * @return                 ::PBIO_SUCCESS when done or ::PBIO_ERROR_AGAIN.
  */
-static pbio_error_t pbdrv_display_ev3_process_thread(pbio_os_state_t *state, void *context) {
+static pbio_error_t pbdrv_display_st7586s_run_script(pbio_os_state_t *state, const pbdrv_display_st7586s_action_t *script, uint32_t script_size) {
 
     static pbio_os_timer_t timer;
     static uint32_t script_index;
@@ -402,17 +428,10 @@ static pbio_error_t pbdrv_display_ev3_process_thread(pbio_os_state_t *state, voi
 
     PBIO_OS_ASYNC_BEGIN(state);
 
-    #if ST7586S_DO_RESET_AND_INIT
-    pbdrv_gpio_out_low(&pin_lcd_reset);
-    PBIO_OS_AWAIT_MS(state, &timer, 10);
-    pbdrv_gpio_out_high(&pin_lcd_reset);
-    PBIO_OS_AWAIT_MS(state, &timer, 120);
-    #endif // ST7586S_DO_RESET_AND_INIT
-
-    // For every action in the init script, either send a command or data, or
-    // wait for a given delay.
-    for (script_index = 0; script_index < PBIO_ARRAY_SIZE(init_script); script_index++) {
-        const pbdrv_display_st7586s_action_t *action = &init_script[script_index];
+    // For every action in the script, either send a command or data, or wait
+    // for a given delay.
+    for (script_index = 0; script_index < script_size; script_index++) {
+        const pbdrv_display_st7586s_action_t *action = &script[script_index];
 
         if (action->type == ST7586S_ACTION_DELAY) {
             // Simple delay.
@@ -431,10 +450,40 @@ static pbio_error_t pbdrv_display_ev3_process_thread(pbio_os_state_t *state, voi
         }
     }
 
-    // Staying in data mode from here.
-    pbdrv_gpio_out_high(&pin_lcd_a0);
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
 
-    // Clear display to start with.
+static pbio_os_process_t pbdrv_display_ev3_process;
+
+/**
+ * Display driver process. Initializes the display and updates the display
+ * with the modified region of the user frame buffer if the user data was
+ * updated.
+ */
+static pbio_error_t pbdrv_display_ev3_process_thread(pbio_os_state_t *state, void *context) {
+
+    static pbio_os_state_t sub;
+    static uint32_t size;
+
+    #if ST7586S_DO_RESET_AND_INIT
+    static pbio_os_timer_t timer;
+    #endif
+
+    pbio_image_rect_t rect;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    #if ST7586S_DO_RESET_AND_INIT
+    pbdrv_gpio_out_low(&pin_lcd_reset);
+    PBIO_OS_AWAIT_MS(state, &timer, 10);
+    pbdrv_gpio_out_high(&pin_lcd_reset);
+    PBIO_OS_AWAIT_MS(state, &timer, 120);
+    #endif // ST7586S_DO_RESET_AND_INIT
+
+    PBIO_OS_AWAIT(state, &sub, pbdrv_display_st7586s_run_script(&sub, init_script, PBIO_ARRAY_SIZE(init_script)));
+
+    // Clear display to start with. The whole frame is initially considered
+    // modified, so it is all sent.
     memset(&pbdrv_display_user_frame, 0, sizeof(pbdrv_display_user_frame));
     pbdrv_display_user_frame_update_requested = true;
 
@@ -445,8 +494,25 @@ static pbio_error_t pbdrv_display_ev3_process_thread(pbio_os_state_t *state, voi
     for (;;) {
         PBIO_OS_AWAIT_UNTIL(state, pbdrv_display_user_frame_update_requested);
         pbdrv_display_user_frame_update_requested = false;
-        pbdrv_display_st7586s_encode_user_frame();
-        pbdrv_display_st7586s_write_data_begin(st7586s_send_buf, sizeof(st7586s_send_buf));
+        if (!pbio_image_take_dirty(&pbdrv_display_user_frame_dirty, &rect)) {
+            continue;
+        }
+
+        // Encode only the modified window, rounded to column triplets.
+        window_script[WINDOW_SCRIPT_TRIPLET_START].payload = rect.x / 3;
+        window_script[WINDOW_SCRIPT_TRIPLET_END].payload = (rect.x + rect.width - 1) / 3;
+        window_script[WINDOW_SCRIPT_ROW_START].payload = rect.y;
+        window_script[WINDOW_SCRIPT_ROW_END].payload = rect.y + rect.height - 1;
+        size = pbdrv_display_st7586s_encode_user_frame(
+            window_script[WINDOW_SCRIPT_TRIPLET_START].payload,
+            window_script[WINDOW_SCRIPT_TRIPLET_END].payload,
+            window_script[WINDOW_SCRIPT_ROW_START].payload,
+            window_script[WINDOW_SCRIPT_ROW_END].payload);
+
+        // Select the window and send it.
+        PBIO_OS_AWAIT(state, &sub, pbdrv_display_st7586s_run_script(&sub, window_script, PBIO_ARRAY_SIZE(window_script)));
+        pbdrv_gpio_out_high(&pin_lcd_a0);
+        pbdrv_display_st7586s_write_data_begin(st7586s_send_buf, size);
         PBIO_OS_AWAIT_UNTIL(state, spi_status == SPI_STATUS_COMPLETE);
         pbdrv_gpio_out_high(&pin_lcd_cs);
     }
@@ -466,10 +532,14 @@ void pbdrv_display_init(void) {
     // Initialize SPI.
     pbdrv_display_ev3_spi_init();
 
+    // Initialize pixel encoding.
+    pbdrv_display_st7586s_init_encode_lut(encode_lut);
+
     // Initialize image.
     pbio_image_init(&display_image, (uint8_t *)pbdrv_display_user_frame,
         PBDRV_CONFIG_DISPLAY_NUM_COLS, PBDRV_CONFIG_DISPLAY_NUM_ROWS,
         ST7586S_NUM_COL_TRIPLETS * 3);
+    pbio_image_track_dirty(&display_image, &pbdrv_display_user_frame_dirty);
     display_image.print_font = &pbio_font_terminus_normal_16;
     display_image.print_value = ST7586S_VALUE_MAX;
 
@@ -39,6 +39,8 @@
 #include "nxos/drivers/systick.h"
 #include "nxos/drivers/aic.h"
 
+#include "display_convert.h"
+
 /*
  * Internal command bytes implementing part of the basic command set of
  * the UC1601.
@@ -95,9 +97,13 @@ static volatile spi_state_t spi_state;
  *
  *  0: Empty / White
  *  1: Black
+ *
+ * Rows are word aligned so that they can be scanned four pixels at a time.
  */
 static uint8_t pbdrv_display_user_frame[PBDRV_CONFIG_DISPLAY_NUM_ROWS][PBDRV_CONFIG_DISPLAY_NUM_COLS]
-__attribute__((section(".noinit")));
+__attribute__((section(".noinit"), aligned(4)));
+
+_Static_assert(PBDRV_CONFIG_DISPLAY_NUM_COLS % 4 == 0, "rows must be a whole number of words");
 
 /*
  * Flag to indicate that the user frame has been updated and needs to be
@@ -224,16 +230,7 @@ static void spi_init(void) {
 }
 
 void pbdrv_display_nxt_convert_page(int page) {
-    int x, y;
-    for (x = 0; x < PBDRV_CONFIG_DISPLAY_NUM_COLS; x++) {
-        uint8_t b = 0;
-        for (y = 0; y < 8; y++) {
-            if (pbdrv_display_user_frame[page * 8 + y][x]) {
-                b |= 1 << y;
-            }
-        }
-        pbdrv_display_send_buffer[x] = b;
-    }
+    pbdrv_display_uc1601_convert_page(pbdrv_display_send_buffer, pbdrv_display_user_frame[page * 8], PBDRV_CONFIG_DISPLAY_NUM_COLS);
 }
 
 static pbio_os_process_t pbdrv_display_nxt_process;
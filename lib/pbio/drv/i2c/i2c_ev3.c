@@ -141,7 +141,7 @@ pbio_error_t pbdrv_i2c_write_then_read(
             // NXT sensors affected by the quirk can't be accessed too quickly.
             // The timer is set after awaiting so we don't unnecessarily slow
             // down code that polls less frequently.
-            PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_is_expired(&i2c_dev->timer));
+            PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_await(&i2c_dev->timer));
             pbio_os_timer_set(&i2c_dev->timer, 100);
         }
 
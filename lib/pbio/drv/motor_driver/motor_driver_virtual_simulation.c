@@ -67,6 +67,90 @@ static const pbio_simulation_model_t model_technic_m_angular = {
 
 static pbdrv_motor_driver_dev_t motor_driver_devs[PBDRV_CONFIG_MOTOR_DRIVER_NUM_DEV];
 
+/**
+ * Advances the state of one simulated motor by one time step.
+ *
+ * @param [in]  driver  The simulated motor.
+ */
+static void simulation_step(pbdrv_motor_driver_dev_t *driver) {
+
+    // Shorthand notation for frequent local references to model.
+    const pbio_simulation_model_t *m = driver->model;
+
+    // Modified coulomb friction with transition linear in speed through origin.
+    const double limit = 2000;
+    double friction;
+    if (driver->speed > limit) {
+        friction = m->torque_friction;
+    } else if (driver->speed < -limit) {
+        friction = -m->torque_friction;
+    } else {
+        friction = m->torque_friction * driver->speed / limit;
+    }
+
+    // Stall obstacle torque
+    double external_torque = 0;
+    if (driver->angle > driver->pdata->endstop_angle_positive) {
+        external_torque = (driver->angle - driver->pdata->endstop_angle_positive) * 500 + driver->speed * 5;
+    } else if (driver->angle < driver->pdata->endstop_angle_negative) {
+        external_torque = (driver->angle - driver->pdata->endstop_angle_negative) * 500 + driver->speed * 5;
+    }
+
+    double voltage = driver->voltage;
+    double torque = friction + external_torque;
+
+    // Get next state based on current state and input: x(k+1) = Ax(k) + Bu(k)
+    double angle_next = driver->angle +
+        driver->speed * m->d_angle_d_speed +
+        driver->current * m->d_angle_d_current +
+        voltage * m->d_angle_d_voltage +
+        torque * m->d_angle_d_torque;
+    double speed_next = 0 +
+        driver->speed * m->d_speed_d_speed +
+        driver->current * m->d_speed_d_current +
+        voltage * m->d_speed_d_voltage +
+        torque * m->d_speed_d_torque;
+    double current_next = 0 +
+        driver->speed * m->d_current_d_speed +
+        driver->current * m->d_current_d_current +
+        voltage * m->d_current_d_voltage +
+        torque * m->d_current_d_torque;
+
+    // Save new state.
+    driver->angle = angle_next;
+    driver->speed = speed_next;
+    driver->current = current_next;
+}
+
+/**
+ * Timer that expires when the simulation is due to take the next step.
+ */
+static pbio_os_timer_t simulation_timer;
+
+/**
+ * Advances the simulation in steps of 1 ms until it has caught up with the
+ * clock.
+ *
+ * This is called whenever the simulated state is read or its input changes,
+ * so the state is always up to date when it is used. This gives the same
+ * result as stepping it every millisecond, without having to wake up the
+ * system that often.
+ */
+static void simulation_advance(void) {
+    while (pbio_os_timer_is_expired(&simulation_timer)) {
+        pbio_os_timer_extend(&simulation_timer);
+
+        for (uint32_t dev_index = 0; dev_index < PBDRV_CONFIG_MOTOR_DRIVER_NUM_DEV; dev_index++) {
+            pbdrv_motor_driver_dev_t *driver = &motor_driver_devs[dev_index];
+
+            // Skip simulating if there is no model.
+            if (driver->model) {
+                simulation_step(driver);
+            }
+        }
+    }
+}
+
 static void simulation_init(void) {
 
     // This simulation implements the counter and motor driver in one, with
@@ -78,6 +162,9 @@ static void simulation_init(void) {
     }
     has_initialized = true;
 
+    // Matches LTI model discretization time step.
+    pbio_os_timer_set(&simulation_timer, 1);
+
     // Initialize driver from platform data.
     for (uint32_t dev_index = 0; dev_index < PBDRV_CONFIG_MOTOR_DRIVER_NUM_DEV; dev_index++) {
         // Get driver and platform data.
@@ -139,12 +226,14 @@ pbio_error_t pbdrv_counter_assert_type(pbdrv_counter_dev_t *dev, lego_device_typ
 }
 
 pbio_error_t pbdrv_counter_get_angle(pbdrv_counter_dev_t *dev, int32_t *rotations, int32_t *millidegrees) {
+    simulation_advance();
     *rotations = (int32_t)(dev->motor_driver->angle / 360000);
     *millidegrees = (int32_t)(dev->motor_driver->angle) % 360000;
     return PBIO_SUCCESS;
 }
 
 pbio_error_t pbdrv_counter_get_abs_angle(pbdrv_counter_dev_t *dev, int32_t *millidegrees) {
+    simulation_advance();
     *millidegrees = ((int32_t)dev->motor_driver->angle) % 360000;
     if (*millidegrees > 180000) {
         *millidegrees -= 360000;
@@ -165,11 +254,13 @@ pbio_error_t pbdrv_motor_driver_get_dev(uint8_t id, pbdrv_motor_driver_dev_t **d
 }
 
 pbio_error_t pbdrv_motor_driver_coast(pbdrv_motor_driver_dev_t *driver) {
+    simulation_advance();
     driver->voltage = 0.0;
     return PBIO_SUCCESS;
 }
 
 pbio_error_t pbdrv_motor_driver_set_duty_cycle(pbdrv_motor_driver_dev_t *driver, int16_t duty_cycle) {
+    simulation_advance();
     driver->voltage = pbio_battery_get_voltage_from_duty(duty_cycle);
     return PBIO_SUCCESS;
 }
@@ -177,73 +268,13 @@ pbio_error_t pbdrv_motor_driver_set_duty_cycle(pbdrv_motor_driver_dev_t *driver,
 pbio_error_t pbdrv_motor_driver_virtual_simulation_process_thread(pbio_os_state_t *state, void *context) {
     static pbio_os_timer_t timer;
 
-    static uint32_t dev_index;
-    static pbdrv_motor_driver_dev_t *driver;
-
     PBIO_OS_ASYNC_BEGIN(state);
 
-    // Matches LTI model discretization time step.
-    pbio_os_timer_set(&timer, 1);
-
     for (;;) {
-        PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_is_expired(&timer));
-        pbio_os_timer_extend(&timer);
-
-        for (dev_index = 0; dev_index < PBDRV_CONFIG_MOTOR_DRIVER_NUM_DEV; dev_index++) {
-            driver = &motor_driver_devs[dev_index];
-
-            // Skip simulating if there is no model.
-            if (!driver->model) {
-                continue;
-            }
-
-            // Shorthand notation for frequent local references to model.
-            const pbio_simulation_model_t *m = driver->model;
-
-            // Modified coulomb friction with transition linear in speed through origin.
-            const double limit = 2000;
-            double friction;
-            if (driver->speed > limit) {
-                friction = m->torque_friction;
-            } else if (driver->speed < -limit) {
-                friction = -m->torque_friction;
-            } else {
-                friction = m->torque_friction * driver->speed / limit;
-            }
-
-            // Stall obstacle torque
-            double external_torque = 0;
-            if (driver->angle > driver->pdata->endstop_angle_positive) {
-                external_torque = (driver->angle - driver->pdata->endstop_angle_positive) * 500 + driver->speed * 5;
-            } else if (driver->angle < driver->pdata->endstop_angle_negative) {
-                external_torque = (driver->angle - driver->pdata->endstop_angle_negative) * 500 + driver->speed * 5;
-            }
-
-            double voltage = driver->voltage;
-            double torque = friction + external_torque;
-
-            // Get next state based on current state and input: x(k+1) = Ax(k) + Bu(k)
-            double angle_next = driver->angle +
-                driver->speed * m->d_angle_d_speed +
-                driver->current * m->d_angle_d_current +
-                voltage * m->d_angle_d_voltage +
-                torque * m->d_angle_d_torque;
-            double speed_next = 0 +
-                driver->speed * m->d_speed_d_speed +
-                driver->current * m->d_speed_d_current +
-                voltage * m->d_speed_d_voltage +
-                torque * m->d_speed_d_torque;
-            double current_next = 0 +
-                driver->speed * m->d_current_d_speed +
-                driver->current * m->d_current_d_current +
-                voltage * m->d_current_d_voltage +
-                torque * m->d_current_d_torque;
-
-            // Save new state.
-            driver->angle = angle_next;
-            driver->speed = speed_next;
-            driver->current = current_next;
-        }
+        // The simulation is advanced on use, but also advance it regularly
+        // in case it is not used for a long time.
+        PBIO_OS_AWAIT_MS(state, &timer, 100);
+        simulation_advance();
     }
 
     PBIO_OS_ASYNC_END(PBIO_ERROR_FAILED);
@@ -257,7 +288,7 @@ void pbdrv_motor_driver_init(void) {
     simulation_init();
 
     static pbio_os_process_t process;
-    pbio_os_process_start(&process, pbdrv_motor_driver_virtual_simulation_process_thread, NULL);
+    pbio_os_process_start_on_event(&process, pbdrv_motor_driver_virtual_simulation_process_thread, NULL);
 }
 
 #endif // PBDRV_CONFIG_MOTOR_DRIVER_VIRTUAL_SIMULATION
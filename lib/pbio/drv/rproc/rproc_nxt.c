@@ -117,7 +117,7 @@ static pbio_error_t pbdrv_rproc_nxt_link_process_thread(pbio_os_state_t *state,
         while (failed_checksums < AVR_MAX_FAILED_CHECKSUMS) {
 
             // Allow processing on AVR.
-            PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_is_expired(&timer));
+            PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_await(&timer));
             pbio_os_timer_extend(&timer);
 
             // Double buffer command to send to AVR.
@@ -135,7 +135,7 @@ static pbio_error_t pbdrv_rproc_nxt_link_process_thread(pbio_os_state_t *state,
             PBIO_OS_AWAIT_UNTIL(state, nx__twi_ready());
 
             // Allow processing on AVR.
-            PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_is_expired(&timer));
+            PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_await(&timer));
             pbio_os_timer_extend(&timer);
 
             // Get state data from the AVR.
@@ -63,6 +63,14 @@ uint32_t pbdrv_uart_in_waiting(pbdrv_uart_dev_t *uart_dev) {
     return lwrb_get_full(&uart_dev->rx_ring_buf);
 }
 
+uint32_t pbdrv_uart_peek(pbdrv_uart_dev_t *uart_dev, uint32_t offset, uint8_t *data, uint32_t length) {
+    return lwrb_peek(&uart_dev->rx_ring_buf, offset, data, length);
+}
+
+void pbdrv_uart_skip(pbdrv_uart_dev_t *uart_dev, uint32_t length) {
+    lwrb_skip(&uart_dev->rx_ring_buf, length);
+}
+
 pbio_error_t pbdrv_uart_read(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uint8_t *msg, uint32_t length, uint32_t timeout) {
 
     PBIO_OS_ASYNC_BEGIN(state);
@@ -91,7 +99,7 @@ pbio_error_t pbdrv_uart_read(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uin
         // re-entry. If there is already enough data in the buffer, this
         // protothread completes right away without yielding once first.
         uart->rx_buf_index += lwrb_read(&uart->rx_ring_buf, &uart->rx_buf[uart->rx_buf_index], uart->rx_buf_size - uart->rx_buf_index);
-        uart->rx_buf_index == uart->rx_buf_size || (timeout && pbio_os_timer_is_expired(&uart->rx_timer));
+        uart->rx_buf_index == uart->rx_buf_size || (timeout && pbio_os_timer_await(&uart->rx_timer));
     }));
 
     uart->rx_buf = NULL;
@@ -126,7 +134,7 @@ pbio_error_t pbdrv_uart_write(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, co
     uart->USART->CR1 |= USART_CR1_TXEIE;
 
     // Await completion or timeout.
-    PBIO_OS_AWAIT_UNTIL(state, uart->tx_buf_index == uart->tx_buf_size || (timeout && pbio_os_timer_is_expired(&uart->tx_timer)));
+    PBIO_OS_AWAIT_UNTIL(state, uart->tx_buf_index == uart->tx_buf_size || (timeout && pbio_os_timer_await(&uart->tx_timer)));
 
     uart->tx_buf = NULL;
 
@@ -70,6 +70,14 @@ uint32_t pbdrv_uart_in_waiting(pbdrv_uart_dev_t *uart_dev) {
     return lwrb_get_full(&uart_dev->rx_buf);
 }
 
+uint32_t pbdrv_uart_peek(pbdrv_uart_dev_t *uart_dev, uint32_t offset, uint8_t *data, uint32_t length) {
+    return lwrb_peek(&uart_dev->rx_buf, offset, data, length);
+}
+
+void pbdrv_uart_skip(pbdrv_uart_dev_t *uart_dev, uint32_t length) {
+    lwrb_skip(&uart_dev->rx_buf, length);
+}
+
 pbio_error_t pbdrv_uart_read(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uint8_t *msg, uint32_t length, uint32_t timeout) {
 
     PBIO_OS_ASYNC_BEGIN(state);
@@ -94,7 +102,7 @@ pbio_error_t pbdrv_uart_read(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uin
         // re-entry. If there is already enough data in the buffer, this
         // protothread completes right away without yielding once first.
         uart->read_pos += lwrb_read(&uart->rx_buf, &uart->read_buf[uart->read_pos], uart->read_length - uart->read_pos);
-        uart->read_pos == uart->read_length || (timeout && pbio_os_timer_is_expired(&uart->read_timer));
+        uart->read_pos == uart->read_length || (timeout && pbio_os_timer_await(&uart->read_timer));
     }));
 
     uart->read_buf = NULL;
@@ -125,7 +133,7 @@ pbio_error_t pbdrv_uart_write(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, co
     LL_USART_EnableIT_TXE(uart->pdata->uart);
 
     // Await completion or timeout.
-    PBIO_OS_AWAIT_UNTIL(state, uart->write_pos == uart->write_length || (timeout && pbio_os_timer_is_expired(&uart->write_timer)));
+    PBIO_OS_AWAIT_UNTIL(state, uart->write_pos == uart->write_length || (timeout && pbio_os_timer_await(&uart->write_timer)));
 
     uart->write_buf = NULL;
 
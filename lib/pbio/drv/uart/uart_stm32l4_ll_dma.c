@@ -187,6 +187,35 @@ uint32_t pbdrv_uart_in_waiting(pbdrv_uart_dev_t *uart) {
     return (rx_head - uart->rx_tail) & (RX_DATA_SIZE - 1);
 }
 
+uint32_t pbdrv_uart_peek(pbdrv_uart_dev_t *uart, uint32_t offset, uint8_t *data, uint32_t length) {
+    uint32_t available = pbdrv_uart_in_waiting(uart);
+    if (offset >= available) {
+        return 0;
+    }
+    if (length > available - offset) {
+        length = available - offset;
+    }
+
+    // Copy from ring buffer to user buffer, taking care of wrap-around.
+    uint32_t start = (uart->rx_tail + offset) & (RX_DATA_SIZE - 1);
+    if (start + length > RX_DATA_SIZE) {
+        uint32_t partial_size = RX_DATA_SIZE - start;
+        volatile_copy(&uart->rx_data[start], &data[0], partial_size);
+        volatile_copy(&uart->rx_data[0], &data[partial_size], length - partial_size);
+    } else {
+        volatile_copy(&uart->rx_data[start], &data[0], length);
+    }
+    return length;
+}
+
+void pbdrv_uart_skip(pbdrv_uart_dev_t *uart, uint32_t length) {
+    uint32_t available = pbdrv_uart_in_waiting(uart);
+    if (length > available) {
+        length = available;
+    }
+    uart->rx_tail = (uart->rx_tail + length) & (RX_DATA_SIZE - 1);
+}
+
 pbio_error_t pbdrv_uart_read(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uint8_t *msg, uint32_t length, uint32_t timeout) {
 
     PBIO_OS_ASYNC_BEGIN(state);
@@ -204,7 +233,7 @@ pbio_error_t pbdrv_uart_read(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, uin
 
     // Wait until we have enough data or timeout. If there is enough data
     // already, this completes right away without yielding once first.
-    PBIO_OS_AWAIT_UNTIL(state, pbdrv_uart_in_waiting(uart) >= uart->read_length || (timeout && pbio_os_timer_is_expired(&uart->rx_timer)));
+    PBIO_OS_AWAIT_UNTIL(state, pbdrv_uart_in_waiting(uart) >= uart->read_length || (timeout && pbio_os_timer_await(&uart->rx_timer)));
     if (timeout && pbio_os_timer_is_expired(&uart->rx_timer)) {
         uart->read_buf = NULL;
         uart->read_length = 0;
@@ -251,7 +280,7 @@ pbio_error_t pbdrv_uart_write(pbio_os_state_t *state, pbdrv_uart_dev_t *uart, co
         pbio_os_timer_set(&uart->tx_timer, timeout);
     }
 
-    PBIO_OS_AWAIT_WHILE(state, LL_USART_IsEnabledDMAReq_TX(pdata->uart) && !(timeout && pbio_os_timer_is_expired(&uart->tx_timer)));
+    PBIO_OS_AWAIT_WHILE(state, LL_USART_IsEnabledDMAReq_TX(pdata->uart) && !(timeout && pbio_os_timer_await(&uart->tx_timer)));
     if ((timeout && pbio_os_timer_is_expired(&uart->tx_timer))) {
         LL_USART_DisableDMAReq_TX(pdata->uart);
         return PBIO_ERROR_TIMEDOUT;
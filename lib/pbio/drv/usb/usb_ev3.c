@@ -1040,7 +1040,7 @@ pbio_error_t pbdrv_usb_tx_event(pbio_os_state_t *state, const uint8_t *data, uin
     pbdrv_cache_prepare_before_dma(data, size);
     usb_setup_tx_dma_desc(CPPI_DESC_TX_PYBRICKS_EVENT, (uint8_t *)data, size);
 
-    PBIO_OS_AWAIT_UNTIL(state, !transmitting || pbio_os_timer_is_expired(&timer));
+    PBIO_OS_AWAIT_UNTIL(state, !transmitting || pbio_os_timer_await(&timer));
 
     if (pbio_os_timer_is_expired(&timer)) {
         // Transmission has taken too long, so reset the state to allow
@@ -1076,7 +1076,7 @@ pbio_error_t pbdrv_usb_tx_response(pbio_os_state_t *state, pbio_pybricks_error_t
     usb_setup_tx_dma_desc(CPPI_DESC_TX_RESPONSE, ep1_tx_response_buf, sizeof(ep1_tx_response_buf));
 
     // Wait until complete or trigger reset on timeout.
-    PBIO_OS_AWAIT_UNTIL(state, !transmitting || pbio_os_timer_is_expired(&timer));
+    PBIO_OS_AWAIT_UNTIL(state, !transmitting || pbio_os_timer_await(&timer));
     if (pbio_os_timer_is_expired(&timer)) {
         return PBIO_ERROR_TIMEDOUT;
     }
@@ -101,11 +101,32 @@ uint32_t pbdrv_usb_get_data_and_start_receive(uint8_t *data) {
     return size;
 }
 
+/**
+ * Whether stdin is still open, i.e. end of file has not been reached.
+ */
+static bool stdin_is_open = true;
+
+/**
+ * Gets the file descriptor from which USB data is simulated, so the system
+ * can sleep until new data is available.
+ *
+ * @return  The file descriptor or -1 if there is nothing more to read.
+ */
+int pbdrv_usb_simulation_get_fd(void) {
+    #ifdef PBDRV_CONFIG_RUN_ON_CI
+    return -1;
+    #else
+    return stdin_is_open ? STDIN_FILENO : -1;
+    #endif
+}
+
 // Simulates incoming USB data by reading from native host stdin. In
 // MicroPython, it drives the REPL.
 static pbio_error_t pbdrv_usb_test_process_thread(pbio_os_state_t *state, void *context) {
 
+    #if !PBDRV_CONFIG_CLOCK_LINUX_TICKLESS
     static pbio_os_timer_t timer;
+    #endif
 
     PBIO_OS_ASYNC_BEGIN(state);
 
@@ -122,7 +143,12 @@ static pbio_error_t pbdrv_usb_test_process_thread(pbio_os_state_t *state, void *
 
     for (;;) {
 
+        #if PBDRV_CONFIG_CLOCK_LINUX_TICKLESS
+        // The idle hook polls us when stdin becomes readable.
+        PBIO_OS_AWAIT_ONCE(state);
+        #else
         PBIO_OS_AWAIT_MS(state, &timer, 1);
+        #endif
         if (usb_in_size) {
             // Data not read yet.
             continue;
@@ -134,6 +160,10 @@ static pbio_error_t pbdrv_usb_test_process_thread(pbio_os_state_t *state, void *
             usb_in_buf[0] = PBIO_PYBRICKS_OUT_EP_MSG_COMMAND;
             usb_in_buf[1] = PBIO_PYBRICKS_COMMAND_WRITE_STDIN;
             usb_in_size = 2 + num_read;
+        } else if (num_read == 0) {
+            // End of file, so there will never be more data.
+            stdin_is_open = false;
+            break;
         }
     }
 
@@ -75,7 +75,7 @@ pbio_error_t pbdrv_usb_wait_for_charger(pbio_os_state_t *state) {
 
     // Wait Detect flag or a timeout.
     pbio_os_timer_set(&timer, 1000);
-    PBIO_OS_AWAIT_UNTIL(state, (USBx->GCCFG & USB_OTG_GCCFG_DCDET) || pbio_os_timer_is_expired(&timer));
+    PBIO_OS_AWAIT_UNTIL(state, (USBx->GCCFG & USB_OTG_GCCFG_DCDET) || pbio_os_timer_await(&timer));
     if (pbio_os_timer_is_expired(&timer)) {
         USBx->GCCFG &= ~USB_OTG_GCCFG_DCDEN;
         HAL_PCDEx_DeActivateBCD(&hpcd);
@@ -305,7 +305,7 @@ pbio_error_t pbdrv_usb_tx_event(pbio_os_state_t *state, const uint8_t *data, uin
     transmitting = true;
     pbio_os_timer_set(&timer, PBDRV_USB_TRANSMIT_TIMEOUT);
     USBD_Pybricks_TransmitPacket(&husbd, (uint8_t *)data, size);
-    PBIO_OS_AWAIT_UNTIL(state, !transmitting || pbio_os_timer_is_expired(&timer));
+    PBIO_OS_AWAIT_UNTIL(state, !transmitting || pbio_os_timer_await(&timer));
 
     if (pbio_os_timer_is_expired(&timer)) {
         return PBIO_ERROR_TIMEDOUT;
@@ -331,7 +331,7 @@ pbio_error_t pbdrv_usb_tx_response(pbio_os_state_t *state, pbio_pybricks_error_t
 
     USBD_Pybricks_TransmitPacket(&husbd, usb_response_buf, sizeof(usb_response_buf));
 
-    PBIO_OS_AWAIT_UNTIL(state, !transmitting || pbio_os_timer_is_expired(&timer));
+    PBIO_OS_AWAIT_UNTIL(state, !transmitting || pbio_os_timer_await(&timer));
     if (pbio_os_timer_is_expired(&timer)) {
         return PBIO_ERROR_TIMEDOUT;
     }
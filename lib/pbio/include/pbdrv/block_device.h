@@ -31,6 +31,19 @@
  */
 pbio_error_t pbdrv_block_device_get_data(pbsys_storage_data_map_t **data);
 
+/**
+ * Gets the stored data in place, if the storage is memory mapped.
+ *
+ * This is the data that was loaded on boot, so it only matches the data
+ * from ::pbdrv_block_device_get_data where that has not been changed since.
+ *
+ * @param [out] data    Pointer to the stored data.
+ * @return              ::PBIO_SUCCESS on success.
+ *                      ::PBIO_ERROR_NOT_SUPPORTED if the storage is not memory
+ *                        mapped or if no valid data was loaded on boot.
+ */
+pbio_error_t pbdrv_block_device_get_mapped_data(const pbsys_storage_data_map_t **data);
+
 /**
  * Writes the "RAM Disk" to storage. May erase entire disk prior to writing.
  *
@@ -49,6 +62,26 @@ pbio_error_t pbdrv_block_device_get_data(pbsys_storage_data_map_t **data);
  */
 pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_data_size);
 
+/**
+ * Writes the changed part of the "RAM Disk" to storage.
+ *
+ * Only the erase sectors that overlap with the changed range are erased and
+ * written again, so small changes can be saved much faster than with
+ * ::pbdrv_block_device_write_all. Data outside of the changed range must be
+ * unchanged since it was loaded or last written.
+ *
+ * @param [in] state        Protothread state.
+ * @param [in] used_data_size How many bytes of the data map are in use.
+ * @param [in] dirty_start  Offset of the first changed byte in the data map.
+ * @param [in] dirty_end    Offset just after the last changed byte in the data map.
+ * @return                  ::PBIO_SUCCESS on success.
+ *                          ::PBIO_INVALID_ARGUMENT if size is too big.
+ *                          ::PBIO_ERROR_BUSY (driver-specific error)
+ *                          ::PBIO_ERROR_TIMEDOUT (driver-specific error)
+ *                          ::PBIO_ERROR_IO (driver-specific error)
+ */
+pbio_error_t pbdrv_block_device_write_range(pbio_os_state_t *state, uint32_t used_data_size, uint32_t dirty_start, uint32_t dirty_end);
+
 /**
  * Gets the maximum writable size for user data that can be saved to the device.
  *
@@ -62,10 +95,18 @@ static inline pbio_error_t pbdrv_block_device_get_data(pbsys_storage_data_map_t
     return PBIO_ERROR_NOT_SUPPORTED;
 }
 
+static inline pbio_error_t pbdrv_block_device_get_mapped_data(const pbsys_storage_data_map_t **data) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
 static inline pbio_error_t pbdrv_block_device_write_all(pbio_os_state_t *state, uint32_t used_data_size) {
     return PBIO_ERROR_NOT_SUPPORTED;
 }
 
+static inline pbio_error_t pbdrv_block_device_write_range(pbio_os_state_t *state, uint32_t used_data_size, uint32_t dirty_start, uint32_t dirty_end) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
 static inline uint32_t pbdrv_block_device_get_writable_size(void) {
     return 0;
 }
@@ -269,6 +269,23 @@ typedef struct {
 #define PBDRV_BLUETOOTH_MAX_MTU_SIZE 23
 #endif
 
+#ifdef PBDRV_CONFIG_BLUETOOTH_STDOUT_BUF_SIZE
+#if PBDRV_CONFIG_BLUETOOTH_STDOUT_BUF_SIZE < PBDRV_BLUETOOTH_MAX_CHAR_SIZE * 2
+#error PBDRV_CONFIG_BLUETOOTH_STDOUT_BUF_SIZE too small
+#endif
+#define PBDRV_BLUETOOTH_STDOUT_BUF_SIZE PBDRV_CONFIG_BLUETOOTH_STDOUT_BUF_SIZE
+#else
+/** The maximum number of stdout bytes that can be queued for sending. */
+#define PBDRV_BLUETOOTH_STDOUT_BUF_SIZE (PBDRV_BLUETOOTH_MAX_CHAR_SIZE * 2)
+#endif
+
+#ifdef PBDRV_CONFIG_BLUETOOTH_NUM_EVENT_SLOTS
+#define PBDRV_BLUETOOTH_NUM_EVENT_SLOTS PBDRV_CONFIG_BLUETOOTH_NUM_EVENT_SLOTS
+#else
+/** The number of events of each type that can be queued for sending. */
+#define PBDRV_BLUETOOTH_NUM_EVENT_SLOTS (1)
+#endif
+
 #if PBDRV_CONFIG_BLUETOOTH
 
 //
@@ -365,11 +382,54 @@ uint32_t pbdrv_bluetooth_tx_available(void);
 bool pbdrv_bluetooth_tx_is_idle(void);
 
 /**
- * Sends a value notification and await it.
+ * Sets how many bytes can be queued for transmission via Bluetooth.
+ *
+ * A smaller queue makes printing block sooner, which limits the delay between
+ * printing and the data arriving on the host. This also resets the high
+ * watermark of the queue.
+ *
+ * The size goes back to ::PBDRV_BLUETOOTH_STDOUT_BUF_SIZE when the user
+ * program ends, once all queued data has been sent.
+ *
+ * @param [in] size         The queue size, at least ::PBDRV_BLUETOOTH_MAX_CHAR_SIZE
+ *                          and at most ::PBDRV_BLUETOOTH_STDOUT_BUF_SIZE.
+ * @return                  ::PBIO_SUCCESS on success,
+ *                          ::PBIO_ERROR_INVALID_ARG if @p size is out of range, or
+ *                          ::PBIO_ERROR_BUSY if the queue is not empty.
+ */
+pbio_error_t pbdrv_bluetooth_tx_set_buffer_size(uint32_t size);
+
+/**
+ * Gets the number of bytes that can be queued for transmission via Bluetooth.
+ *
+ * @returns The queue size.
+ */
+uint32_t pbdrv_bluetooth_tx_get_buffer_size(void);
+
+/**
+ * Gets the largest number of bytes that was waiting in the Tx queue since
+ * startup or since the queue size was last set.
+ *
+ * If this is close to the queue size, printing had to wait for data to be sent.
+ *
+ * @returns The high watermark in bytes.
+ */
+uint32_t pbdrv_bluetooth_tx_get_high_watermark(void);
+
+/**
+ * Queues a value notification and awaits it.
  *
  * Uses the same mechanism as stdout or status events, but is user-awaitable.
  *
- * This does not not use a ringbuffer. Await operation before sending more.
+ * Up to ::PBDRV_BLUETOOTH_NUM_EVENT_SLOTS events of each type can be queued.
+ * If all slots are in use, this awaits until one is free. The data is then
+ * copied, and the operation completes as soon as there is room for another
+ * event of this type, so it does not wait for the data to be sent. Because
+ * of this, a single producer always has its data copied on the first call.
+ * Concurrent producers of the same event type must keep passing the same
+ * data while awaiting.
+ * Stdout, telemetry, and log events that are queued together may be sent as
+ * one notification.
  *
  * @param [in] state    Protothread state.
  * @param [in] event    Event type (status, stdout, or app data).
@@ -378,7 +438,6 @@ bool pbdrv_bluetooth_tx_is_idle(void);
  * @return              ::PBIO_SUCCESS on completion.
  *                      ::PBIO_ERROR_INVALID_OP if there is no connection.
  *                      ::PBIO_ERROR_AGAIN while awaiting.
- *                      ::PBIO_ERROR_BUSY if this operation is already ongoing.
  *                      ::PBIO_ERROR_INVALID_ARG if @p size is too large.
  */
 pbio_error_t pbdrv_bluetooth_send_event_notification(pbio_os_state_t *state, pbio_pybricks_event_t event, const uint8_t *data, size_t size);
@@ -581,7 +640,7 @@ pbio_error_t pbdrv_bluetooth_await_advertise_or_scan_command(pbio_os_state_t *st
 /**
  * Awaits user activity to complete, usually called during cleanup after running
  * a user program. This will disconnect from the peripheral and stop scanning
- * and advertising.
+ * and advertising. The stdout buffer size is restored to its default.
  *
  * @param [in]  state          Protothread state.
  * @param [in]  timer          Timer used to give up if this takes too long.
@@ -656,6 +715,18 @@ static inline bool pbdrv_bluetooth_tx_is_idle(void) {
     return true;
 }
 
+static inline pbio_error_t pbdrv_bluetooth_tx_set_buffer_size(uint32_t size) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
+static inline uint32_t pbdrv_bluetooth_tx_get_buffer_size(void) {
+    return 0;
+}
+
+static inline uint32_t pbdrv_bluetooth_tx_get_high_watermark(void) {
+    return 0;
+}
+
 static inline pbio_error_t pbdrv_bluetooth_send_event_notification(
     pbio_os_state_t *state, pbio_pybricks_event_t event, const uint8_t *data, size_t size) {
     return PBIO_ERROR_NOT_SUPPORTED;
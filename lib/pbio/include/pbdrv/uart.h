@@ -41,6 +41,30 @@ void pbdrv_uart_flush(pbdrv_uart_dev_t *uart_dev);
  */
 uint32_t pbdrv_uart_in_waiting(pbdrv_uart_dev_t *uart_dev);
 
+/**
+ * Copies bytes from the incoming buffer without consuming them.
+ *
+ * This lets protocol parsers inspect all data that has arrived so far and
+ * decide how much of it to consume. It must not be used while an asynchronous
+ * read is in progress on the same device.
+ *
+ * @param [in]  uart_dev  The UART device.
+ * @param [in]  offset    Number of bytes to skip at the start of the buffer.
+ * @param [out] data      The buffer to copy the data into.
+ * @param [in]  length    The maximum number of bytes to copy.
+ * @return The number of bytes copied, which is less than @p length if fewer bytes are available.
+ */
+uint32_t pbdrv_uart_peek(pbdrv_uart_dev_t *uart_dev, uint32_t offset, uint8_t *data, uint32_t length);
+
+/**
+ * Discards bytes from the incoming buffer, usually after reading them with
+ * ::pbdrv_uart_peek.
+ *
+ * @param [in]  uart_dev  The UART device.
+ * @param [in]  length    The number of bytes to discard. Must not exceed ::pbdrv_uart_in_waiting.
+ */
+void pbdrv_uart_skip(pbdrv_uart_dev_t *uart_dev, uint32_t length);
+
 /**
  * Asynchronously read from the UART.
  *
@@ -97,6 +121,13 @@ static inline uint32_t pbdrv_uart_in_waiting(pbdrv_uart_dev_t *uart_dev) {
     return 0;
 }
 
+static inline uint32_t pbdrv_uart_peek(pbdrv_uart_dev_t *uart_dev, uint32_t offset, uint8_t *data, uint32_t length) {
+    return 0;
+}
+
+static inline void pbdrv_uart_skip(pbdrv_uart_dev_t *uart_dev, uint32_t length) {
+}
+
 static inline pbio_error_t pbdrv_uart_write(pbio_os_state_t *state, pbdrv_uart_dev_t *uart_dev, uint8_t *msg, uint32_t length, uint32_t timeout) {
     return PBIO_ERROR_NOT_SUPPORTED;
 }
@@ -24,8 +24,28 @@
 // Must be > PBIO_CONFIG_DIFFERENTIATOR_WINDOW_SIZE. This allows a user
 // program to get speed with additional control over the trade off between a
 // smooth but delayed value (long window) or noisy and fast value (short window).
+// A power of two is slightly faster since the ring buffer index can be masked.
 #ifndef PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE
-#define PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE (PBIO_CONFIG_DIFFERENTIATOR_WINDOW_SIZE * 3 + 1)
+#define PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE (64)
+#endif
+
+// Number of relative position segments that can be queued on a controller to
+// start exactly when the ongoing maneuver ends.
+#ifndef PBIO_CONFIG_CONTROL_QUEUE_SIZE
+#define PBIO_CONFIG_CONTROL_QUEUE_SIZE (4)
+#endif
+
+// Number of recent data samples kept for each LEGO UART device, so that
+// callers can tell new samples from ones they have already seen, or 0 to
+// disable the sample history.
+#ifndef PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES
+#define PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES (0)
+#endif
+
+// Number of pixel runs in the cache of expanded glyphs used by image print
+// functions, or 0 to disable the cache. Builtin fonts need about 1300 runs.
+#ifndef PBIO_CONFIG_IMAGE_GLYPH_CACHE_SIZE
+#define PBIO_CONFIG_IMAGE_GLYPH_CACHE_SIZE (0)
 #endif
 
 #define PBIO_CONFIG_NUM_DRIVEBASES (PBIO_CONFIG_SERVO_NUM_DEV / 2)
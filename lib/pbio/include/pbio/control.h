@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include <pbio/angle.h>
+#include <pbio/config.h>
 #include <pbio/control_settings.h>
 #include <pbio/error.h>
 #include <pbio/port.h>
@@ -28,6 +29,9 @@
 // Number of values per row when control data logger is active.
 #define PBIO_CONTROL_LOGGER_NUM_COLS (12)
 
+// Names and scales of the values per row when control data logger is active.
+extern const pbio_logger_column_t pbio_control_logger_columns[PBIO_CONTROL_LOGGER_NUM_COLS];
+
 /**
  * Actions to be taken when a control command completes.
  */
@@ -125,6 +129,42 @@ typedef enum {
     PBIO_CONTROL_STATUS_COMPLETE = 1 << 1,
 } pbio_control_status_flag_t;
 
+/**
+ * Relative position maneuver that starts when the ongoing one ends.
+ */
+typedef struct _pbio_control_segment_t {
+    /**
+     * Distance to travel from the end of the previous maneuver (application units).
+     */
+    int32_t distance;
+    /**
+     * Top speed (application units). If zero, default speed is used.
+     */
+    int32_t speed;
+    /**
+     * What to do when reaching the end of this segment.
+     */
+    pbio_control_on_completion_t on_completion;
+} pbio_control_segment_t;
+
+/**
+ * Queue of maneuvers that follow the ongoing maneuver.
+ */
+typedef struct _pbio_control_queue_t {
+    /**
+     * Ring buffer of queued segments.
+     */
+    pbio_control_segment_t segments[PBIO_CONFIG_CONTROL_QUEUE_SIZE];
+    /**
+     * Index of the next segment to start.
+     */
+    uint8_t first;
+    /**
+     * Number of segments in the queue.
+     */
+    uint8_t count;
+} pbio_control_queue_t;
+
 /**
  * Controller status and state.
  */
@@ -147,6 +187,11 @@ typedef struct _pbio_control_t {
      * last-used trajectory.
      */
     pbio_trajectory_t trajectory;
+    /**
+     * Maneuvers to start when the trajectory ends, without waiting for the
+     * application to issue the next command.
+     */
+    pbio_control_queue_t queue;
     /**
      * Integrator of the speed error. Used when timed speed control is active.
      */
@@ -204,6 +249,13 @@ pbio_error_t pbio_control_start_position_control_relative(pbio_control_t *ctl, u
 pbio_error_t pbio_control_start_position_control_hold(pbio_control_t *ctl, uint32_t time_now, int32_t position);
 pbio_error_t pbio_control_start_timed_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, uint32_t duration, int32_t speed, pbio_control_on_completion_t on_completion);
 
+// Queue control commands:
+
+pbio_error_t pbio_control_queue_position_control_relative(pbio_control_t *ctl, int32_t distance, int32_t speed, pbio_control_on_completion_t on_completion);
+bool pbio_control_queue_is_open(const pbio_control_t *ctl, uint32_t time_now);
+bool pbio_control_queue_is_due(const pbio_control_t *ctl, uint32_t time_now);
+pbio_error_t pbio_control_queue_start_next(pbio_control_t *ctl, uint32_t time_now);
+
 #endif // _PBIO_CONTROL_H_
 
 /** @} */
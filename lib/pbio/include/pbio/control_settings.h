@@ -77,6 +77,12 @@ typedef struct _pbio_control_settings_t {
      * Absolute rate of change of the speed during off-ramp of the maneuver.
      */
     int32_t deceleration;
+    /**
+     * Percentage of the on-ramp and off-ramp during which the acceleration
+     * changes gradually, making an S-curve. If zero, the speed profile is
+     * trapezoidal. The peak acceleration does not exceed the values above.
+     */
+    int32_t smoothing;
     /**
      * Maximum feedback actuation value. On a motor this is the maximum torque.
      */
@@ -146,6 +152,8 @@ int32_t pbio_control_settings_div_by_gain(int32_t value, int32_t gain);
 
 void pbio_control_settings_get_trajectory_limits(const pbio_control_settings_t *s, int32_t *speed, int32_t *acceleration, int32_t *deceleration);
 pbio_error_t pbio_control_settings_set_trajectory_limits(pbio_control_settings_t *s, int32_t speed, int32_t acceleration, int32_t deceleration);
+int32_t pbio_control_settings_get_trajectory_smoothing(const pbio_control_settings_t *s);
+pbio_error_t pbio_control_settings_set_trajectory_smoothing(pbio_control_settings_t *s, int32_t smoothing);
 int32_t pbio_control_settings_get_actuation_limit(const pbio_control_settings_t *s);
 pbio_error_t pbio_control_settings_set_actuation_limit(pbio_control_settings_t *s, int32_t limit);
 void pbio_control_settings_get_pid(const pbio_control_settings_t *s, int32_t *pid_kp, int32_t *pid_ki, int32_t *pid_kd, int32_t *integral_deadzone, int32_t *integral_change_max);
@@ -25,7 +25,8 @@
  *
  * This works by keeping a ring buffer of position increments between each
  * loop iteration. The speed is the average position difference across a given
- * time window.
+ * time window. The sum across the default window is updated with each sample,
+ * so the speed used by the controller is computed in constant time.
  */
 typedef struct _pbio_differentiator_t {
     /**
@@ -36,6 +37,10 @@ typedef struct _pbio_differentiator_t {
      * Ring buffer of increments.
      */
     int16_t history[PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE];
+    /**
+     * Sum of the increments across the default window.
+     */
+    int32_t window_sum;
     /**
      * Ring buffer index of the newest sampe.
      */
@@ -52,6 +52,7 @@ typedef struct _pbio_drivebase_t {
 } pbio_drivebase_t;
 
 pbio_error_t pbio_drivebase_get_drivebase(pbio_drivebase_t **db_address, pbio_servo_t *left, pbio_servo_t *right, int32_t wheel_diameter, int32_t axle_track);
+pbio_drivebase_t *pbio_drivebase_by_index(uint8_t index);
 
 // Drive base status:
 
@@ -68,6 +69,13 @@ pbio_error_t pbio_drivebase_drive_curve(pbio_drivebase_t *db, int32_t radius, in
 pbio_error_t pbio_drivebase_drive_arc_angle(pbio_drivebase_t *db, int32_t radius, int32_t angle, pbio_control_on_completion_t on_completion);
 pbio_error_t pbio_drivebase_drive_arc_distance(pbio_drivebase_t *db, int32_t radius, int32_t distance, pbio_control_on_completion_t on_completion);
 
+// Point to point control that starts when the ongoing maneuver ends:
+
+pbio_error_t pbio_drivebase_queue_straight(pbio_drivebase_t *db, int32_t distance, pbio_control_on_completion_t on_completion);
+pbio_error_t pbio_drivebase_queue_curve(pbio_drivebase_t *db, int32_t radius, int32_t angle, pbio_control_on_completion_t on_completion);
+pbio_error_t pbio_drivebase_queue_arc_angle(pbio_drivebase_t *db, int32_t radius, int32_t angle, pbio_control_on_completion_t on_completion);
+pbio_error_t pbio_drivebase_queue_arc_distance(pbio_drivebase_t *db, int32_t radius, int32_t distance, pbio_control_on_completion_t on_completion);
+
 // Infinite driving:
 
 pbio_error_t pbio_drivebase_drive_forever(pbio_drivebase_t *db, int32_t speed, int32_t turn_rate);
@@ -12,9 +12,36 @@
 #include <pbio/config.h>
 #include <pbio/font.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 
+/**
+ * Region of an image which was modified since it was last taken.
+ *
+ * This is shared between an image and all its viewports, so that drawing in
+ * any of them accumulates in the same region, expressed in the coordinates of
+ * the image on which tracking was started.
+ */
+typedef struct _pbio_image_dirty_t {
+    /**
+     * Left X coordinate, included.
+     */
+    int x1;
+    /**
+     * Top Y coordinate, included.
+     */
+    int y1;
+    /**
+     * Right X coordinate, excluded. Region is empty if not greater than x1.
+     */
+    int x2;
+    /**
+     * Bottom Y coordinate, excluded.
+     */
+    int y2;
+} pbio_image_dirty_t;
+
 /**
  * Image container.
  *
@@ -67,6 +94,18 @@ typedef struct _pbio_image_t {
      * Pixel value for text printing (pbio_image_print* functions).
      */
     uint8_t print_value;
+    /**
+     * Modified region tracking, or NULL if not tracked.
+     */
+    pbio_image_dirty_t *dirty;
+    /**
+     * X coordinate of this image inside the tracked image.
+     */
+    int dirty_x;
+    /**
+     * Y coordinate of this image inside the tracked image.
+     */
+    int dirty_y;
 } pbio_image_t;
 
 /**
@@ -99,6 +138,10 @@ void pbio_image_init(pbio_image_t *image, uint8_t *pixels, int width,
 void pbio_image_init_sub(pbio_image_t *image, const pbio_image_t *source,
     int x, int y, int width, int height);
 
+void pbio_image_track_dirty(pbio_image_t *image, pbio_image_dirty_t *dirty);
+
+bool pbio_image_take_dirty(pbio_image_dirty_t *dirty, pbio_image_rect_t *rect);
+
 void pbio_image_fill(pbio_image_t *image, uint8_t value);
 
 void pbio_image_draw_image(pbio_image_t *image, const pbio_image_t *source,
@@ -163,6 +206,11 @@ static inline void pbio_image_init(pbio_image_t *image, uint8_t *pixels, int wid
 }
 static inline void pbio_image_init_sub(pbio_image_t *image, const pbio_image_t *source, int x, int y, int width, int height) {
 }
+static inline void pbio_image_track_dirty(pbio_image_t *image, pbio_image_dirty_t *dirty) {
+}
+static inline bool pbio_image_take_dirty(pbio_image_dirty_t *dirty, pbio_image_rect_t *rect) {
+    return false;
+}
 static inline void pbio_image_fill(pbio_image_t *image, uint8_t value) {
 }
 static inline void pbio_image_draw_image(pbio_image_t *image, const pbio_image_t *source, int x, int y) {
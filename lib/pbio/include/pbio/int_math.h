@@ -40,6 +40,63 @@ int32_t pbio_int_math_sqrt(int32_t n);
 int32_t pbio_int_math_sin_deg(int32_t x);
 int32_t pbio_int_math_cos_deg(int32_t x);
 
+// Division by precomputed reciprocals.
+
+/**
+ * Reciprocal of a constant divisor, used to divide by multiplying and shifting
+ * instead of a division instruction, which is slow or absent on some hubs.
+ *
+ * Create one with ::PBIO_INT_MATH_RECIPROCAL and use it with
+ * ::pbio_int_math_div_reciprocal, which gives exactly the same result as
+ * the C division operator for all inputs.
+ */
+typedef struct {
+    /** Fractional part of the 33-bit multiplier. */
+    uint32_t magic;
+    /** Shift applied before adding the high part of the product. */
+    uint8_t shift_1;
+    /** Shift applied to get the final quotient. */
+    uint8_t shift_2;
+    /** Whether the divisor is negative. */
+    bool negative;
+} pbio_int_math_reciprocal_t;
+
+/** Absolute value of a constant divisor. */
+#define PBIO_INT_MATH_RECIPROCAL_ABS(d) ((uint32_t)((d) < 0 ? -(int64_t)(d) : (int64_t)(d)))
+
+/** Ceiling of the base 2 logarithm of a nonzero constant divisor. */
+#define PBIO_INT_MATH_RECIPROCAL_LOG2(d) \
+    (PBIO_INT_MATH_RECIPROCAL_ABS(d) == 1 ? 0 : 32 - __builtin_clz(PBIO_INT_MATH_RECIPROCAL_ABS(d) - 1))
+
+/**
+ * Initializer for a ::pbio_int_math_reciprocal_t. This is evaluated at build
+ * time, so it can be used for constant data.
+ *
+ * @param [in]  d   Nonzero divisor.
+ */
+#define PBIO_INT_MATH_RECIPROCAL(d) { \
+        .magic = (uint32_t)(((((uint64_t)1 << PBIO_INT_MATH_RECIPROCAL_LOG2(d)) - PBIO_INT_MATH_RECIPROCAL_ABS(d)) << 32) \
+            / PBIO_INT_MATH_RECIPROCAL_ABS(d) + 1), \
+        .shift_1 = PBIO_INT_MATH_RECIPROCAL_LOG2(d) > 0 ? 1 : 0, \
+        .shift_2 = PBIO_INT_MATH_RECIPROCAL_LOG2(d) > 0 ? PBIO_INT_MATH_RECIPROCAL_LOG2(d) - 1 : 0, \
+        .negative = (d) < 0, \
+}
+
+/**
+ * Divides by a precomputed reciprocal, rounding towards zero.
+ *
+ * @param [in]  n   Numerator.
+ * @param [in]  r   Reciprocal of the divisor.
+ * @return          Same as n / d for the divisor d that r was made from.
+ */
+static inline int32_t pbio_int_math_div_reciprocal(int32_t n, const pbio_int_math_reciprocal_t *r) {
+    // Divide the magnitude, which also works for INT32_MIN.
+    uint32_t a = n < 0 ? -(uint32_t)n : (uint32_t)n;
+    uint32_t t = (uint32_t)(((uint64_t)r->magic * a) >> 32);
+    uint32_t q = (t + ((a - t) >> r->shift_1)) >> r->shift_2;
+    return (n < 0) != r->negative ? -(int32_t)q : (int32_t)q;
+}
+
 // Interpolation
 
 /**
@@ -12,12 +12,28 @@
 #define _PBIO_LOGGER_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include <pbio/config.h>
 #include <pbio/error.h>
+#include <pbio/util.h>
 
 
+/**
+ * Description of one logged column, used to label exported data.
+ */
+typedef struct _pbio_logger_column_t {
+    /**
+     * Short name of the column.
+     */
+    const char *name;
+    /**
+     * Number of raw values per unit, e.g. 1000 for a voltage logged in mV.
+     */
+    int32_t scale;
+} pbio_logger_column_t;
+
 /**
  * Logger object for storing data from background control loops.
  */
@@ -36,9 +52,24 @@ typedef struct _pbio_log_t {
      */
     uint32_t num_rows;
     /**
-     * How many rows have been used (filled) so far.
+     * How many rows have been used (filled) so far. In streaming mode, this
+     * is the total number of rows written since the start.
      */
     uint32_t num_rows_used;
+    /**
+     * Whether the buffer is used as a ring buffer that is read while logging.
+     */
+    bool stream;
+    /**
+     * In streaming mode, the total number of rows read since the start. This
+     * is the cursor of the reader.
+     */
+    uint32_t num_rows_read;
+    /**
+     * In streaming mode, the number of rows dropped because the reader did not
+     * keep up and the buffer was full.
+     */
+    uint32_t num_overruns;
     /**
      * Data buffer allocated by external application.
      */
@@ -72,6 +103,24 @@ void pbio_logger_add_row(pbio_log_t *log, const int32_t *row_data);
 uint32_t pbio_logger_get_num_rows_used(const pbio_log_t *log);
 int32_t *pbio_logger_get_row_data(const pbio_log_t *log, uint32_t index);
 
+void pbio_logger_start_stream(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint8_t num_cols, int32_t down_sample);
+bool pbio_logger_is_stream(const pbio_log_t *log);
+uint32_t pbio_logger_stream_get_num_available(const pbio_log_t *log);
+uint32_t pbio_logger_stream_get_num_overruns(const pbio_log_t *log);
+const int32_t *pbio_logger_stream_read_row(pbio_log_t *log);
+
+/** Magic bytes at the start of a binary log export. */
+#define PBIO_LOGGER_BINARY_MAGIC "PBLG"
+
+/** Version of the binary log export format. */
+#define PBIO_LOGGER_BINARY_VERSION (1)
+
+/** Maximum encoded size of one value in a binary log export. */
+#define PBIO_LOGGER_BINARY_MAX_VALUE_SIZE (PBIO_VARINT_ZIGZAG_MAX_SIZE)
+
+size_t pbio_logger_binary_encode_header(const pbio_log_t *log, const pbio_logger_column_t *columns, const char *path, uint8_t *buf, size_t size);
+size_t pbio_logger_binary_encode_rows(const pbio_log_t *log, uint32_t *cursor, uint8_t *buf, size_t size);
+
 #else
 
 static inline void pbio_logger_start(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint8_t num_cols, int32_t down_sample) {
@@ -89,6 +138,26 @@ static inline uint32_t pbio_logger_get_num_rows_used(const pbio_log_t *log) {
 static inline int32_t *pbio_logger_get_row_data(pbio_log_t *log, uint32_t index) {
     return NULL;
 }
+static inline void pbio_logger_start_stream(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint8_t num_cols, int32_t down_sample) {
+}
+static inline bool pbio_logger_is_stream(const pbio_log_t *log) {
+    return false;
+}
+static inline uint32_t pbio_logger_stream_get_num_available(const pbio_log_t *log) {
+    return 0;
+}
+static inline uint32_t pbio_logger_stream_get_num_overruns(const pbio_log_t *log) {
+    return 0;
+}
+static inline const int32_t *pbio_logger_stream_read_row(pbio_log_t *log) {
+    return NULL;
+}
+static inline size_t pbio_logger_binary_encode_header(const pbio_log_t *log, const pbio_logger_column_t *columns, const char *path, uint8_t *buf, size_t size) {
+    return 0;
+}
+static inline size_t pbio_logger_binary_encode_rows(const pbio_log_t *log, uint32_t *cursor, uint8_t *buf, size_t size) {
+    return 0;
+}
 
 #endif // PBIO_CONFIG_LOGGER
 
@@ -15,8 +15,55 @@
 
 #if PBIO_CONFIG_MOTOR_PROCESS
 
+#include <stdint.h>
+
+/**
+ * Number of buckets in the motor process latency histogram.
+ */
+#define PBIO_MOTOR_PROCESS_HISTOGRAM_SIZE (8)
+
+/**
+ * Timing statistics of the motor control loop.
+ */
+typedef struct _pbio_motor_process_stats_t {
+    /**
+     * Number of control loop iterations.
+     */
+    uint32_t num_ticks;
+    /**
+     * Number of iterations that finished after the next one was due, causing
+     * the loop to fall behind its schedule.
+     */
+    uint32_t num_missed;
+    /**
+     * Execution time of the drivebase and servo updates in the latest
+     * iteration, in microseconds.
+     */
+    uint32_t exec_time_last;
+    /**
+     * Highest execution time of the drivebase and servo updates, in
+     * microseconds.
+     */
+    uint32_t exec_time_max;
+    /**
+     * Highest delay between the scheduled and actual start of an iteration,
+     * in microseconds.
+     */
+    uint32_t latency_max;
+    /**
+     * Number of iterations by start delay. Bucket i counts delays of i to
+     * i + 1 milliseconds. The last bucket includes all longer delays.
+     */
+    uint32_t latency_histogram[PBIO_MOTOR_PROCESS_HISTOGRAM_SIZE];
+} pbio_motor_process_stats_t;
+
 void pbio_motor_process_start(void);
 
+#if PBIO_CONFIG_MOTOR_PROCESS_STATS
+const pbio_motor_process_stats_t *pbio_motor_process_get_stats(void);
+void pbio_motor_process_reset_stats(void);
+#endif // PBIO_CONFIG_MOTOR_PROCESS_STATS
+
 #else
 
 static inline void pbio_motor_process_start(void) {
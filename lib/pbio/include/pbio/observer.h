@@ -19,28 +19,32 @@
 #include <pbio/control_settings.h>
 #include <pbio/dcmotor.h>
 #include <pbio/differentiator.h>
+#include <pbio/int_math.h>
 #include <pbio/angle.h>
 
 /**
  * Device-type specific constants that describe the motor model.
+ *
+ * The model coefficients are divisors, stored as reciprocals so that the
+ * observer can be updated without division instructions.
  */
 typedef struct _pbio_observer_model_t {
-    int32_t d_angle_d_speed;
-    int32_t d_speed_d_speed;
-    int32_t d_current_d_speed;
-    int32_t d_angle_d_current;
-    int32_t d_speed_d_current;
-    int32_t d_current_d_current;
-    int32_t d_angle_d_voltage;
-    int32_t d_speed_d_voltage;
-    int32_t d_current_d_voltage;
-    int32_t d_angle_d_torque;
-    int32_t d_speed_d_torque;
-    int32_t d_current_d_torque;
-    int32_t d_voltage_d_torque;
-    int32_t d_torque_d_voltage;
-    int32_t d_torque_d_speed;
-    int32_t d_torque_d_acceleration;
+    pbio_int_math_reciprocal_t d_angle_d_speed;
+    pbio_int_math_reciprocal_t d_speed_d_speed;
+    pbio_int_math_reciprocal_t d_current_d_speed;
+    pbio_int_math_reciprocal_t d_angle_d_current;
+    pbio_int_math_reciprocal_t d_speed_d_current;
+    pbio_int_math_reciprocal_t d_current_d_current;
+    pbio_int_math_reciprocal_t d_angle_d_voltage;
+    pbio_int_math_reciprocal_t d_speed_d_voltage;
+    pbio_int_math_reciprocal_t d_current_d_voltage;
+    pbio_int_math_reciprocal_t d_angle_d_torque;
+    pbio_int_math_reciprocal_t d_speed_d_torque;
+    pbio_int_math_reciprocal_t d_current_d_torque;
+    pbio_int_math_reciprocal_t d_voltage_d_torque;
+    pbio_int_math_reciprocal_t d_torque_d_voltage;
+    pbio_int_math_reciprocal_t d_torque_d_speed;
+    pbio_int_math_reciprocal_t d_torque_d_acceleration;
     int32_t torque_friction;
 } pbio_observer_model_t;
 
@@ -77,6 +77,12 @@ void pbio_os_timer_extend(pbio_os_timer_t *timer);
 
 bool pbio_os_timer_is_expired(pbio_os_timer_t *timer);
 
+bool pbio_os_timer_await(pbio_os_timer_t *timer);
+
+bool pbio_os_timer_get_next_deadline(uint32_t *deadline);
+
+void pbio_os_request_wakeup(uint32_t time);
+
 /**
  * Protothread state. Effectively the checkpoint (line number) in the current
  * file where it yields so it can jump there to resume later.
@@ -134,8 +140,53 @@ struct _pbio_os_process_t {
      * thread function to implement how to respond, if at all.
      */
     pbio_os_process_request_type_t request;
+    /**
+     * Whether this process runs only when it is polled directly or when the
+     * timer it awaits expires. If false, it also runs on every broadcast poll.
+     */
+    bool on_event;
+    /**
+     * Whether a poll request targeting this process is pending.
+     */
+    volatile bool poll_pending;
+    /**
+     * Pointer to the next process in the queue of processes to poll.
+     */
+    pbio_os_process_t *next_ready;
+    /**
+     * Pointer to the next process in the queue of processes awaiting a timer,
+     * sorted by ::wake_time.
+     */
+    pbio_os_process_t *next_wake;
+    /**
+     * Whether the process is in the timer queue.
+     */
+    bool wake_time_armed;
+    /**
+     * Whether the process awaited a timer during its most recent iteration.
+     */
+    bool wake_time_awaited;
+    /**
+     * Time at which the process should be polled if ::wake_time_armed is set.
+     */
+    uint32_t wake_time;
 };
 
+/**
+ * Event loop statistics.
+ */
+typedef struct {
+    /**
+     * Number of times a process thread was called.
+     */
+    uint32_t num_runs;
+    /**
+     * Number of times an event driven process was skipped on a broadcast poll
+     * because it had nothing to do.
+     */
+    uint32_t num_skipped;
+} pbio_os_stats_t;
+
 /**
  * Reset a protothread state back to the start.
  *
@@ -311,7 +362,7 @@ struct _pbio_os_process_t {
     do {                                              \
         pbio_os_timer_set(timer, duration);           \
         PBIO_OS_ASYNC_SET_CHECKPOINT(state);          \
-        if (!pbio_os_timer_is_expired(timer)) {       \
+        if (!pbio_os_timer_await(timer)) {            \
             return PBIO_ERROR_AGAIN;                  \
         }                                             \
     } while (0)                                       \
@@ -324,8 +375,14 @@ void pbio_os_run_processes_and_wait_for_event(void);
 
 void pbio_os_request_poll(void);
 
+void pbio_os_process_request_poll(pbio_os_process_t *process);
+
+const pbio_os_stats_t *pbio_os_get_stats(void);
+
 pbio_error_t pbio_port_process_none_thread(pbio_os_state_t *state, void *context);
 
 void pbio_os_process_start(pbio_os_process_t *process, pbio_os_process_func_t func, void *context);
 
+void pbio_os_process_start_on_event(pbio_os_process_t *process, pbio_os_process_func_t func, void *context);
+
 #endif // _PBIO_OS_H_
@@ -29,6 +29,20 @@ typedef struct {
     char name[LUMP_MAX_NAME_SIZE + 1];
 } pbio_port_lump_mode_info_t;
 
+/**
+ * Data sample received from a legodev device.
+ */
+typedef struct {
+    /**< Time at which the sample was received, in milliseconds. */
+    uint32_t time;
+    /**< The mode that produced this sample. */
+    uint8_t mode;
+    /**< Number of bytes of data. */
+    uint8_t size;
+    /**< Binary data, in the same format as for ::pbio_port_lump_get_data. */
+    uint8_t data[LUMP_MAX_MSG_SIZE] __attribute__((aligned(4)));
+} pbio_port_lump_sample_t;
+
 #if PBIO_CONFIG_PORT_LUMP
 
 pbio_port_lump_dev_t *pbio_port_lump_init_instance(uint8_t device_index);
@@ -39,6 +53,8 @@ pbio_error_t pbio_port_lump_data_send_thread(pbio_os_state_t *state, pbio_port_l
 
 pbio_error_t pbio_port_lump_data_recv_thread(pbio_os_state_t *state, pbio_port_lump_dev_t *lump_dev, pbdrv_uart_dev_t *uart_dev);
 
+void pbio_port_lump_get_rx_stats(pbio_port_lump_dev_t *lump_dev, uint32_t *resync_count, uint32_t *dropped_bytes);
+
 pbio_error_t pbio_port_lump_is_ready(pbio_port_lump_dev_t *lump_dev);
 
 pbio_error_t pbio_port_lump_set_mode(pbio_port_lump_dev_t *lump_dev, uint8_t mode);
@@ -114,6 +130,30 @@ static inline pbio_error_t pbio_port_lump_data_recv_thread(pbio_os_state_t *stat
     return PBIO_ERROR_NOT_SUPPORTED;
 }
 
+static inline void pbio_port_lump_get_rx_stats(pbio_port_lump_dev_t *lump_dev, uint32_t *resync_count, uint32_t *dropped_bytes) {
+    *resync_count = 0;
+    *dropped_bytes = 0;
+}
+
 #endif // PBIO_CONFIG_PORT_LUMP
 
+#if PBIO_CONFIG_PORT_LUMP && PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES
+
+uint32_t pbio_port_lump_get_sample_cursor(pbio_port_lump_dev_t *lump_dev);
+
+pbio_error_t pbio_port_lump_get_sample(pbio_port_lump_dev_t *lump_dev, uint32_t *cursor, const pbio_port_lump_sample_t **sample);
+
+#else // PBIO_CONFIG_PORT_LUMP && PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES
+
+static inline uint32_t pbio_port_lump_get_sample_cursor(pbio_port_lump_dev_t *lump_dev) {
+    return 0;
+}
+
+static inline pbio_error_t pbio_port_lump_get_sample(pbio_port_lump_dev_t *lump_dev, uint32_t *cursor, const pbio_port_lump_sample_t **sample) {
+    *sample = NULL;
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
+
+#endif // PBIO_CONFIG_PORT_LUMP && PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES
+
 #endif // _PBIO_PORT_LUMP_H_
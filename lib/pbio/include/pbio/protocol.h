@@ -193,6 +193,22 @@ typedef enum {
      * @since Pybricks Profile v1.4.0
      */
     PBIO_PYBRICKS_COMMAND_WRITE_APP_DATA = 7,
+
+    /**
+     * Requests to change how often a telemetry channel is sent.
+     *
+     * Parameters:
+     * - channel: The ::pbio_pybricks_telemetry_channel_t channel (8-bit unsigned integer).
+     * - interval: The interval in milliseconds, or 0 to unsubscribe (16-bit
+     *   little-endian unsigned integer).
+     *
+     * Errors:
+     * - ::PBIO_PYBRICKS_ERROR_VALUE_NOT_ALLOWED if the channel does not exist.
+     * - ::PBIO_PYBRICKS_ERROR_INVALID_COMMAND if the hub has no telemetry.
+     *
+     * @since Unreleased. Should not be considered final.
+     */
+    PBIO_PYBRICKS_COMMAND_SET_TELEMETRY_INTERVAL = 8,
 } pbio_pybricks_command_t;
 /**
  * Application-specific error codes that are used in ATT_ERROR_RSP.
@@ -265,20 +281,95 @@ typedef enum {
     /**
      * Telemetry data sent from the hub to the host.
      *
-     * The payload is a variable number of bytes that was written to app data.
+     * The payload is one or more samples. Each sample is the channel
+     * (::pbio_pybricks_telemetry_channel_t, 8-bit unsigned integer), the
+     * index within that channel (8-bit unsigned integer), and the value as a
+     * zigzag encoded variable length integer of 1 to 5 bytes. See
+     * ::pbio_set_varint_zigzag for the value encoding.
      *
-     * Pybricks profile version defines exact encoding of this data.
+     * Samples are only sent when the value changed. All changed values are
+     * batched into as few events as possible.
      *
      * @since Unreleased. Should not be considered final.
      */
     PBIO_PYBRICKS_EVENT_WRITE_TELEMETRY = 3,
 
+    /**
+     * Binary log data sent from the hub to the host.
+     *
+     * The payload is a variable number of bytes of a binary log export. The
+     * bytes of one export are sent in order, starting with a header. See
+     * ::pbio_logger_binary_encode_header for the encoding.
+     *
+     * Streamed logs are sent as text instead. These start with a line
+     * ``PB_OF:<path>``, followed by one line of comma separated values per
+     * row and a final ``PB_EOF`` line. These never start with the magic
+     * bytes of a binary export.
+     *
+     * @since Unreleased. Should not be considered final.
+     */
+    PBIO_PYBRICKS_EVENT_WRITE_LOG = 4,
+
     /**
      * The total number of events that can be queued and sent.
      */
     PBIO_PYBRICKS_EVENT_NUM_EVENTS,
 } pbio_pybricks_event_t;
 
+/**
+ * Telemetry channels.
+ *
+ * The host selects the channels it is interested in and how often they are
+ * sent using ::PBIO_PYBRICKS_COMMAND_SET_TELEMETRY_INTERVAL.
+ *
+ * @since Unreleased. Should not be considered final.
+ */
+typedef enum {
+    /**
+     * Type identifier of the device attached to a port. Index is the port index.
+     */
+    PBIO_PYBRICKS_TELEMETRY_CHANNEL_DEVICE_TYPE = 0,
+    /**
+     * Motor angle in degrees. Index is the port index.
+     */
+    PBIO_PYBRICKS_TELEMETRY_CHANNEL_MOTOR_ANGLE = 1,
+    /**
+     * Motor speed in degrees per second. Index is the port index.
+     */
+    PBIO_PYBRICKS_TELEMETRY_CHANNEL_MOTOR_SPEED = 2,
+    /**
+     * Estimated motor load in mNm. Index is the port index.
+     */
+    PBIO_PYBRICKS_TELEMETRY_CHANNEL_MOTOR_LOAD = 3,
+    /**
+     * First value of the active mode of a sensor. Floating point values are
+     * multiplied by 1000. Index is the port index.
+     */
+    PBIO_PYBRICKS_TELEMETRY_CHANNEL_SENSOR_VALUE = 4,
+    /**
+     * Drive base distance in mm. Index is the drive base index.
+     */
+    PBIO_PYBRICKS_TELEMETRY_CHANNEL_DRIVEBASE_DISTANCE = 5,
+    /**
+     * Drive base angle in degrees. Index is the drive base index.
+     */
+    PBIO_PYBRICKS_TELEMETRY_CHANNEL_DRIVEBASE_ANGLE = 6,
+    /**
+     * Hub heading in millidegrees. Index is always 0.
+     */
+    PBIO_PYBRICKS_TELEMETRY_CHANNEL_IMU_HEADING = 7,
+    /**
+     * Motor control loop timing. Index 0 is the number of missed control
+     * ticks, index 1 the maximum execution time in us and index 2 the
+     * maximum latency in us.
+     */
+    PBIO_PYBRICKS_TELEMETRY_CHANNEL_MOTOR_LOOP = 8,
+    /**
+     * The number of telemetry channels.
+     */
+    PBIO_PYBRICKS_TELEMETRY_NUM_CHANNELS,
+} pbio_pybricks_telemetry_channel_t;
+
 /**
  * Hub status indicators.
  *
@@ -40,6 +40,9 @@
 /** Number of values per row when servo data logger is active. */
 #define PBIO_SERVO_LOGGER_NUM_COLS (10)
 
+/** Names and scales of the values per row when servo data logger is active. */
+extern const pbio_logger_column_t pbio_servo_logger_columns[PBIO_SERVO_LOGGER_NUM_COLS];
+
 /**
  * The servo system combines a dcmotor and rotation sensor with a controller
  * to provide speed and position control.
@@ -164,6 +167,7 @@ pbio_error_t pbio_servo_run_time(pbio_servo_t *srv, int32_t speed, uint32_t dura
 pbio_error_t pbio_servo_run_until_stalled(pbio_servo_t *srv, int32_t speed, int32_t torque_limit, pbio_control_on_completion_t on_completion);
 pbio_error_t pbio_servo_run_angle(pbio_servo_t *srv, int32_t speed, int32_t angle, pbio_control_on_completion_t on_completion);
 pbio_error_t pbio_servo_run_target(pbio_servo_t *srv, int32_t speed, int32_t target, pbio_control_on_completion_t on_completion);
+pbio_error_t pbio_servo_queue_angle(pbio_servo_t *srv, int32_t speed, int32_t angle, pbio_control_on_completion_t on_completion);
 pbio_error_t pbio_servo_track_target(pbio_servo_t *srv, int32_t target);
 /**@}*/
 
@@ -14,6 +14,7 @@
 #ifndef _PBIO_TRAJECTORY_H_
 #define _PBIO_TRAJECTORY_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <pbio/angle.h>
@@ -28,6 +29,12 @@
 // acceleration part of the maneuver.
 #define PBIO_TRAJECTORY_DURATION_FOREVER_MS (5 * 60 * 1000)
 
+// Acceleration phases can be smoothed into an S-curve. This is the percentage
+// of each acceleration phase during which the acceleration ramps up or down.
+// At 0, the profile is trapezoidal. At the maximum, the acceleration ramps
+// up and down linearly without a constant acceleration part.
+#define PBIO_TRAJECTORY_SMOOTHING_MAX (100)
+
 /**
  * Minimal set of trajectory parameters from which a full trajectory is
  * calculated. All values in control units and time in ticks.
@@ -42,6 +49,7 @@ typedef struct _pbio_trajectory_command_t {
     int32_t speed_max;             /**<  Max target rate target */
     int32_t acceleration;          /**<  Encoder acceleration magnitude during in-phase */
     int32_t deceleration;          /**<  Encoder acceleration magnitude during out-phase */
+    int32_t smoothing;             /**<  Percentage of acceleration phases with changing acceleration (0 for trapezoid) */
     bool continue_running;         /**<  Whether it movement continues after t3 (true) or not (false) */
 } pbio_trajectory_command_t;
 
@@ -55,6 +63,26 @@ typedef struct _pbio_trajectory_reference_t {
     int32_t acceleration;   /**<  Reference acceleration */
 } pbio_trajectory_reference_t;
 
+/**
+ * Incremental evaluation state of a trajectory.
+ *
+ * The reference in each segment is a sum of truncated products of time. The
+ * quotient and remainder of each product are stored, so that the next sample
+ * can be found by adding increments instead of dividing again. This is only
+ * used internally by ::pbio_trajectory_get_reference.
+ */
+typedef struct _pbio_trajectory_cache_t {
+    bool valid;                          /**<  Whether the state matches the trajectory parameters. */
+    uint8_t segment;                     /**<  Segment index (0 to 3) that the state applies to. */
+    int32_t time;                        /**<  Time since the start of the segment. */
+    int32_t wq;                          /**<  Quotient of a * time / 1000, the speed gained in this segment. */
+    int32_t wr;                          /**<  Remainder of a * time / 1000. */
+    int32_t thq;                         /**<  Quotient of w * time / 100, the angle from the segment start speed. */
+    int32_t thr;                         /**<  Remainder of w * time / 100. */
+    int32_t th2q;                        /**<  Quotient of speed gain * time / 200, the angle from accelerating. */
+    int32_t th2r;                        /**<  Remainder of speed gain * time / 200. */
+} pbio_trajectory_cache_t;
+
 /**
  * Complete set of motor trajectory parameters for an ideal maneuver without
  * disturbances. These values have custom units to keep them within safe
@@ -73,14 +101,17 @@ typedef struct _pbio_trajectory_t {
     int32_t w0;                          /**<  Encoder rate at start of maneuver */
     int32_t w1;                          /**<  Encoder rate target when not accelerating */
     int32_t w3;                          /**<  Encoder rate target after the maneuver ends */
-    int32_t a0;                          /**<  Encoder acceleration during in-phase */
-    int32_t a2;                          /**<  Encoder acceleration during out-phase */
+    int32_t a0;                          /**<  Encoder acceleration during in-phase, on average if smoothed */
+    int32_t a2;                          /**<  Encoder acceleration during out-phase, on average if smoothed */
+    int32_t smoothing;                   /**<  Percentage of in-phase and out-phase with changing acceleration */
+    pbio_trajectory_cache_t cache;       /**<  State for evaluating successive samples */
 } pbio_trajectory_t;
 
 // Make or modify trajectories:
 
 pbio_error_t pbio_trajectory_validate_speed_limit(int32_t ctl_steps_per_app_step, int32_t speed);
 pbio_error_t pbio_trajectory_validate_acceleration_limit(int32_t ctl_steps_per_app_step, int32_t acceleration);
+pbio_error_t pbio_trajectory_validate_smoothing(int32_t smoothing);
 pbio_error_t pbio_trajectory_new_angle_command(pbio_trajectory_t *trj, const pbio_trajectory_command_t *command);
 pbio_error_t pbio_trajectory_new_time_command(pbio_trajectory_t *trj, const pbio_trajectory_command_t *command);
 void pbio_trajectory_make_constant(pbio_trajectory_t *trj, const pbio_trajectory_command_t *command);
@@ -93,6 +124,7 @@ int32_t pbio_trajectory_get_abs_command_speed(const pbio_trajectory_t *trj);
 void pbio_trajectory_get_endpoint(const pbio_trajectory_t *trj, pbio_trajectory_reference_t *end);
 void pbio_trajectory_get_last_vertex(const pbio_trajectory_t *trj, uint32_t time_ref, pbio_trajectory_reference_t *vertex);
 void pbio_trajectory_get_reference(pbio_trajectory_t *trj, uint32_t time_ref, pbio_trajectory_reference_t *ref);
+void pbio_trajectory_get_reference_uncached(const pbio_trajectory_t *trj, uint32_t time_ref, pbio_trajectory_reference_t *ref);
 
 #endif // _PBIO_TRAJECTORY_H_
 
@@ -118,6 +118,35 @@ void pbio_set_uint32_be(uint8_t *buf, uint32_t value) {
     buf[3] = value;
 }
 
+/** Maximum size of a value packed by ::pbio_set_varint_zigzag. */
+#define PBIO_VARINT_ZIGZAG_MAX_SIZE (5)
+
+#ifndef DOXYGEN
+static inline
+#endif
+/**
+ * Packs signed 32-bit value into buffer as a variable length integer.
+ *
+ * The value is zigzag encoded so small negative numbers stay small, and then
+ * written 7 bits at a time, least significant group first, with the most
+ * significant bit set on all but the last byte.
+ *
+ * @param [in]  buf     The buffer, at least ::PBIO_VARINT_ZIGZAG_MAX_SIZE bytes.
+ * @param [in]  value   The value.
+ * @return              The number of bytes written.
+ */
+uint8_t pbio_set_varint_zigzag(uint8_t *buf, int32_t value) {
+    // 0, -1, 1, -2, 2, ... becomes 0, 1, 2, 3, 4, ...
+    uint32_t zigzag = ((uint32_t)value << 1) ^ (value < 0 ? UINT32_MAX : 0);
+    uint8_t size = 0;
+    while (zigzag >= 0x80) {
+        buf[size++] = (zigzag & 0x7f) | 0x80;
+        zigzag >>= 7;
+    }
+    buf[size++] = zigzag;
+    return size;
+}
+
 void pbio_uuid128_le_copy(uint8_t *dst, const uint8_t *src);
 bool pbio_uuid128_reverse_compare(const uint8_t *uuid1, const uint8_t *uuid2);
 void pbio_uuid128_reverse_copy(uint8_t *dst, const uint8_t *src);
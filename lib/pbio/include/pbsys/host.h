@@ -38,6 +38,7 @@ pbio_error_t pbsys_host_stdin_read(uint8_t *data, uint32_t *size);
 pbio_error_t pbsys_host_stdout_write(const uint8_t *data, uint32_t *size);
 bool pbsys_host_tx_is_idle(void);
 pbio_error_t pbsys_host_send_event(pbio_os_state_t *state, pbio_pybricks_event_t event_type, const uint8_t *data, size_t size);
+uint32_t pbsys_host_get_event_size_max(void);
 
 #else // PBSYS_CONFIG_HOST
 
@@ -56,6 +57,9 @@ pbio_error_t pbsys_host_send_event(pbio_os_state_t *state, pbio_pybricks_event_t
 static inline pbio_error_t pbsys_host_send_event(pbio_os_state_t *state, pbio_pybricks_event_t event_type, const uint8_t *data, size_t size) {
     return PBIO_ERROR_NOT_SUPPORTED;
 }
+static inline uint32_t pbsys_host_get_event_size_max(void) {
+    return 0;
+}
 
 #endif // PBSYS_CONFIG_HOST
 
@@ -45,13 +45,14 @@ typedef enum {
  */
 typedef struct _pbsys_main_program_t {
     /**
-     * Starting address of the user code.
+     * Starting address of the user code. This is in user RAM or in memory
+     * mapped storage, so it must not be modified.
      */
-    void *code_start;
+    const void *code_start;
     /**
      * Ending address of the user code (up until this, so excluding this address).
      */
-    void *code_end;
+    const void *code_end;
     /**
      * Starting address of user RAM.
      */
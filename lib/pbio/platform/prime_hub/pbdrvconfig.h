@@ -29,6 +29,8 @@
 #define PBDRV_CONFIG_BLUETOOTH_NUM_CLASSIC_CONNECTIONS (2)
 #define PBDRV_CONFIG_BLUETOOTH_NUM_PERIPHERALS      (2)
 #define PBDRV_CONFIG_BLUETOOTH_MAX_MTU_SIZE         515
+#define PBDRV_CONFIG_BLUETOOTH_STDOUT_BUF_SIZE      2048
+#define PBDRV_CONFIG_BLUETOOTH_NUM_EVENT_SLOTS      4
 #define PBDRV_CONFIG_BLUETOOTH_BTSTACK              (1)
 #define PBDRV_CONFIG_BLUETOOTH_BTSTACK_LE_SERVER    (1)
 #define PBDRV_CONFIG_BLUETOOTH_BTSTACK_STM32        (1)
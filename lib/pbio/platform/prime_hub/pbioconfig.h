@@ -11,6 +11,7 @@
 #define PBIO_CONFIG_LIGHT_MATRIX            (1)
 #define PBIO_CONFIG_LIGHT_MATRIX_NUM_DEV    (1)
 #define PBIO_CONFIG_MOTOR_PROCESS           (1)
+#define PBIO_CONFIG_MOTOR_PROCESS_STATS     (1)
 #define PBIO_CONFIG_PORT                    (1)
 #define PBIO_CONFIG_PORT_NUM_DEV            (6)
 #define PBIO_CONFIG_PORT_DCM                (1)
@@ -20,6 +21,7 @@
 #define PBIO_CONFIG_PORT_LUMP               (1)
 #define PBIO_CONFIG_PORT_LUMP_MODE_INFO     (1)
 #define PBIO_CONFIG_PORT_LUMP_NUM_DEV       (PBIO_CONFIG_PORT_NUM_DEV)
+#define PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES   (4)
 #define PBIO_CONFIG_SERVO                   (1)
 #define PBIO_CONFIG_SERVO_NUM_DEV           (6)
 #define PBIO_CONFIG_SERVO_EV3_NXT           (0)
@@ -9,6 +9,9 @@
 
 #define PBDRV_CONFIG_BLUETOOTH                              (1)
 #define PBDRV_CONFIG_BLUETOOTH_NUM_PERIPHERALS              (1)
+#define PBDRV_CONFIG_BLUETOOTH_NUM_EVENT_SLOTS              (4)
+#define PBDRV_CONFIG_BLUETOOTH_MAX_MTU_SIZE                 (515)
+#define PBDRV_CONFIG_BLUETOOTH_STDOUT_BUF_SIZE              (512)
 #define PBDRV_CONFIG_BLUETOOTH_BTSTACK                      (1)
 #define PBDRV_CONFIG_BLUETOOTH_BTSTACK_LE_SERVER            (1)
 #define PBDRV_CONFIG_BLUETOOTH_BTSTACK_CC2564C              (1)
@@ -4,7 +4,6 @@ import socket
 import threading
 import queue
 from pathlib import Path
-import struct
 
 IMG_PATH = Path("lib/pbio/test/animator/img")
 HOST = "127.0.0.1"
@@ -24,6 +23,21 @@ PBIO_PYBRICKS_EVENT_WRITE_STDOUT = 1
 PBIO_PYBRICKS_EVENT_WRITE_APP_DATA = 2
 PBIO_PYBRICKS_EVENT_WRITE_TELEMETRY = 3
 
+# Telemetry channels, see pbio_pybricks_telemetry_channel_t.
+TELEMETRY_CHANNELS = (
+    "device_type",
+    "motor_angle",
+    "motor_speed",
+    "motor_load",
+    "sensor_value",
+    "drivebase_distance",
+    "drivebase_angle",
+    "imu_heading",
+    "motor_loop",
+)
+TELEMETRY_CHANNEL_MOTOR_ANGLE = 1
+TELEMETRY_CHANNEL_MOTOR_LOOP = 8
+
 # Incoming events (stdout, status, app data, port view)
 data_queue = queue.Queue()
 
@@ -42,6 +56,7 @@ def socket_listener_thread():
 
 # Hub state
 angles = [0] * 6
+telemetry = {}
 virtual_display = pygame.Surface((DISPLAY_WIDTH, DISPLAY_HEIGHT))
 display_color = [0x90, 0xC5, 0xAD]
 virtual_display.fill(display_color)
@@ -58,12 +73,31 @@ def update_display(data):
                 virtual_display.set_at((x, y), color)
 
 
+def read_varint_zigzag(payload, offset):
+    value = 0
+    shift = 0
+    while True:
+        byte = payload[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return (value >> 1) ^ -(value & 1), offset
+
+
 def process_telemetry(payload):
-    # Only supports motors for now.
-    if len(payload) == 6:
-        type_id, index, angle = struct.unpack("<bbi", payload[0:6])
-        if type_id == 94:  # REVISIT: Align with firmware
-            angles[index] = angle
+    # Each sample is channel, index, and a variable length value.
+    offset = 0
+    while offset + 2 < len(payload):
+        channel, index = payload[offset], payload[offset + 1]
+        value, offset = read_varint_zigzag(payload, offset + 2)
+        telemetry[(channel, index)] = value
+
+        if channel == TELEMETRY_CHANNEL_MOTOR_ANGLE and index < len(angles):
+            angles[index] = value
+        elif channel == TELEMETRY_CHANNEL_MOTOR_LOOP:
+            name = ("missed", "exec_time_max", "latency_max")[index]
+            print(f"Motor loop {name}: {value}")
 
 
 def update_state():
@@ -128,6 +162,8 @@ def main():
         DISPLAY_HEIGHT * DISPLAY_SCALE + 4,
     )
 
+    font = pygame.font.SysFont(None, 24)
+
     # Start the socket listener thread
     threading.Thread(target=socket_listener_thread, daemon=True).start()
 
@@ -160,6 +196,16 @@ def main():
         )
         screen.blit(scaled_surface, DISPLAY_POS)
 
+        # Show other telemetry values as text.
+        y = DISPLAY_POS[1] + DISPLAY_HEIGHT * DISPLAY_SCALE + 20
+        for (channel, index), value in sorted(telemetry.items()):
+            if channel in (TELEMETRY_CHANNEL_MOTOR_ANGLE, TELEMETRY_CHANNEL_MOTOR_LOOP):
+                continue
+            name = TELEMETRY_CHANNELS[channel] if channel < len(TELEMETRY_CHANNELS) else channel
+            text = font.render(f"{name}[{index}]: {value}", True, (0, 0, 0))
+            screen.blit(text, (DISPLAY_POS[0], y))
+            y += 24
+
         # Update display
         pygame.display.flip()
         clock.tick(FPS)
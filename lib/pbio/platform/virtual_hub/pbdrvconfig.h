@@ -22,11 +22,15 @@
 #define PBDRV_CONFIG_BUTTON                                 (1)
 #define PBDRV_CONFIG_BUTTON_TEST                            (1)
 
+// CI uses a counting clock. The virtual clock of the local build can also be
+// tested on CI, which is selected with PBDRV_CONFIG_RUN_ON_CI_VIRTUAL_CLOCK.
 #define PBDRV_CONFIG_CLOCK                                  (1)
-#ifdef PBDRV_CONFIG_RUN_ON_CI
+#if defined(PBDRV_CONFIG_RUN_ON_CI) && !defined(PBDRV_CONFIG_RUN_ON_CI_VIRTUAL_CLOCK)
 #define PBDRV_CONFIG_CLOCK_TEST                             (1)
 #else
 #define PBDRV_CONFIG_CLOCK_LINUX                            (1)
+#define PBDRV_CONFIG_CLOCK_LINUX_TICKLESS                   (1)
+#define PBDRV_CONFIG_CLOCK_LINUX_VIRTUAL                    (1)
 #endif
 
 #define PBDRV_CONFIG_COUNTER                                (1)
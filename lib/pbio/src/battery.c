@@ -84,7 +84,7 @@ static pbio_error_t pbio_battery_process_thread(pbio_os_state_t *state, void *co
     pbio_os_timer_set(&timer, PBIO_CONFIG_CONTROL_LOOP_TIME_MS);
 
     for (;;) {
-        PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_is_expired(&timer));
+        PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_await(&timer));
 
         uint16_t battery_voltage_now_mv;
         pbdrv_battery_get_voltage_now(&battery_voltage_now_mv);
@@ -113,7 +113,7 @@ void pbio_battery_init(void) {
     // Initialize average upscaled voltage.
     battery_voltage_avg_scaled = (int32_t)battery_voltage_now_mv * SCALE;
 
-    pbio_os_process_start(&pbio_battery_process, pbio_battery_process_thread, NULL);
+    pbio_os_process_start_on_event(&pbio_battery_process, pbio_battery_process_thread, NULL);
 }
 
 #endif // PBIO_CONFIG_BATTERY
@@ -16,6 +16,24 @@
 #include <pbio/integrator.h>
 #include <pbio/util.h>
 
+#if PBIO_CONFIG_LOGGER
+// Names and scales of the values logged in pbio_control_update.
+const pbio_logger_column_t pbio_control_logger_columns[PBIO_CONTROL_LOGGER_NUM_COLS] = {
+    { .name = "trajectory_time", .scale = 10000 },
+    { .name = "position", .scale = 1 },
+    { .name = "speed", .scale = 1 },
+    { .name = "actuation", .scale = 1 },
+    { .name = "payload", .scale = 1 },
+    { .name = "position_ref", .scale = 1 },
+    { .name = "speed_ref", .scale = 1 },
+    { .name = "position_est", .scale = 1 },
+    { .name = "speed_est", .scale = 1 },
+    { .name = "torque_p", .scale = 1000000 },
+    { .name = "torque_i", .scale = 1000000 },
+    { .name = "torque_d", .scale = 1000000 },
+};
+#endif // PBIO_CONFIG_LOGGER
+
 /**
  * Gets the wall time in control unit time ticks (1e-4 seconds).
  *
@@ -423,6 +441,7 @@ void pbio_control_update(
  */
 void pbio_control_stop(pbio_control_t *ctl) {
     ctl->type = PBIO_CONTROL_TYPE_NONE;
+    ctl->queue.count = 0;
     pbio_control_status_set(ctl, PBIO_CONTROL_STATUS_COMPLETE, true);
     pbio_control_status_set(ctl, PBIO_CONTROL_STATUS_STALLED, false);
     ctl->pid_average = 0;
@@ -506,6 +525,7 @@ static pbio_error_t _pbio_control_start_position_control(pbio_control_t *ctl, ui
         .speed_max = ctl->settings.speed_max,
         .acceleration = ctl->settings.acceleration,
         .deceleration = ctl->settings.deceleration,
+        .smoothing = ctl->settings.smoothing,
         .continue_running = on_completion == PBIO_CONTROL_ON_COMPLETION_CONTINUE,
     };
 
@@ -599,6 +619,9 @@ static pbio_error_t _pbio_control_start_position_control(pbio_control_t *ctl, ui
  */
 pbio_error_t pbio_control_start_position_control(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, int32_t position, int32_t speed, pbio_control_on_completion_t on_completion) {
 
+    // New commands replace any queued maneuvers.
+    ctl->queue.count = 0;
+
     // Convert target position to control units.
     pbio_angle_t target;
     pbio_control_settings_app_to_ctl_long(&ctl->settings, position, &target);
@@ -626,6 +649,9 @@ pbio_error_t pbio_control_start_position_control(pbio_control_t *ctl, uint32_t t
  */
 pbio_error_t pbio_control_start_position_control_relative(pbio_control_t *ctl, uint32_t time_now, const pbio_control_state_t *state, int32_t distance, int32_t speed, pbio_control_on_completion_t on_completion, bool allow_trajectory_shift) {
 
+    // New commands replace any queued maneuvers.
+    ctl->queue.count = 0;
+
     // Convert distance to control units.
     pbio_angle_t increment;
     pbio_control_settings_app_to_ctl_long(&ctl->settings, (speed < 0 ? -distance : distance), &increment);
@@ -675,6 +701,9 @@ pbio_error_t pbio_control_start_position_control_relative(pbio_control_t *ctl, u
  */
 pbio_error_t pbio_control_start_position_control_hold(pbio_control_t *ctl, uint32_t time_now, int32_t position) {
 
+    // New commands replace any queued maneuvers.
+    ctl->queue.count = 0;
+
     // Compute new maneuver based on user argument, starting from the initial state
     pbio_trajectory_command_t command = {
         .time_start = pbio_control_get_ref_time(ctl, time_now),
@@ -708,6 +737,9 @@ pbio_error_t pbio_control_start_timed_control(pbio_control_t *ctl, uint32_t time
 
     pbio_error_t err;
 
+    // New commands replace any queued maneuvers.
+    ctl->queue.count = 0;
+
     // For timed maneuvers, being "smart" by remembering the position endpoint
     // does nothing useful, so discard it to keep only the passive actuation type.
     on_completion = pbio_control_on_completion_discard_smart(on_completion);
@@ -720,6 +752,7 @@ pbio_error_t pbio_control_start_timed_control(pbio_control_t *ctl, uint32_t time
         .speed_max = ctl->settings.speed_max,
         .acceleration = ctl->settings.acceleration,
         .deceleration = ctl->settings.deceleration,
+        .smoothing = ctl->settings.smoothing,
         .continue_running = on_completion == PBIO_CONTROL_ON_COMPLETION_CONTINUE,
     };
 
@@ -790,7 +823,136 @@ pbio_error_t pbio_control_start_timed_control(pbio_control_t *ctl, uint32_t time
     return PBIO_SUCCESS;
 }
 
+/**
+ * Queues a relative position maneuver to start when the ongoing position
+ * maneuver ends.
+ *
+ * The queued maneuver starts at the endpoint of the ongoing trajectory, so
+ * position and speed are continuous and the transition happens in the very
+ * control update in which the ongoing trajectory ends.
+ *
+ * @param [in]  ctl            The control instance.
+ * @param [in]  distance       The distance to run by (application units), relative to the end of the previous maneuver.
+ * @param [in]  speed          The top speed (application units). Negative speed flips the distance sign. If zero, default speed is used.
+ * @param [in]  on_completion  What to do when reaching the end of this maneuver.
+ * @return                     ::PBIO_ERROR_INVALID_OP if position control is not active,
+ *                             ::PBIO_ERROR_BUSY if the queue is full, otherwise ::PBIO_SUCCESS.
+ */
+pbio_error_t pbio_control_queue_position_control_relative(pbio_control_t *ctl, int32_t distance, int32_t speed, pbio_control_on_completion_t on_completion) {
+
+    // Only position maneuvers have a well defined endpoint to continue from.
+    if (!pbio_control_type_is_position(ctl)) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    pbio_control_queue_t *queue = &ctl->queue;
+    if (queue->count == PBIO_CONFIG_CONTROL_QUEUE_SIZE) {
+        return PBIO_ERROR_BUSY;
+    }
+
+    queue->segments[(queue->first + queue->count) % PBIO_CONFIG_CONTROL_QUEUE_SIZE] = (pbio_control_segment_t) {
+        .distance = distance,
+        .speed = speed,
+        .on_completion = on_completion,
+    };
+    queue->count++;
+
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Checks if a new maneuver should be queued instead of started right away.
+ *
+ * A maneuver can follow up on a position trajectory that has not ended yet,
+ * or on maneuvers that are already queued. Once the trajectory has ended, for
+ * example when holding at the target, its endpoint lies in the past, so a new
+ * maneuver must start from where the reference is now instead.
+ *
+ * @param [in]  ctl             The control instance.
+ * @param [in]  time_now        The wall time (ticks).
+ * @return                      True if the maneuver should be queued.
+ */
+bool pbio_control_queue_is_open(const pbio_control_t *ctl, uint32_t time_now) {
+
+    if (!pbio_control_type_is_position(ctl)) {
+        return false;
+    }
+
+    if (ctl->queue.count > 0) {
+        return true;
+    }
+
+    return !pbio_util_time_has_passed(pbio_control_get_ref_time(ctl, time_now), ctl->trajectory.start.time + pbio_trajectory_get_duration(&ctl->trajectory));
+}
+
+/**
+ * Checks if the ongoing maneuver has ended and a queued one should start.
+ *
+ * @param [in]  ctl             The control instance.
+ * @param [in]  time_now        The wall time (ticks).
+ * @return                      True if a queued maneuver should start now.
+ */
+bool pbio_control_queue_is_due(const pbio_control_t *ctl, uint32_t time_now) {
+
+    if (ctl->queue.count == 0 || !pbio_control_type_is_position(ctl)) {
+        return false;
+    }
+
+    return pbio_util_time_has_passed(pbio_control_get_ref_time(ctl, time_now), ctl->trajectory.start.time + pbio_trajectory_get_duration(&ctl->trajectory));
+}
 
+/**
+ * Starts the next queued maneuver from the endpoint of the ongoing one.
+ *
+ * @param [in]  ctl             The control instance.
+ * @param [in]  time_now        The wall time (ticks).
+ * @return                      Error code.
+ */
+pbio_error_t pbio_control_queue_start_next(pbio_control_t *ctl, uint32_t time_now) {
+
+    pbio_control_queue_t *queue = &ctl->queue;
+    if (queue->count == 0 || !pbio_control_type_is_position(ctl)) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    pbio_control_segment_t *segment = &queue->segments[queue->first];
+    queue->first = (queue->first + 1) % PBIO_CONFIG_CONTROL_QUEUE_SIZE;
+    queue->count--;
+
+    // Branch off exactly where the ongoing trajectory ends, regardless of
+    // where the reference is now. This way the time, position, and speed
+    // are continuous across segments.
+    pbio_trajectory_reference_t end;
+    pbio_trajectory_get_endpoint(&ctl->trajectory, &end);
+
+    int32_t speed = pbio_control_settings_app_to_ctl(&ctl->settings, segment->speed);
+    pbio_angle_t increment;
+    pbio_control_settings_app_to_ctl_long(&ctl->settings, segment->speed < 0 ? -segment->distance : segment->distance, &increment);
+
+    pbio_trajectory_command_t command = {
+        .time_start = end.time,
+        .position_start = end.position,
+        .speed_start = end.speed,
+        .speed_target = speed == 0 ? ctl->settings.speed_default : speed,
+        .speed_max = ctl->settings.speed_max,
+        .acceleration = ctl->settings.acceleration,
+        .deceleration = ctl->settings.deceleration,
+        .smoothing = ctl->settings.smoothing,
+        .continue_running = segment->on_completion == PBIO_CONTROL_ON_COMPLETION_CONTINUE,
+    };
+    pbio_angle_sum(&end.position, &increment, &command.position_end);
+
+    pbio_error_t err = pbio_trajectory_new_angle_command(&ctl->trajectory, &command);
+    if (err != PBIO_SUCCESS) {
+        ctl->queue.count = 0;
+        return err;
+    }
+
+    // Position control is already active, so this keeps the integrators.
+    pbio_control_set_control_type(ctl, time_now, PBIO_CONTROL_TYPE_POSITION, segment->on_completion);
+
+    return PBIO_SUCCESS;
+}
 
 /**
  * Gets the time at which to evaluate the reference trajectory by compensating
@@ -866,11 +1028,12 @@ bool pbio_control_is_stalled(const pbio_control_t *ctl, uint32_t *stall_duration
 /**
  * Checks if the controller is done.
  *
- * For trajectories with a stationary endpoint, done means on target.
+ * For trajectories with a stationary endpoint, done means on target. If
+ * maneuvers are queued, the controller is not done until the last one is.
  *
  * @param [in]  ctl             The control instance.
  * @return                      True if the controller is done, false if not.
  */
 bool pbio_control_is_done(const pbio_control_t *ctl) {
-    return !pbio_control_is_active(ctl) || pbio_control_status_test(ctl, PBIO_CONTROL_STATUS_COMPLETE);
+    return !pbio_control_is_active(ctl) || (pbio_control_status_test(ctl, PBIO_CONTROL_STATUS_COMPLETE) && ctl->queue.count == 0);
 }
@@ -209,6 +209,34 @@ pbio_error_t pbio_control_settings_set_trajectory_limits(pbio_control_settings_t
     return PBIO_SUCCESS;
 }
 
+/**
+ * Gets the smoothing of the acceleration phases.
+ *
+ * @param [in]  s             Control settings structure from which to read.
+ * @return                    Percentage of acceleration phases with changing acceleration.
+ */
+int32_t pbio_control_settings_get_trajectory_smoothing(const pbio_control_settings_t *s) {
+    return s->smoothing;
+}
+
+/**
+ * Sets the smoothing of the acceleration phases.
+ *
+ * @param [in] s              Control settings structure to modify.
+ * @param [in] smoothing      Percentage of acceleration phases with changing acceleration.
+ *                            Zero gives a trapezoidal speed profile.
+ * @return                    ::PBIO_SUCCESS on success
+ *                            ::PBIO_ERROR_INVALID_ARG if the value is out of range.
+ */
+pbio_error_t pbio_control_settings_set_trajectory_smoothing(pbio_control_settings_t *s, int32_t smoothing) {
+    pbio_error_t err = pbio_trajectory_validate_smoothing(smoothing);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+    s->smoothing = smoothing;
+    return PBIO_SUCCESS;
+}
+
 /**
  * Gets the control limits for actuation, in application units.
  *
@@ -14,21 +14,40 @@
 #include <pbio/int_math.h>
 #include <pbio/util.h>
 
+/**
+ * Adds an offset to a ring buffer index and wraps it around.
+ *
+ * @param [in]  index          Index plus offset. Must be less than twice the buffer size.
+ * @return                     Index within the buffer.
+ */
+static inline uint8_t pbio_differentiator_wrap(uint32_t index) {
+    #if (PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE & (PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE - 1)) == 0
+    return index & (PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE - 1);
+    #else
+    return index >= PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE ? index - PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE : index;
+    #endif
+}
+
 /**
  * Internal function to get the speed with a variable window size. Window
  * size must be validated externally for this function to be used safely.
  *
  * @param [in]  dif            The differentiator instance.
- * @param [in]  window_size    Window size in number of samples (Must be > 0 and <= buffer size!).
- * @param [out] speed          Average speed across given time window in mdeg/s.
+ * @param [in]  window_size    Window size in number of samples (Must be > 0 and < buffer size!).
+ * @return                     Average speed across given time window in mdeg/s.
  */
 static int32_t pbio_differentiator_calc_speed(pbio_differentiator_t *dif, uint8_t window_size) {
 
-    // Sum differences including start and endpoint.
-    uint8_t start_index = (dif->index - (window_size - 1) + PBIO_ARRAY_SIZE(dif->history)) % PBIO_ARRAY_SIZE(dif->history);
-    int32_t total = dif->history[dif->index];
-    for (uint8_t i = start_index; i != dif->index; i = (i + 1) % PBIO_ARRAY_SIZE(dif->history)) {
-        total += dif->history[i];
+    // The default window is kept as a running sum, so only other window sizes
+    // have to sum the differences including start and endpoint.
+    int32_t total = dif->window_sum;
+    if (window_size != PBIO_CONFIG_DIFFERENTIATOR_WINDOW_SIZE) {
+        total = 0;
+        uint8_t i = pbio_differentiator_wrap(dif->index + PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE - window_size);
+        while (i != dif->index) {
+            i = pbio_differentiator_wrap(i + 1);
+            total += dif->history[i];
+        }
     }
 
     // Each sample has units of mdeg, so take average and convert to mdeg/s.
@@ -45,14 +64,20 @@ static int32_t pbio_differentiator_calc_speed(pbio_differentiator_t *dif, uint8_
 int32_t pbio_differentiator_update_and_get_speed(pbio_differentiator_t *dif, const pbio_angle_t *angle) {
 
     // Increment index where latest difference will be stored.
-    dif->index = (dif->index + 1) % PBIO_ARRAY_SIZE(dif->history);
+    dif->index = pbio_differentiator_wrap(dif->index + 1);
 
     // The difference is stored in millidegrees. Even at 6000 deg/s (well
     // above the physical limits of the motors we use), this at most
     // 6000 * 1000 * 0.005 = 30000, which fits in a 16-bit signed integer.
-    dif->history[dif->index] = pbio_int_math_clamp(pbio_angle_diff_mdeg(angle, &dif->prev_angle), INT16_MAX);
+    int16_t diff = pbio_int_math_clamp(pbio_angle_diff_mdeg(angle, &dif->prev_angle), INT16_MAX);
     dif->prev_angle = *angle;
 
+    // Update the sum across the default window by adding the newest difference
+    // and dropping the one that just went out of the window.
+    uint8_t oldest_index = pbio_differentiator_wrap(dif->index + PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE - PBIO_CONFIG_DIFFERENTIATOR_WINDOW_SIZE);
+    dif->window_sum += diff - dif->history[oldest_index];
+    dif->history[dif->index] = diff;
+
     // Calculate the speed.
     return pbio_differentiator_calc_speed(dif, PBIO_CONFIG_DIFFERENTIATOR_WINDOW_SIZE);
 }
@@ -87,6 +112,7 @@ pbio_error_t pbio_differentiator_get_speed(pbio_differentiator_t *dif, uint32_t
  */
 void pbio_differentiator_reset(pbio_differentiator_t *dif, const pbio_angle_t *angle) {
     dif->prev_angle = *angle;
+    dif->window_sum = 0;
     for (uint8_t i = 0; i < PBIO_ARRAY_SIZE(dif->history); i++) {
         dif->history[i] = 0;
     }
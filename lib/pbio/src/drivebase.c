@@ -18,6 +18,19 @@
 // Drivebase objects
 static pbio_drivebase_t drivebases[PBIO_CONFIG_NUM_DRIVEBASES];
 
+/**
+ * Gets a drivebase instance by index, whether or not it is in use.
+ *
+ * @param [in]  index       The index of the drivebase.
+ * @return                  The drivebase instance or NULL if index is out of range.
+ */
+pbio_drivebase_t *pbio_drivebase_by_index(uint8_t index) {
+    if (index >= PBIO_CONFIG_NUM_DRIVEBASES) {
+        return NULL;
+    }
+    return &drivebases[index];
+}
+
 /**
  * Gets the state of the drivebase update loop.
  *
@@ -83,6 +96,7 @@ static void drivebase_adopt_settings(pbio_control_settings_t *s_distance, pbio_c
         // Make acceleration, deceleration a bit slower for smoother driving.
         .acceleration = pbio_int_math_min(s_left->acceleration, s_right->acceleration) * 3 / 4,
         .deceleration = pbio_int_math_min(s_left->deceleration, s_right->deceleration) * 3 / 4,
+        .smoothing = pbio_int_math_max(s_left->smoothing, s_right->smoothing),
         .actuation_max = actuation_max,
         .pid_kp = pid_kp,
         // Dynamic kp reduction is disabled for drivebases. Instead, it uses
@@ -443,6 +457,61 @@ bool pbio_drivebase_is_done(const pbio_drivebase_t *db) {
     return pbio_control_is_done(&db->control_distance) && pbio_control_is_done(&db->control_heading);
 }
 
+/**
+ * Stretches the shortest of the two drivebase trajectories so that both
+ * complete at the same time.
+ *
+ * @param [in]  db              The drivebase instance.
+ */
+static void pbio_drivebase_synchronize_trajectories(pbio_drivebase_t *db) {
+
+    // The two trajectories may have different durations, so they won't complete at the same time
+    // To account for this, we re-compute the shortest trajectory to have the same duration as the longest.
+
+    // First, find out which controller takes the lead
+    const pbio_control_t *control_leader;
+    pbio_control_t *control_follower;
+
+    if (pbio_trajectory_get_duration(&db->control_distance.trajectory) >
+        pbio_trajectory_get_duration(&db->control_heading.trajectory)) {
+        // Distance control takes the longest, so it will take the lead
+        control_leader = &db->control_distance;
+        control_follower = &db->control_heading;
+    } else {
+        // Heading control takes the longest, so it will take the lead
+        control_leader = &db->control_heading;
+        control_follower = &db->control_distance;
+    }
+
+    // Revise follower trajectory so it takes as long as the leader, achieved
+    // by picking a lower speed and accelerations that makes the times match.
+    pbio_trajectory_stretch(&control_follower->trajectory, &control_leader->trajectory);
+}
+
+/**
+ * Starts the next queued maneuver on both drivebase controllers.
+ *
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  time_now        The wall time (ticks).
+ * @return                      Error code.
+ */
+static pbio_error_t pbio_drivebase_start_queued(pbio_drivebase_t *db, uint32_t time_now) {
+
+    pbio_error_t err = pbio_control_queue_start_next(&db->control_distance, time_now);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+    err = pbio_control_queue_start_next(&db->control_heading, time_now);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    // Make both trajectories complete at the same time.
+    pbio_drivebase_synchronize_trajectories(db);
+
+    return PBIO_SUCCESS;
+}
+
 /**
  * Updates one drivebase in the control loop.
  *
@@ -470,6 +539,16 @@ static pbio_error_t pbio_drivebase_update(pbio_drivebase_t *db) {
         return err;
     }
 
+    // Start the next queued maneuver right when the ongoing one ends. Both
+    // trajectories end at the same time, so they switch together.
+    if (pbio_control_queue_is_due(&db->control_distance, time_now) &&
+        pbio_control_queue_is_due(&db->control_heading, time_now)) {
+        err = pbio_drivebase_start_queued(db, time_now);
+        if (err != PBIO_SUCCESS) {
+            return err;
+        }
+    }
+
     // Get reference and torque signals for distance control.
     pbio_trajectory_reference_t ref_distance;
     int32_t distance_torque;
@@ -584,61 +663,80 @@ static pbio_error_t pbio_drivebase_drive_relative(pbio_drivebase_t *db, int32_t
         return err;
     }
 
-    // At this point, the two trajectories may have different durations, so they won't complete at the same time
-    // To account for this, we re-compute the shortest trajectory to have the same duration as the longest.
+    // Make both trajectories complete at the same time.
+    pbio_drivebase_synchronize_trajectories(db);
 
-    // First, find out which controller takes the lead
-    const pbio_control_t *control_leader;
-    pbio_control_t *control_follower;
+    return PBIO_SUCCESS;
+}
 
-    if (pbio_trajectory_get_duration(&db->control_distance.trajectory) >
-        pbio_trajectory_get_duration(&db->control_heading.trajectory)) {
-        // Distance control takes the longest, so it will take the lead
-        control_leader = &db->control_distance;
-        control_follower = &db->control_heading;
-    } else {
-        // Heading control takes the longest, so it will take the lead
-        control_leader = &db->control_heading;
-        control_follower = &db->control_distance;
+/**
+ * Queues a maneuver to run by a given distance and angle after the ongoing one.
+ *
+ * If no maneuver is ongoing or the last one has already ended, this starts
+ * right away.
+ *
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  distance        The distance to run by in mm.
+ * @param [in]  angle           The angle to turn in deg.
+ * @param [in]  on_completion   What to do when reaching the target.
+ * @return                      Error code.
+ */
+static pbio_error_t pbio_drivebase_queue_relative(pbio_drivebase_t *db, int32_t distance, int32_t angle, pbio_control_on_completion_t on_completion) {
+
+    // Don't allow new user command if update loop not registered.
+    if (!pbio_drivebase_update_loop_is_running(db)) {
+        return PBIO_ERROR_INVALID_OP;
     }
 
-    // Revise follower trajectory so it takes as long as the leader, achieved
-    // by picking a lower speed and accelerations that makes the times match.
-    pbio_trajectory_stretch(&control_follower->trajectory, &control_leader->trajectory);
+    // There is nothing to follow up on, so start now.
+    uint32_t time_now = pbio_control_get_time_ticks();
+    if (!pbio_control_queue_is_open(&db->control_distance, time_now) ||
+        !pbio_control_queue_is_open(&db->control_heading, time_now)) {
+        return pbio_drivebase_drive_relative(db, distance, 0, angle, 0, on_completion);
+    }
 
-    return PBIO_SUCCESS;
+    // Both queues are always the same length, so if the first one accepts
+    // the segment, so does the second.
+    pbio_error_t err = pbio_control_queue_position_control_relative(&db->control_distance, distance, 0, on_completion);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+    return pbio_control_queue_position_control_relative(&db->control_heading, angle, 0, on_completion);
 }
 
 /**
- * Starts the drivebase controllers to run by a given distance.
+ * Starts or queues a maneuver to run by a given distance and angle.
  *
  * This will use the default speed.
  *
  * @param [in]  db              The drivebase instance.
  * @param [in]  distance        The distance to run by in mm.
+ * @param [in]  angle           The angle to turn in deg.
  * @param [in]  on_completion   What to do when reaching the target.
+ * @param [in]  queue           Whether to start after the ongoing maneuver (true) or right away (false).
  * @return                      Error code.
  */
-pbio_error_t pbio_drivebase_drive_straight(pbio_drivebase_t *db, int32_t distance, pbio_control_on_completion_t on_completion) {
+static pbio_error_t pbio_drivebase_drive_relative_common(pbio_drivebase_t *db, int32_t distance, int32_t angle, pbio_control_on_completion_t on_completion, bool queue) {
+    if (queue) {
+        return pbio_drivebase_queue_relative(db, distance, angle, on_completion);
+    }
     // Execute the common drive command at default speed (by passing 0 speed).
-    return pbio_drivebase_drive_relative(db, distance, 0, 0, 0, on_completion);
+    return pbio_drivebase_drive_relative(db, distance, 0, angle, 0, on_completion);
 }
 
 /**
- * Starts the drivebase controllers to run by an arc of given radius and angle.
+ * Starts or queues a maneuver along an arc of given radius and angle.
  *
- * curve() was originally used as a generalization of turn(), but is now
- * deprecated in favor of the arc methods, which have more practical arguments.
- *
- * This will use the default speed.
+ * See ::pbio_drivebase_drive_curve for the sign conventions.
  *
  * @param [in]  db              The drivebase instance.
  * @param [in]  radius          Radius of the arc in mm.
  * @param [in]  angle           Angle in degrees.
  * @param [in]  on_completion   What to do when reaching the target.
+ * @param [in]  queue           Whether to start after the ongoing maneuver (true) or right away (false).
  * @return                      Error code.
  */
-pbio_error_t pbio_drivebase_drive_curve(pbio_drivebase_t *db, int32_t radius, int32_t angle, pbio_control_on_completion_t on_completion) {
+static pbio_error_t pbio_drivebase_drive_curve_common(pbio_drivebase_t *db, int32_t radius, int32_t angle, pbio_control_on_completion_t on_completion, bool queue) {
 
     // The angle is signed by the radius so we can go both ways.
     int32_t arc_angle = radius < 0 ? -angle : angle;
@@ -646,27 +744,22 @@ pbio_error_t pbio_drivebase_drive_curve(pbio_drivebase_t *db, int32_t radius, in
     // Arc length is computed accordingly.
     int32_t arc_length = (10 * pbio_int_math_abs(angle) * radius) / 573;
 
-    // Execute the common drive command at default speed (by passing 0 speed).
-    return pbio_drivebase_drive_relative(db, arc_length, 0, arc_angle, 0, on_completion);
+    return pbio_drivebase_drive_relative_common(db, arc_length, arc_angle, on_completion, queue);
 }
 
 /**
- * Starts the drivebase controllers to run by an arc of given radius and angle.
- *
- * With a positive radius, the robot drives along a circle to its right.
- * With a negative radius, the robot drives along a circle to its left.
- *
- * A positive angle means driving forward along the circle, negative is reverse.
+ * Starts or queues a maneuver along an arc of given radius and angle.
  *
- * This will use the default speed.
+ * See ::pbio_drivebase_drive_arc_angle for the sign conventions.
  *
  * @param [in]  db              The drivebase instance.
  * @param [in]  radius          Radius of the arc in mm.
  * @param [in]  angle           The angle to drive along the circle in degrees.
  * @param [in]  on_completion   What to do when reaching the target.
+ * @param [in]  queue           Whether to start after the ongoing maneuver (true) or right away (false).
  * @return                      Error code.
  */
-pbio_error_t pbio_drivebase_drive_arc_angle(pbio_drivebase_t *db, int32_t radius, int32_t angle, pbio_control_on_completion_t on_completion) {
+static pbio_error_t pbio_drivebase_drive_arc_angle_common(pbio_drivebase_t *db, int32_t radius, int32_t angle, pbio_control_on_completion_t on_completion, bool queue) {
 
     if (pbio_int_math_abs(radius) < 10) {
         return PBIO_ERROR_INVALID_ARG;
@@ -681,27 +774,22 @@ pbio_error_t pbio_drivebase_drive_arc_angle(pbio_drivebase_t *db, int32_t radius
     int32_t direction = (radius > 0) == (angle > 0) ? 1 : -1;
     int32_t drive_angle = pbio_int_math_abs(angle) * direction;
 
-    // Execute the common drive command at default speed (by passing 0 speed).
-    return pbio_drivebase_drive_relative(db, drive_distance, 0, drive_angle, 0, on_completion);
+    return pbio_drivebase_drive_relative_common(db, drive_distance, drive_angle, on_completion, queue);
 }
 
 /**
- * Starts the drivebase controllers to run by an arc of given radius and arc length.
+ * Starts or queues a maneuver along an arc of given radius and arc length.
  *
- * With a positive radius, the robot drives along a circle to its right.
- * With a negative radius, the robot drives along a circle to its left.
- *
- * A positive distance means driving forward along the circle, negative is reverse.
- *
- * This will use the default speed.
+ * See ::pbio_drivebase_drive_arc_distance for the sign conventions.
  *
  * @param [in]  db              The drivebase instance.
  * @param [in]  radius          Radius of the arc in mm.
  * @param [in]  distance        The distance to drive (arc length) in mm.
  * @param [in]  on_completion   What to do when reaching the target.
+ * @param [in]  queue           Whether to start after the ongoing maneuver (true) or right away (false).
  * @return                      Error code.
  */
-pbio_error_t pbio_drivebase_drive_arc_distance(pbio_drivebase_t *db, int32_t radius, int32_t distance, pbio_control_on_completion_t on_completion) {
+static pbio_error_t pbio_drivebase_drive_arc_distance_common(pbio_drivebase_t *db, int32_t radius, int32_t distance, pbio_control_on_completion_t on_completion, bool queue) {
 
     if (pbio_int_math_abs(radius) < 10) {
         return PBIO_ERROR_INVALID_ARG;
@@ -714,8 +802,136 @@ pbio_error_t pbio_drivebase_drive_arc_distance(pbio_drivebase_t *db, int32_t rad
         angle *= -1;
     }
 
-    // Execute the common drive command at default speed (by passing 0 speed).
-    return pbio_drivebase_drive_relative(db, distance, 0, angle, 0, on_completion);
+    return pbio_drivebase_drive_relative_common(db, distance, angle, on_completion, queue);
+}
+
+/**
+ * Starts the drivebase controllers to run by a given distance.
+ *
+ * This will use the default speed.
+ *
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  distance        The distance to run by in mm.
+ * @param [in]  on_completion   What to do when reaching the target.
+ * @return                      Error code.
+ */
+pbio_error_t pbio_drivebase_drive_straight(pbio_drivebase_t *db, int32_t distance, pbio_control_on_completion_t on_completion) {
+    return pbio_drivebase_drive_relative_common(db, distance, 0, on_completion, false);
+}
+
+/**
+ * Starts the drivebase controllers to run by an arc of given radius and angle.
+ *
+ * curve() was originally used as a generalization of turn(), but is now
+ * deprecated in favor of the arc methods, which have more practical arguments.
+ *
+ * This will use the default speed.
+ *
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  radius          Radius of the arc in mm.
+ * @param [in]  angle           Angle in degrees.
+ * @param [in]  on_completion   What to do when reaching the target.
+ * @return                      Error code.
+ */
+pbio_error_t pbio_drivebase_drive_curve(pbio_drivebase_t *db, int32_t radius, int32_t angle, pbio_control_on_completion_t on_completion) {
+    return pbio_drivebase_drive_curve_common(db, radius, angle, on_completion, false);
+}
+
+/**
+ * Starts the drivebase controllers to run by an arc of given radius and angle.
+ *
+ * With a positive radius, the robot drives along a circle to its right.
+ * With a negative radius, the robot drives along a circle to its left.
+ *
+ * A positive angle means driving forward along the circle, negative is reverse.
+ *
+ * This will use the default speed.
+ *
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  radius          Radius of the arc in mm.
+ * @param [in]  angle           The angle to drive along the circle in degrees.
+ * @param [in]  on_completion   What to do when reaching the target.
+ * @return                      Error code.
+ */
+pbio_error_t pbio_drivebase_drive_arc_angle(pbio_drivebase_t *db, int32_t radius, int32_t angle, pbio_control_on_completion_t on_completion) {
+    return pbio_drivebase_drive_arc_angle_common(db, radius, angle, on_completion, false);
+}
+
+/**
+ * Starts the drivebase controllers to run by an arc of given radius and arc length.
+ *
+ * With a positive radius, the robot drives along a circle to its right.
+ * With a negative radius, the robot drives along a circle to its left.
+ *
+ * A positive distance means driving forward along the circle, negative is reverse.
+ *
+ * This will use the default speed.
+ *
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  radius          Radius of the arc in mm.
+ * @param [in]  distance        The distance to drive (arc length) in mm.
+ * @param [in]  on_completion   What to do when reaching the target.
+ * @return                      Error code.
+ */
+pbio_error_t pbio_drivebase_drive_arc_distance(pbio_drivebase_t *db, int32_t radius, int32_t distance, pbio_control_on_completion_t on_completion) {
+    return pbio_drivebase_drive_arc_distance_common(db, radius, distance, on_completion, false);
+}
+
+/**
+ * Queues a straight maneuver to start when the ongoing one ends.
+ *
+ * If no maneuver is ongoing or the last one has already ended, this starts
+ * right away.
+ *
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  distance        The distance to run by in mm.
+ * @param [in]  on_completion   What to do when reaching the target.
+ * @return                      Error code.
+ */
+pbio_error_t pbio_drivebase_queue_straight(pbio_drivebase_t *db, int32_t distance, pbio_control_on_completion_t on_completion) {
+    return pbio_drivebase_drive_relative_common(db, distance, 0, on_completion, true);
+}
+
+/**
+ * Queues a curve as in ::pbio_drivebase_drive_curve to start when the
+ * ongoing maneuver ends.
+ *
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  radius          Radius of the arc in mm.
+ * @param [in]  angle           Angle in degrees.
+ * @param [in]  on_completion   What to do when reaching the target.
+ * @return                      Error code.
+ */
+pbio_error_t pbio_drivebase_queue_curve(pbio_drivebase_t *db, int32_t radius, int32_t angle, pbio_control_on_completion_t on_completion) {
+    return pbio_drivebase_drive_curve_common(db, radius, angle, on_completion, true);
+}
+
+/**
+ * Queues an arc as in ::pbio_drivebase_drive_arc_angle to start when the
+ * ongoing maneuver ends.
+ *
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  radius          Radius of the arc in mm.
+ * @param [in]  angle           The angle to drive along the circle in degrees.
+ * @param [in]  on_completion   What to do when reaching the target.
+ * @return                      Error code.
+ */
+pbio_error_t pbio_drivebase_queue_arc_angle(pbio_drivebase_t *db, int32_t radius, int32_t angle, pbio_control_on_completion_t on_completion) {
+    return pbio_drivebase_drive_arc_angle_common(db, radius, angle, on_completion, true);
+}
+
+/**
+ * Queues an arc as in ::pbio_drivebase_drive_arc_distance to start when the
+ * ongoing maneuver ends.
+ *
+ * @param [in]  db              The drivebase instance.
+ * @param [in]  radius          Radius of the arc in mm.
+ * @param [in]  distance        The distance to drive (arc length) in mm.
+ * @param [in]  on_completion   What to do when reaching the target.
+ * @return                      Error code.
+ */
+pbio_error_t pbio_drivebase_queue_arc_distance(pbio_drivebase_t *db, int32_t radius, int32_t distance, pbio_control_on_completion_t on_completion) {
+    return pbio_drivebase_drive_arc_distance_common(db, radius, distance, on_completion, true);
 }
 
 /**
@@ -33,6 +33,47 @@
         } \
     } while (0)
 
+/**
+ * Extend the modified region of an image, if tracked.
+ * @param [in] image  Image which was drawn into.
+ * @param [in] x1     Left X coordinate, included.
+ * @param [in] y1     Top Y coordinate, included.
+ * @param [in] x2     Right X coordinate, excluded.
+ * @param [in] y2     Bottom Y coordinate, excluded.
+ *
+ * Coordinates must already be clipped to the image dimensions.
+ */
+static inline void pbio_image_mark_dirty(pbio_image_t *image, int x1, int y1,
+    int x2, int y2) {
+    pbio_image_dirty_t *dirty = image->dirty;
+    if (!dirty || x1 >= x2 || y1 >= y2) {
+        return;
+    }
+    x1 += image->dirty_x;
+    x2 += image->dirty_x;
+    y1 += image->dirty_y;
+    y2 += image->dirty_y;
+    if (dirty->x1 >= dirty->x2) {
+        dirty->x1 = x1;
+        dirty->y1 = y1;
+        dirty->x2 = x2;
+        dirty->y2 = y2;
+        return;
+    }
+    if (x1 < dirty->x1) {
+        dirty->x1 = x1;
+    }
+    if (y1 < dirty->y1) {
+        dirty->y1 = y1;
+    }
+    if (x2 > dirty->x2) {
+        dirty->x2 = x2;
+    }
+    if (y2 > dirty->y2) {
+        dirty->y2 = y2;
+    }
+}
+
 /**
  * Initialize an image, using external storage.
  * @param [out] image   Uninitialized image to initialize.
@@ -56,6 +97,9 @@ void pbio_image_init(pbio_image_t *image, uint8_t *pixels, int width,
     image->print_x_left = 0;
     image->print_y_top = 0;
     image->print_value = 0;
+    image->dirty = NULL;
+    image->dirty_x = 0;
+    image->dirty_y = 0;
 }
 
 /**
@@ -99,6 +143,47 @@ void pbio_image_init_sub(pbio_image_t *image, const pbio_image_t *source,
     // Reuse the same font and value.
     image->print_font = source->print_font;
     image->print_value = source->print_value;
+
+    // Share modified region tracking.
+    image->dirty = source->dirty;
+    image->dirty_x = source->dirty_x + x;
+    image->dirty_y = source->dirty_y + y;
+}
+
+/**
+ * Start tracking the region modified by drawing functions.
+ * @param [in] image  Image to track.
+ * @param [out] dirty Storage for the modified region.
+ *
+ * The whole image is initially considered modified. Viewports created from
+ * this image after this call extend the same region.
+ */
+void pbio_image_track_dirty(pbio_image_t *image, pbio_image_dirty_t *dirty) {
+    image->dirty = dirty;
+    image->dirty_x = 0;
+    image->dirty_y = 0;
+    dirty->x1 = 0;
+    dirty->y1 = 0;
+    dirty->x2 = image->width;
+    dirty->y2 = image->height;
+}
+
+/**
+ * Get and reset the modified region.
+ * @param [in]  dirty  Modified region tracking.
+ * @param [out] rect   Modified region, if any.
+ * @return             True if something was modified since last call.
+ */
+bool pbio_image_take_dirty(pbio_image_dirty_t *dirty, pbio_image_rect_t *rect) {
+    if (dirty->x1 >= dirty->x2) {
+        return false;
+    }
+    rect->x = dirty->x1;
+    rect->y = dirty->y1;
+    rect->width = dirty->x2 - dirty->x1;
+    rect->height = dirty->y2 - dirty->y1;
+    dirty->x2 = dirty->x1;
+    return true;
 }
 
 /**
@@ -114,6 +199,7 @@ void pbio_image_fill(pbio_image_t *image, uint8_t value) {
         memset(p, value, image->width);
         p += image->stride;
     }
+    pbio_image_mark_dirty(image, 0, 0, image->width, image->height);
     image->print_x_left = 0;
     image->print_y_top = 0;
 }
@@ -150,6 +236,7 @@ void pbio_image_draw_image(pbio_image_t *image, const pbio_image_t *source,
         dst += image->stride;
         src += source->stride;
     }
+    pbio_image_mark_dirty(image, x, y, x2, y2);
 }
 
 /**
@@ -194,6 +281,7 @@ void pbio_image_draw_image_transparent(pbio_image_t *image,
         dst += image->stride - w;
         src += source->stride - w;
     }
+    pbio_image_mark_dirty(image, x, y, x2, y2);
 }
 
 /**
@@ -214,6 +302,7 @@ void pbio_image_draw_pixel(pbio_image_t *image, int x, int y, uint8_t value) {
     // Draw pixel.
     uint8_t *p = image->pixels + y * image->stride + x;
     *p = value;
+    pbio_image_mark_dirty(image, x, y, x + 1, y + 1);
 }
 
 /**
@@ -243,6 +332,7 @@ void pbio_image_draw_hline(pbio_image_t *image, int x, int y, int l,
     // Draw line.
     uint8_t *p = image->pixels + y * image->stride + x;
     memset(p, value, x2 - x);
+    pbio_image_mark_dirty(image, x, y, x2, y + 1);
 }
 
 /**
@@ -275,6 +365,7 @@ void pbio_image_draw_vline(pbio_image_t *image, int x, int y, int l,
         *p = value;
         p += image->stride;
     }
+    pbio_image_mark_dirty(image, x, y, x + 1, y2);
 }
 
 /**
@@ -566,6 +657,7 @@ void pbio_image_fill_rect(pbio_image_t *image, int x, int y, int width,
         memset(p, value, x2 - x);
         p += image->stride;
     }
+    pbio_image_mark_dirty(image, x, y, x2, y2);
 }
 
 /**
@@ -765,6 +857,49 @@ void pbio_image_fill_circle(pbio_image_t *image, int x, int y, int r,
     }
 }
 
+/**
+ * Test a bit of a glyph bitmap row.
+ * @param [in] row  Start of the bitmap row.
+ * @param [in] dx   Column in the glyph.
+ * @return          True if the pixel is set.
+ */
+static inline bool pbio_image_glyph_bit(const uint8_t *row, int dx) {
+    return row[dx >> 3] & (0x80 >> (dx & 7));
+}
+
+/**
+ * Find the next run of set bits in a glyph bitmap row.
+ * @param [in]     row  Start of the bitmap row.
+ * @param [in,out] dx   Column to start from, set to the end of the run.
+ * @param [in]     end  Column to stop at, excluded.
+ * @return              Start of the run, or end if no more set bits.
+ */
+static inline int pbio_image_glyph_next_run(const uint8_t *row, int *dx,
+    int end) {
+    int i = *dx;
+
+    // Skip clear bits, a whole byte at a time when possible.
+    while (i < end && !pbio_image_glyph_bit(row, i)) {
+        if ((i & 7) == 0 && !row[i >> 3]) {
+            i += 8;
+        } else {
+            i++;
+        }
+    }
+    if (i >= end) {
+        *dx = end;
+        return end;
+    }
+
+    // Find the end of the run.
+    int start = i;
+    while (i < end && pbio_image_glyph_bit(row, i)) {
+        i++;
+    }
+    *dx = i;
+    return start;
+}
+
 /**
  * Draw a single glyph.
  * @param [in] image  Image to draw into.
@@ -773,24 +908,166 @@ void pbio_image_fill_circle(pbio_image_t *image, int x, int y, int r,
  * @param [in] x      X coordinate of the baseline.
  * @param [in] y      Y coordinate of the baseline.
  * @param [in] value  Pixel value.
+ *
+ * Clipping: drawing is clipped to image dimensions.
  */
 static void pbio_image_draw_text_glyph(pbio_image_t *image,
     const pbio_font_t *font, const pbio_font_glyph_t *glyph, int x, int y,
     uint8_t value) {
-    const uint8_t *src = &font->data[glyph->data_index];
-    uint8_t bits;
-    for (int dy = 0; dy < glyph->height; dy++) {
-        for (int dx = 0; dx < glyph->width; dx++) {
-            if ((dx & 7) == 0) {
-                bits = *src++;
+    // Clipping, once for the whole glyph.
+    int ox = x + glyph->left;
+    int oy = y - glyph->top;
+    int x1 = ox;
+    int y1 = oy;
+    int x2 = ox + glyph->width;
+    int y2 = oy + glyph->height;
+    clip_or_return(x1, x2, image->width);
+    clip_or_return(y1, y2, image->height);
+
+    // Each bitmap row starts on a byte boundary. Runs of set bits are drawn
+    // as spans.
+    int row_size = (glyph->width + 7) / 8;
+    const uint8_t *src = &font->data[glyph->data_index] + (y1 - oy) * row_size;
+    uint8_t *dst = image->pixels + y1 * image->stride + x1;
+    for (int h = y2 - y1; h; h--) {
+        int dx = x1 - ox;
+        for (;;) {
+            int start = pbio_image_glyph_next_run(src, &dx, x2 - ox);
+            if (start == dx) {
+                break;
             }
-            if (bits & 128) {
-                pbio_image_draw_pixel(image, x + glyph->left + dx,
-                    y - glyph->top + dy, value);
+            memset(dst + start - (x1 - ox), value, dx - start);
+        }
+        src += row_size;
+        dst += image->stride;
+    }
+    pbio_image_mark_dirty(image, x1, y1, x2, y2);
+}
+
+#if PBIO_CONFIG_IMAGE_GLYPH_CACHE_SIZE
+
+/**
+ * Run of set pixels in a glyph row.
+ */
+typedef struct _pbio_image_glyph_span_t {
+    /**
+     * Column of the first pixel in the glyph bitmap.
+     */
+    uint8_t x;
+    /**
+     * Row in the glyph bitmap.
+     */
+    uint8_t y;
+    /**
+     * Number of pixels.
+     */
+    uint8_t length;
+} pbio_image_glyph_span_t;
+
+/**
+ * Glyphs of the last used print font, expanded to spans.
+ */
+static struct {
+    /**
+     * Font which was expanded, or NULL.
+     */
+    const pbio_font_t *font;
+    /**
+     * Whether all the font glyphs fit in the cache.
+     */
+    bool valid;
+    /**
+     * Index of the first span of each glyph, the stop index is the start
+     * index of the next glyph.
+     */
+    uint16_t start[256 + 1];
+    /**
+     * Spans of all glyphs.
+     */
+    pbio_image_glyph_span_t spans[PBIO_CONFIG_IMAGE_GLYPH_CACHE_SIZE];
+} pbio_image_glyph_cache;
+
+/**
+ * Expand the glyphs of a font in the cache, if not done yet.
+ * @param [in] font  Font to expand.
+ *
+ * If the font does not fit, the cache is not used for this font.
+ */
+static void pbio_image_glyph_cache_load(const pbio_font_t *font) {
+    if (pbio_image_glyph_cache.font == font) {
+        return;
+    }
+    pbio_image_glyph_cache.font = font;
+    pbio_image_glyph_cache.valid = false;
+
+    int n = 0;
+    for (int i = 0; i <= font->last - font->first; i++) {
+        const pbio_font_glyph_t *g = &font->glyphs[i];
+        int row_size = (g->width + 7) / 8;
+        const uint8_t *src = &font->data[g->data_index];
+        pbio_image_glyph_cache.start[i] = n;
+        for (int dy = 0; dy < g->height; dy++) {
+            int dx = 0;
+            for (;;) {
+                int start = pbio_image_glyph_next_run(src, &dx, g->width);
+                if (start == dx) {
+                    break;
+                }
+                if (n == PBIO_CONFIG_IMAGE_GLYPH_CACHE_SIZE) {
+                    return;
+                }
+                pbio_image_glyph_cache.spans[n].x = start;
+                pbio_image_glyph_cache.spans[n].y = dy;
+                pbio_image_glyph_cache.spans[n].length = dx - start;
+                n++;
             }
-            bits <<= 1;
+            src += row_size;
         }
     }
+    pbio_image_glyph_cache.start[font->last - font->first + 1] = n;
+    pbio_image_glyph_cache.valid = true;
+}
+
+#endif // PBIO_CONFIG_IMAGE_GLYPH_CACHE_SIZE
+
+/**
+ * Draw a single glyph of the print font.
+ * @param [in] image  Image to draw into.
+ * @param [in] font   Font to use for drawing.
+ * @param [in] glyph  Glyph to draw.
+ * @param [in] x      X coordinate of the baseline.
+ * @param [in] y      Y coordinate of the baseline.
+ * @param [in] value  Pixel value.
+ *
+ * Glyphs which are completely visible are drawn from the cache if available.
+ *
+ * Clipping: drawing is clipped to image dimensions.
+ */
+static void pbio_image_draw_print_glyph(pbio_image_t *image,
+    const pbio_font_t *font, const pbio_font_glyph_t *glyph, int x, int y,
+    uint8_t value) {
+    #if PBIO_CONFIG_IMAGE_GLYPH_CACHE_SIZE
+    int x1 = x + glyph->left;
+    int y1 = y - glyph->top;
+    int x2 = x1 + glyph->width;
+    int y2 = y1 + glyph->height;
+    if (pbio_image_glyph_cache.valid && pbio_image_glyph_cache.font == font &&
+        x1 >= 0 && y1 >= 0 && x2 <= image->width && y2 <= image->height) {
+        int i = glyph - font->glyphs;
+        const pbio_image_glyph_span_t *span =
+            &pbio_image_glyph_cache.spans[pbio_image_glyph_cache.start[i]];
+        const pbio_image_glyph_span_t *end =
+            &pbio_image_glyph_cache.spans[pbio_image_glyph_cache.start[i + 1]];
+        uint8_t *dst = image->pixels + y1 * image->stride + x1;
+        for (; span != end; span++) {
+            memset(dst + span->y * image->stride + span->x, value,
+                span->length);
+        }
+        pbio_image_mark_dirty(image, x1, y1, x2, y2);
+        return;
+    }
+    #endif // PBIO_CONFIG_IMAGE_GLYPH_CACHE_SIZE
+    pbio_image_draw_text_glyph(image, font, glyph, x, y, value);
 }
 
 /**
@@ -934,6 +1211,7 @@ static void pbio_image_scroll_up(pbio_image_t *image, int n) {
         memset(dst, 0, image->width);
         dst += image->stride;
     }
+    pbio_image_mark_dirty(image, 0, 0, image->width, image->height);
 }
 
 /**
@@ -961,6 +1239,10 @@ void pbio_image_print(pbio_image_t *image, const char *text, size_t text_len) {
     x = image->print_x_left;
     y_top = image->print_y_top;
 
+    #if PBIO_CONFIG_IMAGE_GLYPH_CACHE_SIZE
+    pbio_image_glyph_cache_load(font);
+    #endif
+
     for (p = text; p != text + text_len; p++) {
         c = *p;
         if (c == '\n') {
@@ -994,8 +1276,8 @@ void pbio_image_print(pbio_image_t *image, const char *text, size_t text_len) {
             }
 
             /* Draw glyph. */
-            pbio_image_draw_text_glyph(image, font, g, x, y_top + font->top_max,
-                image->print_value);
+            pbio_image_draw_print_glyph(image, font, g, x,
+                y_top + font->top_max, image->print_value);
 
             /* Advance pen. */
             x += g->advance;
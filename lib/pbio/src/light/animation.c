@@ -20,6 +20,8 @@
 
 static pbio_light_animation_t *pbio_light_animation_list_head;
 
+static pbio_os_process_t animation_process;
+
 /**
  * Initializes required fields of an animation data structure.
  * @param [in]  animation       The animation instance
@@ -36,6 +38,11 @@ static pbio_error_t pbio_light_animation_poll_handler(pbio_os_state_t *state, vo
         if (pbio_os_timer_is_expired(&a->timer)) {
             pbio_os_timer_set(&a->timer, a->next(a));
         }
+        // Get polled again when the next frame is due, or right away if the
+        // next frame has zero duration.
+        if (pbio_os_timer_await(&a->timer)) {
+            pbio_os_process_request_poll(&animation_process);
+        }
     }
     return PBIO_ERROR_AGAIN;
 }
@@ -58,14 +65,13 @@ void pbio_light_animation_start(pbio_light_animation_t *animation) {
     pbio_light_animation_list_head = animation;
 
     // Start process if it wasn't running already.
-    static pbio_os_process_t animation_process;
     if (animation_process.err != PBIO_ERROR_AGAIN) {
-        pbio_os_process_start(&animation_process, pbio_light_animation_poll_handler, NULL);
+        pbio_os_process_start_on_event(&animation_process, pbio_light_animation_poll_handler, NULL);
     }
 
     // Fake a timer event to load the first cell.
     pbio_os_timer_set(&animation->timer, 0);
-    pbio_os_request_poll();
+    pbio_os_process_request_poll(&animation_process);
 
     assert(animation->next_animation != PBIO_LIGHT_ANIMATION_STOPPED);
 }
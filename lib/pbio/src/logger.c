@@ -8,11 +8,13 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <inttypes.h>
+#include <string.h>
 
 #include <pbdrv/clock.h>
 #include <pbio/config.h>
 #include <pbio/error.h>
 #include <pbio/logger.h>
+#include <pbio/util.h>
 
 /**
  * Starts logging in the background.
@@ -26,6 +28,9 @@
 void pbio_logger_start(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint8_t num_cols, int32_t down_sample) {
     // (re-)initialize logger status.
     log->num_rows_used = 0;
+    log->num_rows_read = 0;
+    log->num_overruns = 0;
+    log->stream = false;
     log->skipped_samples = 0;
     log->data = buf;
     log->num_rows = num_rows;
@@ -37,6 +42,23 @@ void pbio_logger_start(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint8_t
     log->active = true;
 }
 
+/**
+ * Starts logging in the background, using the buffer as a ring buffer that
+ * is read with ::pbio_logger_stream_read_row while logging continues.
+ *
+ * If the reader does not keep up, new rows are dropped and counted as overruns.
+ *
+ * @param [in]  log         Pointer to log.
+ * @param [in]  buf         Array large enough to hold @p num_rows rows of data.
+ * @param [in]  num_rows    Maximum number of rows that can be buffered before they are read.
+ * @param [in]  num_cols    Number of entries in one row.
+ * @param [in]  down_sample For every @p down_sample of update calls, only one row is logged.
+ */
+void pbio_logger_start_stream(pbio_log_t *log, int32_t *buf, uint32_t num_rows, uint8_t num_cols, int32_t down_sample) {
+    pbio_logger_start(log, buf, num_rows, num_cols, down_sample);
+    log->stream = true;
+}
+
 /**
  * Stops accepting new data from background loops.
  *
@@ -70,18 +92,29 @@ void pbio_logger_add_row(pbio_log_t *log, const int32_t *row_data) {
     }
     log->skipped_samples = 0;
 
-    // Exit if log is full.
-    if (log->num_rows_used >= log->num_rows) {
+    uint32_t index = log->num_rows_used;
+
+    if (log->stream) {
+        // Drop the row if the reader has not made room for it yet.
+        if (log->num_rows_used - log->num_rows_read >= log->num_rows) {
+            log->num_overruns++;
+            return;
+        }
+        index %= log->num_rows;
+    } else if (log->num_rows_used >= log->num_rows) {
+        // Exit if log is full.
         log->active = false;
         return;
     }
 
+    int32_t *row = log->data + index * log->num_cols;
+
     // Write time of logging.
-    log->data[log->num_rows_used * log->num_cols] = pbdrv_clock_get_ms() - log->start_time;
+    row[0] = pbdrv_clock_get_ms() - log->start_time;
 
     // Write the data.
     for (uint8_t i = PBIO_LOGGER_NUM_DEFAULT_COLS; i < log->num_cols; i++) {
-        log->data[log->num_rows_used * log->num_cols + i] = row_data[i - PBIO_LOGGER_NUM_DEFAULT_COLS];
+        row[i] = row_data[i - PBIO_LOGGER_NUM_DEFAULT_COLS];
     }
 
     // Increment used row counter.
@@ -110,4 +143,173 @@ int32_t *pbio_logger_get_row_data(const pbio_log_t *log, uint32_t index) {
     return log->data + index * log->num_cols;
 }
 
+/**
+ * Checks if the log was started in streaming mode.
+ *
+ * @param [in]  log         Pointer to log.
+ * @return                  True if in streaming mode, else false.
+ */
+bool pbio_logger_is_stream(const pbio_log_t *log) {
+    return log->stream;
+}
+
+/**
+ * Gets the number of rows that can be read from a streaming log.
+ *
+ * @param [in]  log         Pointer to log.
+ * @return                  Number of unread rows.
+ */
+uint32_t pbio_logger_stream_get_num_available(const pbio_log_t *log) {
+    return log->num_rows_used - log->num_rows_read;
+}
+
+/**
+ * Gets the number of rows dropped because a streaming log was full.
+ *
+ * @param [in]  log         Pointer to log.
+ * @return                  Number of dropped rows.
+ */
+uint32_t pbio_logger_stream_get_num_overruns(const pbio_log_t *log) {
+    return log->num_overruns;
+}
+
+/**
+ * Reads the oldest unread row from a streaming log and advances the cursor.
+ *
+ * The row remains valid until the next row is added, so it should be used
+ * before the background loops run again.
+ *
+ * @param [in]  log         Pointer to log.
+ * @return                  Pointer to row data or NULL if there is nothing to read.
+ */
+const int32_t *pbio_logger_stream_read_row(pbio_log_t *log) {
+    if (!log->stream || log->num_rows_read == log->num_rows_used) {
+        return NULL;
+    }
+    const int32_t *row = log->data + (log->num_rows_read % log->num_rows) * log->num_cols;
+    log->num_rows_read++;
+    return row;
+}
+
+/**
+ * Description of the time column that the logger adds to each row.
+ */
+static const pbio_logger_column_t pbio_logger_time_column = {
+    .name = "log_time",
+    .scale = 1000,
+};
+
+/**
+ * Writes a length prefixed string, truncated to 255 bytes.
+ *
+ * @param [in]  str         Zero terminated string.
+ * @param [in]  buf         Buffer to write to.
+ * @param [in]  size        Size of the buffer.
+ * @return                  Number of bytes written, or 0 if it does not fit.
+ */
+static size_t pbio_logger_binary_encode_string(const char *str, uint8_t *buf, size_t size) {
+    size_t len = strlen(str);
+    if (len > UINT8_MAX) {
+        len = UINT8_MAX;
+    }
+    if (len + 1 > size) {
+        return 0;
+    }
+    buf[0] = len;
+    memcpy(&buf[1], str, len);
+    return len + 1;
+}
+
+/**
+ * Encodes the header of a binary log export.
+ *
+ * The header is the magic bytes ::PBIO_LOGGER_BINARY_MAGIC, the format
+ * version (uint8), the number of columns (uint8), the number of rows (uint32)
+ * and the length prefixed file path. It is followed by the scale (int32) and
+ * the length prefixed name of each column. All integers are little endian.
+ *
+ * @param [in]  log         Pointer to log.
+ * @param [in]  columns     Description of the columns added by the caller of
+ *                          ::pbio_logger_add_row, so excluding the log time.
+ * @param [in]  path        Name of the file for the host to save to.
+ * @param [in]  buf         Buffer to write to.
+ * @param [in]  size        Size of the buffer.
+ * @return                  Number of bytes written, or 0 if it does not fit.
+ */
+size_t pbio_logger_binary_encode_header(const pbio_log_t *log, const pbio_logger_column_t *columns, const char *path, uint8_t *buf, size_t size) {
+
+    const size_t fixed_size = sizeof(PBIO_LOGGER_BINARY_MAGIC) - 1 + 2 + sizeof(uint32_t);
+    if (size < fixed_size) {
+        return 0;
+    }
+    memcpy(buf, PBIO_LOGGER_BINARY_MAGIC, sizeof(PBIO_LOGGER_BINARY_MAGIC) - 1);
+    buf[4] = PBIO_LOGGER_BINARY_VERSION;
+    buf[5] = log->num_cols;
+    pbio_set_uint32_le(&buf[6], log->num_rows_used);
+    size_t used = fixed_size;
+
+    size_t written = pbio_logger_binary_encode_string(path, buf + used, size - used);
+    if (!written) {
+        return 0;
+    }
+    used += written;
+
+    for (uint8_t col = 0; col < log->num_cols; col++) {
+        const pbio_logger_column_t *column = col < PBIO_LOGGER_NUM_DEFAULT_COLS ?
+            &pbio_logger_time_column : &columns[col - PBIO_LOGGER_NUM_DEFAULT_COLS];
+
+        if (size - used < sizeof(int32_t)) {
+            return 0;
+        }
+        pbio_set_uint32_le(buf + used, column->scale);
+        used += sizeof(int32_t);
+
+        written = pbio_logger_binary_encode_string(column->name, buf + used, size - used);
+        if (!written) {
+            return 0;
+        }
+        used += written;
+    }
+    return used;
+}
+
+/**
+ * Encodes logged values for a binary log export.
+ *
+ * Each value is encoded as the difference with the same column on the
+ * previous row, or with 0 on the first row. The difference is written with
+ * ::pbio_set_varint_zigzag. Slowly changing signals such as time and angles
+ * take only one or two bytes per value this way.
+ *
+ * Call this repeatedly with the same cursor until it returns 0. Every call
+ * encodes as many values as fit in the buffer, so rows may be split across
+ * buffers.
+ *
+ * @param [in]  log         Pointer to log.
+ * @param [in]  cursor      Index of the next value to encode. Start with 0.
+ * @param [in]  buf         Buffer to write to, at least
+ *                          ::PBIO_LOGGER_BINARY_MAX_VALUE_SIZE bytes.
+ * @param [in]  size        Size of the buffer.
+ * @return                  Number of bytes written, or 0 when done.
+ */
+size_t pbio_logger_binary_encode_rows(const pbio_log_t *log, uint32_t *cursor, uint8_t *buf, size_t size) {
+
+    const uint32_t num_values = log->num_rows_used * log->num_cols;
+    size_t used = 0;
+
+    while (*cursor < num_values && size - used >= PBIO_LOGGER_BINARY_MAX_VALUE_SIZE) {
+
+        // Difference with same column on previous row, using unsigned
+        // arithmetic so it wraps around just like the decoder does.
+        uint32_t value = log->data[*cursor];
+        if (*cursor >= log->num_cols) {
+            value -= log->data[*cursor - log->num_cols];
+        }
+
+        used += pbio_set_varint_zigzag(buf + used, value);
+        (*cursor)++;
+    }
+    return used;
+}
+
 #endif // PBIO_CONFIG_LOGGER
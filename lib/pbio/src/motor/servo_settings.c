@@ -18,144 +18,144 @@
 #if PBIO_CONFIG_SERVO_PUP
 
 static const pbio_observer_model_t model_technic_s_angular = {
-    .d_angle_d_speed = 179217,
-    .d_speed_d_speed = 956,
-    .d_current_d_speed = -249247,
-    .d_angle_d_current = 1950303,
-    .d_speed_d_current = 7666,
-    .d_current_d_current = -9356019,
-    .d_angle_d_voltage = 5654927,
-    .d_speed_d_voltage = 11702,
-    .d_current_d_voltage = 349105,
-    .d_angle_d_torque = -425928,
-    .d_speed_d_torque = -1085,
-    .d_current_d_torque = 383927,
-    .d_voltage_d_torque = 22334,
-    .d_torque_d_voltage = 17203,
-    .d_torque_d_speed = 12282,
-    .d_torque_d_acceleration = 35129,
+    .d_angle_d_speed = PBIO_INT_MATH_RECIPROCAL(179217),
+    .d_speed_d_speed = PBIO_INT_MATH_RECIPROCAL(956),
+    .d_current_d_speed = PBIO_INT_MATH_RECIPROCAL(-249247),
+    .d_angle_d_current = PBIO_INT_MATH_RECIPROCAL(1950303),
+    .d_speed_d_current = PBIO_INT_MATH_RECIPROCAL(7666),
+    .d_current_d_current = PBIO_INT_MATH_RECIPROCAL(-9356019),
+    .d_angle_d_voltage = PBIO_INT_MATH_RECIPROCAL(5654927),
+    .d_speed_d_voltage = PBIO_INT_MATH_RECIPROCAL(11702),
+    .d_current_d_voltage = PBIO_INT_MATH_RECIPROCAL(349105),
+    .d_angle_d_torque = PBIO_INT_MATH_RECIPROCAL(-425928),
+    .d_speed_d_torque = PBIO_INT_MATH_RECIPROCAL(-1085),
+    .d_current_d_torque = PBIO_INT_MATH_RECIPROCAL(383927),
+    .d_voltage_d_torque = PBIO_INT_MATH_RECIPROCAL(22334),
+    .d_torque_d_voltage = PBIO_INT_MATH_RECIPROCAL(17203),
+    .d_torque_d_speed = PBIO_INT_MATH_RECIPROCAL(12282),
+    .d_torque_d_acceleration = PBIO_INT_MATH_RECIPROCAL(35129),
     .torque_friction = 9182,
 };
 
 static const pbio_observer_model_t model_technic_m_angular = {
-    .d_angle_d_speed = 177194,
-    .d_speed_d_speed = 934,
-    .d_current_d_speed = -165023,
-    .d_angle_d_current = 2407354,
-    .d_speed_d_current = 8311,
-    .d_current_d_current = 1058029,
-    .d_angle_d_voltage = 7431528,
-    .d_speed_d_voltage = 14444,
-    .d_current_d_voltage = 225610,
-    .d_angle_d_torque = -919183,
-    .d_speed_d_torque = -2332,
-    .d_current_d_torque = 629020,
-    .d_voltage_d_torque = 47606,
-    .d_torque_d_voltage = 8071,
-    .d_torque_d_speed = 5903,
-    .d_torque_d_acceleration = 16163,
+    .d_angle_d_speed = PBIO_INT_MATH_RECIPROCAL(177194),
+    .d_speed_d_speed = PBIO_INT_MATH_RECIPROCAL(934),
+    .d_current_d_speed = PBIO_INT_MATH_RECIPROCAL(-165023),
+    .d_angle_d_current = PBIO_INT_MATH_RECIPROCAL(2407354),
+    .d_speed_d_current = PBIO_INT_MATH_RECIPROCAL(8311),
+    .d_current_d_current = PBIO_INT_MATH_RECIPROCAL(1058029),
+    .d_angle_d_voltage = PBIO_INT_MATH_RECIPROCAL(7431528),
+    .d_speed_d_voltage = PBIO_INT_MATH_RECIPROCAL(14444),
+    .d_current_d_voltage = PBIO_INT_MATH_RECIPROCAL(225610),
+    .d_angle_d_torque = PBIO_INT_MATH_RECIPROCAL(-919183),
+    .d_speed_d_torque = PBIO_INT_MATH_RECIPROCAL(-2332),
+    .d_current_d_torque = PBIO_INT_MATH_RECIPROCAL(629020),
+    .d_voltage_d_torque = PBIO_INT_MATH_RECIPROCAL(47606),
+    .d_torque_d_voltage = PBIO_INT_MATH_RECIPROCAL(8071),
+    .d_torque_d_speed = PBIO_INT_MATH_RECIPROCAL(5903),
+    .d_torque_d_acceleration = PBIO_INT_MATH_RECIPROCAL(16163),
     .torque_friction = 21413,
 };
 
 static const pbio_observer_model_t model_technic_l_angular = {
-    .d_angle_d_speed = 174943,
-    .d_speed_d_speed = 904,
-    .d_current_d_speed = -58045,
-    .d_angle_d_current = 8368268,
-    .d_speed_d_current = 26508,
-    .d_current_d_current = 396164,
-    .d_angle_d_voltage = 13442903,
-    .d_speed_d_voltage = 25105,
-    .d_current_d_voltage = 86900,
-    .d_angle_d_torque = -3690545,
-    .d_speed_d_torque = -9310,
-    .d_current_d_torque = 975141,
-    .d_voltage_d_torque = 133763,
-    .d_torque_d_voltage = 2872,
-    .d_torque_d_speed = 1919,
-    .d_torque_d_acceleration = 3997,
+    .d_angle_d_speed = PBIO_INT_MATH_RECIPROCAL(174943),
+    .d_speed_d_speed = PBIO_INT_MATH_RECIPROCAL(904),
+    .d_current_d_speed = PBIO_INT_MATH_RECIPROCAL(-58045),
+    .d_angle_d_current = PBIO_INT_MATH_RECIPROCAL(8368268),
+    .d_speed_d_current = PBIO_INT_MATH_RECIPROCAL(26508),
+    .d_current_d_current = PBIO_INT_MATH_RECIPROCAL(396164),
+    .d_angle_d_voltage = PBIO_INT_MATH_RECIPROCAL(13442903),
+    .d_speed_d_voltage = PBIO_INT_MATH_RECIPROCAL(25105),
+    .d_current_d_voltage = PBIO_INT_MATH_RECIPROCAL(86900),
+    .d_angle_d_torque = PBIO_INT_MATH_RECIPROCAL(-3690545),
+    .d_speed_d_torque = PBIO_INT_MATH_RECIPROCAL(-9310),
+    .d_current_d_torque = PBIO_INT_MATH_RECIPROCAL(975141),
+    .d_voltage_d_torque = PBIO_INT_MATH_RECIPROCAL(133763),
+    .d_torque_d_voltage = PBIO_INT_MATH_RECIPROCAL(2872),
+    .d_torque_d_speed = PBIO_INT_MATH_RECIPROCAL(1919),
+    .d_torque_d_acceleration = PBIO_INT_MATH_RECIPROCAL(3997),
     .torque_friction = 23239,
 };
 
 static const pbio_observer_model_t model_interactive = {
-    .d_angle_d_speed = 179110,
-    .d_speed_d_speed = 941,
-    .d_current_d_speed = -316164,
-    .d_angle_d_current = 7311289,
-    .d_speed_d_current = 35750,
-    .d_current_d_current = -12014584,
-    .d_angle_d_voltage = 4603893,
-    .d_speed_d_voltage = 10967,
-    .d_current_d_voltage = 355664,
-    .d_angle_d_torque = -728461,
-    .d_speed_d_torque = -1850,
-    .d_current_d_torque = 668004,
-    .d_voltage_d_torque = 32225,
-    .d_torque_d_voltage = 11923,
-    .d_torque_d_speed = 10599,
-    .d_torque_d_acceleration = 20588,
+    .d_angle_d_speed = PBIO_INT_MATH_RECIPROCAL(179110),
+    .d_speed_d_speed = PBIO_INT_MATH_RECIPROCAL(941),
+    .d_current_d_speed = PBIO_INT_MATH_RECIPROCAL(-316164),
+    .d_angle_d_current = PBIO_INT_MATH_RECIPROCAL(7311289),
+    .d_speed_d_current = PBIO_INT_MATH_RECIPROCAL(35750),
+    .d_current_d_current = PBIO_INT_MATH_RECIPROCAL(-12014584),
+    .d_angle_d_voltage = PBIO_INT_MATH_RECIPROCAL(4603893),
+    .d_speed_d_voltage = PBIO_INT_MATH_RECIPROCAL(10967),
+    .d_current_d_voltage = PBIO_INT_MATH_RECIPROCAL(355664),
+    .d_angle_d_torque = PBIO_INT_MATH_RECIPROCAL(-728461),
+    .d_speed_d_torque = PBIO_INT_MATH_RECIPROCAL(-1850),
+    .d_current_d_torque = PBIO_INT_MATH_RECIPROCAL(668004),
+    .d_voltage_d_torque = PBIO_INT_MATH_RECIPROCAL(32225),
+    .d_torque_d_voltage = PBIO_INT_MATH_RECIPROCAL(11923),
+    .d_torque_d_speed = PBIO_INT_MATH_RECIPROCAL(10599),
+    .d_torque_d_acceleration = PBIO_INT_MATH_RECIPROCAL(20588),
     .torque_friction = 11227,
 };
 
 static const pbio_observer_model_t model_technic_l = {
-    .d_angle_d_speed = 175977,
-    .d_speed_d_speed = 912,
-    .d_current_d_speed = -159828,
-    .d_angle_d_current = 5728019,
-    .d_speed_d_current = 22787,
-    .d_current_d_current = -44152415,
-    .d_angle_d_voltage = 6164994,
-    .d_speed_d_voltage = 12888,
-    .d_current_d_voltage = 142828,
-    .d_angle_d_torque = -1377701,
-    .d_speed_d_torque = -3482,
-    .d_current_d_torque = 794862,
-    .d_voltage_d_torque = 62889,
-    .d_torque_d_voltage = 6110,
-    .d_torque_d_speed = 6837,
-    .d_torque_d_acceleration = 10751,
+    .d_angle_d_speed = PBIO_INT_MATH_RECIPROCAL(175977),
+    .d_speed_d_speed = PBIO_INT_MATH_RECIPROCAL(912),
+    .d_current_d_speed = PBIO_INT_MATH_RECIPROCAL(-159828),
+    .d_angle_d_current = PBIO_INT_MATH_RECIPROCAL(5728019),
+    .d_speed_d_current = PBIO_INT_MATH_RECIPROCAL(22787),
+    .d_current_d_current = PBIO_INT_MATH_RECIPROCAL(-44152415),
+    .d_angle_d_voltage = PBIO_INT_MATH_RECIPROCAL(6164994),
+    .d_speed_d_voltage = PBIO_INT_MATH_RECIPROCAL(12888),
+    .d_current_d_voltage = PBIO_INT_MATH_RECIPROCAL(142828),
+    .d_angle_d_torque = PBIO_INT_MATH_RECIPROCAL(-1377701),
+    .d_speed_d_torque = PBIO_INT_MATH_RECIPROCAL(-3482),
+    .d_current_d_torque = PBIO_INT_MATH_RECIPROCAL(794862),
+    .d_voltage_d_torque = PBIO_INT_MATH_RECIPROCAL(62889),
+    .d_torque_d_voltage = PBIO_INT_MATH_RECIPROCAL(6110),
+    .d_torque_d_speed = PBIO_INT_MATH_RECIPROCAL(6837),
+    .d_torque_d_acceleration = PBIO_INT_MATH_RECIPROCAL(10751),
     .torque_friction = 26430,
 };
 
 static const pbio_observer_model_t model_technic_xl = {
-    .d_angle_d_speed = 176559,
-    .d_speed_d_speed = 916,
-    .d_current_d_speed = -175173,
-    .d_angle_d_current = 8098298,
-    .d_speed_d_current = 35736,
-    .d_current_d_current = -7606150,
-    .d_angle_d_voltage = 5471477,
-    .d_speed_d_voltage = 12148,
-    .d_current_d_voltage = 156891,
-    .d_angle_d_torque = -1282598,
-    .d_speed_d_torque = -3244,
-    .d_current_d_torque = 729279,
-    .d_voltage_d_torque = 55617,
-    .d_torque_d_voltage = 6908,
-    .d_torque_d_speed = 7713,
-    .d_torque_d_acceleration = 11578,
+    .d_angle_d_speed = PBIO_INT_MATH_RECIPROCAL(176559),
+    .d_speed_d_speed = PBIO_INT_MATH_RECIPROCAL(916),
+    .d_current_d_speed = PBIO_INT_MATH_RECIPROCAL(-175173),
+    .d_angle_d_current = PBIO_INT_MATH_RECIPROCAL(8098298),
+    .d_speed_d_current = PBIO_INT_MATH_RECIPROCAL(35736),
+    .d_current_d_current = PBIO_INT_MATH_RECIPROCAL(-7606150),
+    .d_angle_d_voltage = PBIO_INT_MATH_RECIPROCAL(5471477),
+    .d_speed_d_voltage = PBIO_INT_MATH_RECIPROCAL(12148),
+    .d_current_d_voltage = PBIO_INT_MATH_RECIPROCAL(156891),
+    .d_angle_d_torque = PBIO_INT_MATH_RECIPROCAL(-1282598),
+    .d_speed_d_torque = PBIO_INT_MATH_RECIPROCAL(-3244),
+    .d_current_d_torque = PBIO_INT_MATH_RECIPROCAL(729279),
+    .d_voltage_d_torque = PBIO_INT_MATH_RECIPROCAL(55617),
+    .d_torque_d_voltage = PBIO_INT_MATH_RECIPROCAL(6908),
+    .d_torque_d_speed = PBIO_INT_MATH_RECIPROCAL(7713),
+    .d_torque_d_acceleration = PBIO_INT_MATH_RECIPROCAL(11578),
     .torque_friction = 12893,
 };
 
 #if PBIO_CONFIG_SERVO_PUP_MOVE_HUB
 
 static const pbio_observer_model_t model_movehub = {
-    .d_angle_d_speed = 176283,
-    .d_speed_d_speed = 913,
-    .d_current_d_speed = -202833,
-    .d_angle_d_current = 7437051,
-    .d_speed_d_current = 32807,
-    .d_current_d_current = -8118383,
-    .d_angle_d_voltage = 5022928,
-    .d_speed_d_voltage = 11156,
-    .d_current_d_voltage = 157720,
-    .d_angle_d_torque = -966059,
-    .d_speed_d_torque = -2442,
-    .d_current_d_torque = 636829,
-    .d_voltage_d_torque = 45536,
-    .d_torque_d_voltage = 8438,
-    .d_torque_d_speed = 10851,
-    .d_torque_d_acceleration = 15357,
+    .d_angle_d_speed = PBIO_INT_MATH_RECIPROCAL(176283),
+    .d_speed_d_speed = PBIO_INT_MATH_RECIPROCAL(913),
+    .d_current_d_speed = PBIO_INT_MATH_RECIPROCAL(-202833),
+    .d_angle_d_current = PBIO_INT_MATH_RECIPROCAL(7437051),
+    .d_speed_d_current = PBIO_INT_MATH_RECIPROCAL(32807),
+    .d_current_d_current = PBIO_INT_MATH_RECIPROCAL(-8118383),
+    .d_angle_d_voltage = PBIO_INT_MATH_RECIPROCAL(5022928),
+    .d_speed_d_voltage = PBIO_INT_MATH_RECIPROCAL(11156),
+    .d_current_d_voltage = PBIO_INT_MATH_RECIPROCAL(157720),
+    .d_angle_d_torque = PBIO_INT_MATH_RECIPROCAL(-966059),
+    .d_speed_d_torque = PBIO_INT_MATH_RECIPROCAL(-2442),
+    .d_current_d_torque = PBIO_INT_MATH_RECIPROCAL(636829),
+    .d_voltage_d_torque = PBIO_INT_MATH_RECIPROCAL(45536),
+    .d_torque_d_voltage = PBIO_INT_MATH_RECIPROCAL(8438),
+    .d_torque_d_speed = PBIO_INT_MATH_RECIPROCAL(10851),
+    .d_torque_d_acceleration = PBIO_INT_MATH_RECIPROCAL(15357),
     .torque_friction = 24835,
 };
 
@@ -166,62 +166,62 @@ static const pbio_observer_model_t model_movehub = {
 #if PBIO_CONFIG_SERVO_EV3_NXT
 
 static const pbio_observer_model_t model_ev3_l = {
-    .d_angle_d_speed = 88290,
-    .d_speed_d_speed = 921,
-    .d_current_d_speed = -61626,
-    .d_angle_d_current = 5755278,
-    .d_speed_d_current = 44574,
-    .d_current_d_current = 21338185,
-    .d_angle_d_voltage = 5240040,
-    .d_speed_d_voltage = 21582,
-    .d_current_d_voltage = 106130,
-    .d_angle_d_torque = -1887437,
-    .d_speed_d_torque = -9555,
-    .d_current_d_torque = 861143,
-    .d_voltage_d_torque = 107106,
-    .d_torque_d_voltage = 3587,
-    .d_torque_d_speed = 2083,
-    .d_torque_d_acceleration = 1965,
+    .d_angle_d_speed = PBIO_INT_MATH_RECIPROCAL(88290),
+    .d_speed_d_speed = PBIO_INT_MATH_RECIPROCAL(921),
+    .d_current_d_speed = PBIO_INT_MATH_RECIPROCAL(-61626),
+    .d_angle_d_current = PBIO_INT_MATH_RECIPROCAL(5755278),
+    .d_speed_d_current = PBIO_INT_MATH_RECIPROCAL(44574),
+    .d_current_d_current = PBIO_INT_MATH_RECIPROCAL(21338185),
+    .d_angle_d_voltage = PBIO_INT_MATH_RECIPROCAL(5240040),
+    .d_speed_d_voltage = PBIO_INT_MATH_RECIPROCAL(21582),
+    .d_current_d_voltage = PBIO_INT_MATH_RECIPROCAL(106130),
+    .d_angle_d_torque = PBIO_INT_MATH_RECIPROCAL(-1887437),
+    .d_speed_d_torque = PBIO_INT_MATH_RECIPROCAL(-9555),
+    .d_current_d_torque = PBIO_INT_MATH_RECIPROCAL(861143),
+    .d_voltage_d_torque = PBIO_INT_MATH_RECIPROCAL(107106),
+    .d_torque_d_voltage = PBIO_INT_MATH_RECIPROCAL(3587),
+    .d_torque_d_speed = PBIO_INT_MATH_RECIPROCAL(2083),
+    .d_torque_d_acceleration = PBIO_INT_MATH_RECIPROCAL(1965),
     .torque_friction = 16476,
 };
 
 static const pbio_observer_model_t model_ev3_m = {
-    .d_angle_d_speed = 90029,
-    .d_speed_d_speed = 959,
-    .d_current_d_speed = -185122,
-    .d_angle_d_current = 2377978,
-    .d_speed_d_current = 21415,
-    .d_current_d_current = -4432336,
-    .d_angle_d_voltage = 1996477,
-    .d_speed_d_voltage = 8917,
-    .d_current_d_voltage = 202362,
-    .d_angle_d_torque = -401501,
-    .d_speed_d_torque = -2047,
-    .d_current_d_torque = 467397,
-    .d_voltage_d_torque = 47722,
-    .d_torque_d_voltage = 8051,
-    .d_torque_d_speed = 7365,
-    .d_torque_d_acceleration = 9355,
+    .d_angle_d_speed = PBIO_INT_MATH_RECIPROCAL(90029),
+    .d_speed_d_speed = PBIO_INT_MATH_RECIPROCAL(959),
+    .d_current_d_speed = PBIO_INT_MATH_RECIPROCAL(-185122),
+    .d_angle_d_current = PBIO_INT_MATH_RECIPROCAL(2377978),
+    .d_speed_d_current = PBIO_INT_MATH_RECIPROCAL(21415),
+    .d_current_d_current = PBIO_INT_MATH_RECIPROCAL(-4432336),
+    .d_angle_d_voltage = PBIO_INT_MATH_RECIPROCAL(1996477),
+    .d_speed_d_voltage = PBIO_INT_MATH_RECIPROCAL(8917),
+    .d_current_d_voltage = PBIO_INT_MATH_RECIPROCAL(202362),
+    .d_angle_d_torque = PBIO_INT_MATH_RECIPROCAL(-401501),
+    .d_speed_d_torque = PBIO_INT_MATH_RECIPROCAL(-2047),
+    .d_current_d_torque = PBIO_INT_MATH_RECIPROCAL(467397),
+    .d_voltage_d_torque = PBIO_INT_MATH_RECIPROCAL(47722),
+    .d_torque_d_voltage = PBIO_INT_MATH_RECIPROCAL(8051),
+    .d_torque_d_speed = PBIO_INT_MATH_RECIPROCAL(7365),
+    .d_torque_d_acceleration = PBIO_INT_MATH_RECIPROCAL(9355),
     .torque_friction = 18317,
 };
 
 static const pbio_observer_model_t model_nxt = {
-    .d_angle_d_speed = 88366,
-    .d_speed_d_speed = 923,
-    .d_current_d_speed = -60070,
-    .d_angle_d_current = 5754836,
-    .d_speed_d_current = 44630,
-    .d_current_d_current = 27887153,
-    .d_angle_d_voltage = 5236928,
-    .d_speed_d_voltage = 21581,
-    .d_current_d_voltage = 106485,
-    .d_angle_d_torque = -2338784,
-    .d_speed_d_torque = -11845,
-    .d_current_d_torque = 1038248,
-    .d_voltage_d_torque = 132663,
-    .d_torque_d_voltage = 2896,
-    .d_torque_d_speed = 1634,
-    .d_torque_d_acceleration = 1587,
+    .d_angle_d_speed = PBIO_INT_MATH_RECIPROCAL(88366),
+    .d_speed_d_speed = PBIO_INT_MATH_RECIPROCAL(923),
+    .d_current_d_speed = PBIO_INT_MATH_RECIPROCAL(-60070),
+    .d_angle_d_current = PBIO_INT_MATH_RECIPROCAL(5754836),
+    .d_speed_d_current = PBIO_INT_MATH_RECIPROCAL(44630),
+    .d_current_d_current = PBIO_INT_MATH_RECIPROCAL(27887153),
+    .d_angle_d_voltage = PBIO_INT_MATH_RECIPROCAL(5236928),
+    .d_speed_d_voltage = PBIO_INT_MATH_RECIPROCAL(21581),
+    .d_current_d_voltage = PBIO_INT_MATH_RECIPROCAL(106485),
+    .d_angle_d_torque = PBIO_INT_MATH_RECIPROCAL(-2338784),
+    .d_speed_d_torque = PBIO_INT_MATH_RECIPROCAL(-11845),
+    .d_current_d_torque = PBIO_INT_MATH_RECIPROCAL(1038248),
+    .d_voltage_d_torque = PBIO_INT_MATH_RECIPROCAL(132663),
+    .d_torque_d_voltage = PBIO_INT_MATH_RECIPROCAL(2896),
+    .d_torque_d_speed = PBIO_INT_MATH_RECIPROCAL(1634),
+    .d_torque_d_acceleration = PBIO_INT_MATH_RECIPROCAL(1587),
     .torque_friction = 20449,
 };
 
@@ -7,10 +7,75 @@
 #include <pbio/drivebase.h>
 #include <pbio/servo.h>
 
+#include <pbio/motor_process.h>
 #include <pbio/os.h>
 
 #if PBIO_CONFIG_MOTOR_PROCESS != 0
 
+#if PBIO_CONFIG_MOTOR_PROCESS_STATS
+
+#include <string.h>
+
+static pbio_motor_process_stats_t stats;
+
+/**
+ * Gets the timing statistics of the motor control loop.
+ *
+ * @return  The statistics.
+ */
+const pbio_motor_process_stats_t *pbio_motor_process_get_stats(void) {
+    return &stats;
+}
+
+/**
+ * Resets the timing statistics of the motor control loop.
+ */
+void pbio_motor_process_reset_stats(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+/**
+ * Records the start of a control loop iteration.
+ *
+ * @param [in]  scheduled   Time at which the iteration should have started, in ms.
+ * @param [in]  now         Time at which the iteration started, in us.
+ */
+static void pbio_motor_process_stats_start(uint32_t scheduled, uint32_t now) {
+    uint32_t latency = now - scheduled * 1000;
+    if ((int32_t)latency < 0) {
+        latency = 0;
+    }
+
+    stats.num_ticks++;
+    if (latency > stats.latency_max) {
+        stats.latency_max = latency;
+    }
+
+    uint32_t bucket = latency / 1000;
+    if (bucket >= PBIO_MOTOR_PROCESS_HISTOGRAM_SIZE) {
+        bucket = PBIO_MOTOR_PROCESS_HISTOGRAM_SIZE - 1;
+    }
+    stats.latency_histogram[bucket]++;
+}
+
+/**
+ * Records the end of a control loop iteration.
+ *
+ * @param [in]  start       Time at which the iteration started, in us.
+ * @param [in]  missed      Whether the next iteration is already late.
+ */
+static void pbio_motor_process_stats_end(uint32_t start, bool missed) {
+    stats.exec_time_last = pbdrv_clock_get_us() - start;
+    if (stats.exec_time_last > stats.exec_time_max) {
+        stats.exec_time_max = stats.exec_time_last;
+    }
+    if (missed) {
+        stats.num_missed++;
+    }
+}
+
+#endif // PBIO_CONFIG_MOTOR_PROCESS_STATS
+
 static pbio_os_process_t pbio_motor_process;
 
 static pbio_error_t pbio_motor_process_thread(pbio_os_state_t *state, void *context) {
@@ -23,6 +88,12 @@ static pbio_error_t pbio_motor_process_thread(pbio_os_state_t *state, void *cont
     timer.duration = PBIO_CONFIG_CONTROL_LOOP_TIME_MS;
 
     for (;;) {
+
+        #if PBIO_CONFIG_MOTOR_PROCESS_STATS
+        uint32_t start = pbdrv_clock_get_us();
+        pbio_motor_process_stats_start(timer.start + timer.duration, start);
+        #endif
+
         // Update drivebase
         pbio_drivebase_update_all();
 
@@ -33,6 +104,10 @@ static pbio_error_t pbio_motor_process_thread(pbio_os_state_t *state, void *cont
         // loop time closer to the target on average.
         timer.start += PBIO_CONFIG_CONTROL_LOOP_TIME_MS;
 
+        #if PBIO_CONFIG_MOTOR_PROCESS_STATS
+        pbio_motor_process_stats_end(start, pbio_os_timer_is_expired(&timer));
+        #endif
+
         // In the rare case that polling was delayed too long, we need to
         // ensure that the next poll is a minimum of 1ms in the future so we
         // don't have 0 time deltas in the control code.
@@ -40,7 +115,7 @@ static pbio_error_t pbio_motor_process_thread(pbio_os_state_t *state, void *cont
             timer.start++;
         }
 
-        PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_is_expired(&timer));
+        PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_await(&timer));
     }
 
     // Unreachable.
@@ -48,7 +123,7 @@ static pbio_error_t pbio_motor_process_thread(pbio_os_state_t *state, void *cont
 }
 
 void pbio_motor_process_start(void) {
-    pbio_os_process_start(&pbio_motor_process, pbio_motor_process_thread, NULL);
+    pbio_os_process_start_on_event(&pbio_motor_process, pbio_motor_process_thread, NULL);
 }
 
 #endif // PBIO_CONFIG_MOTOR_PROCESS
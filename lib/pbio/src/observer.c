@@ -113,13 +113,15 @@ static void update_stall_state(pbio_observer_t *obs, uint32_t time, pbio_dcmotor
  */
 static int32_t pbio_observer_get_feedback_voltage_abs(int32_t error, const pbio_observer_settings_t *s) {
 
+    static const pbio_int_math_reciprocal_t per_thousand = PBIO_INT_MATH_RECIPROCAL(1000);
+
     // Feedback voltage in first region is just linear in the low gain.
     if (error <= s->feedback_gain_threshold) {
-        return error * s->feedback_gain_low / 1000;
+        return pbio_int_math_div_reciprocal(error * s->feedback_gain_low, &per_thousand);
     }
 
     // High region adds the increased gain for anything above the higher threshold.
-    return (s->feedback_gain_threshold * s->feedback_gain_low + (error - s->feedback_gain_threshold) * s->feedback_gain_high) / 1000;
+    return pbio_int_math_div_reciprocal(s->feedback_gain_threshold * s->feedback_gain_low + (error - s->feedback_gain_threshold) * s->feedback_gain_high, &per_thousand);
 }
 
 /**
@@ -182,25 +184,25 @@ void pbio_observer_update(pbio_observer_t *obs, uint32_t time, const pbio_angle_
     // mode is coast, back EMF is slightly overestimated, but an accurate
     // speed value is typically not needed in that use case.
     pbio_angle_add_mdeg(&obs->angle,
-        PRESCALE_SPEED * obs->speed / m->d_angle_d_speed +
-        PRESCALE_CURRENT * obs->current / m->d_angle_d_current +
-        PRESCALE_VOLTAGE * model_voltage / m->d_angle_d_voltage +
-        PRESCALE_TORQUE * torque / m->d_angle_d_torque);
+        pbio_int_math_div_reciprocal(PRESCALE_SPEED * obs->speed, &m->d_angle_d_speed) +
+        pbio_int_math_div_reciprocal(PRESCALE_CURRENT * obs->current, &m->d_angle_d_current) +
+        pbio_int_math_div_reciprocal(PRESCALE_VOLTAGE * model_voltage, &m->d_angle_d_voltage) +
+        pbio_int_math_div_reciprocal(PRESCALE_TORQUE * torque, &m->d_angle_d_torque));
     int32_t speed_next = pbio_int_math_clamp(0 +
-        PRESCALE_SPEED * obs->speed / m->d_speed_d_speed +
-        PRESCALE_CURRENT * obs->current / m->d_speed_d_current +
-        PRESCALE_VOLTAGE * model_voltage / m->d_speed_d_voltage +
-        PRESCALE_TORQUE * torque / m->d_speed_d_torque, MAX_NUM_SPEED);
+        pbio_int_math_div_reciprocal(PRESCALE_SPEED * obs->speed, &m->d_speed_d_speed) +
+        pbio_int_math_div_reciprocal(PRESCALE_CURRENT * obs->current, &m->d_speed_d_current) +
+        pbio_int_math_div_reciprocal(PRESCALE_VOLTAGE * model_voltage, &m->d_speed_d_voltage) +
+        pbio_int_math_div_reciprocal(PRESCALE_TORQUE * torque, &m->d_speed_d_torque), MAX_NUM_SPEED);
     int32_t current_next = pbio_int_math_clamp(0 +
-        PRESCALE_SPEED * obs->speed / m->d_current_d_speed +
-        PRESCALE_CURRENT * obs->current / m->d_current_d_current +
-        PRESCALE_VOLTAGE * model_voltage / m->d_current_d_voltage +
-        PRESCALE_TORQUE * torque / m->d_current_d_torque, MAX_NUM_CURRENT);
+        pbio_int_math_div_reciprocal(PRESCALE_SPEED * obs->speed, &m->d_current_d_speed) +
+        pbio_int_math_div_reciprocal(PRESCALE_CURRENT * obs->current, &m->d_current_d_current) +
+        pbio_int_math_div_reciprocal(PRESCALE_VOLTAGE * model_voltage, &m->d_current_d_voltage) +
+        pbio_int_math_div_reciprocal(PRESCALE_TORQUE * torque, &m->d_current_d_torque), MAX_NUM_CURRENT);
 
     // In case of a speed transition through zero, undo (subtract) the effect
     // of friction, to avoid inducing chatter in the speed signal.
     if ((obs->speed < 0) != (speed_next < 0)) {
-        speed_next -= PRESCALE_TORQUE * coulomb_friction / m->d_speed_d_torque;
+        speed_next -= pbio_int_math_div_reciprocal(PRESCALE_TORQUE * coulomb_friction, &m->d_speed_d_torque);
     }
 
     // Save new state.
@@ -250,8 +252,8 @@ int32_t pbio_observer_get_max_torque(void) {
 int32_t pbio_observer_get_feedforward_torque(const pbio_observer_model_t *model, int32_t rate_ref, int32_t acceleration_ref) {
 
     int32_t friction_compensation_torque = model->torque_friction / 2 * pbio_int_math_sign(rate_ref);
-    int32_t back_emf_compensation_torque = PRESCALE_SPEED * pbio_int_math_clamp(rate_ref, MAX_NUM_SPEED) / model->d_torque_d_speed;
-    int32_t acceleration_torque = PRESCALE_ACCELERATION * pbio_int_math_clamp(acceleration_ref, MAX_NUM_ACCELERATION) / model->d_torque_d_acceleration;
+    int32_t back_emf_compensation_torque = pbio_int_math_div_reciprocal(PRESCALE_SPEED * pbio_int_math_clamp(rate_ref, MAX_NUM_SPEED), &model->d_torque_d_speed);
+    int32_t acceleration_torque = pbio_int_math_div_reciprocal(PRESCALE_ACCELERATION * pbio_int_math_clamp(acceleration_ref, MAX_NUM_ACCELERATION), &model->d_torque_d_acceleration);
 
     // Total feedforward torque
     return pbio_int_math_clamp(friction_compensation_torque + back_emf_compensation_torque + acceleration_torque, MAX_NUM_TORQUE);
@@ -265,7 +267,7 @@ int32_t pbio_observer_get_feedforward_torque(const pbio_observer_model_t *model,
  * @returns                         The voltage in mV.
 */
 int32_t pbio_observer_torque_to_voltage(const pbio_observer_model_t *model, int32_t desired_torque) {
-    return PRESCALE_TORQUE * pbio_int_math_clamp(desired_torque, MAX_NUM_TORQUE) / model->d_voltage_d_torque;
+    return pbio_int_math_div_reciprocal(PRESCALE_TORQUE * pbio_int_math_clamp(desired_torque, MAX_NUM_TORQUE), &model->d_voltage_d_torque);
 }
 
 /**
@@ -276,5 +278,5 @@ int32_t pbio_observer_torque_to_voltage(const pbio_observer_model_t *model, int3
  * @returns                         The torque in uNm.
 */
 int32_t pbio_observer_voltage_to_torque(const pbio_observer_model_t *model, int32_t voltage) {
-    return PRESCALE_VOLTAGE * pbio_int_math_clamp(voltage, MAX_NUM_VOLTAGE) / model->d_torque_d_voltage;
+    return pbio_int_math_div_reciprocal(PRESCALE_VOLTAGE * pbio_int_math_clamp(voltage, MAX_NUM_VOLTAGE), &model->d_torque_d_voltage);
 }
@@ -15,6 +15,7 @@
  * Sets the timer to expire after the specified duration.
  *
  * The 1ms interrupt polls all processes, so no special events are needed.
+ * Event driven processes should use ::pbio_os_timer_await to wait for it.
  *
  * @param timer     The timer to initialize.
  * @param duration  The duration in milliseconds.
@@ -57,17 +58,252 @@ bool pbio_os_timer_is_expired(pbio_os_timer_t *timer) {
 }
 
 /**
- * Whether a poll request is pending.
+ * Whether a broadcast poll request is pending.
  */
 static volatile bool poll_request_is_pending = false;
 
+/**
+ * Queue of processes with a pending targeted poll request.
+ */
+static pbio_os_process_t *ready_head = NULL;
+static pbio_os_process_t *ready_tail = NULL;
+
+/**
+ * The process whose thread is currently running, if any.
+ */
+static pbio_os_process_t *current_process = NULL;
+
+static pbio_os_stats_t stats;
+
+/**
+ * Gets statistics about the event loop.
+ *
+ * @return          The statistics.
+ */
+const pbio_os_stats_t *pbio_os_get_stats(void) {
+    return &stats;
+}
+
+/**
+ * Processes awaiting a timer, sorted by the time at which they should be
+ * polled, earliest first.
+ */
+static pbio_os_process_t *timer_queue = NULL;
+
+/**
+ * Removes a process from the timer queue if it is in it.
+ *
+ * @param process   The process.
+ */
+static void timer_queue_remove(pbio_os_process_t *process) {
+    if (!process->wake_time_armed) {
+        return;
+    }
+
+    for (pbio_os_process_t **pp = &timer_queue; *pp; pp = &(*pp)->next_wake) {
+        if (*pp == process) {
+            *pp = process->next_wake;
+            break;
+        }
+    }
+    process->wake_time_armed = false;
+}
+
+/**
+ * Inserts or moves a process in the timer queue.
+ *
+ * @param process   The process.
+ * @param wake_time Time at which the process should be polled.
+ */
+static void timer_queue_insert(pbio_os_process_t *process, uint32_t wake_time) {
+    timer_queue_remove(process);
+
+    // Insert after all processes that need to wake up at the same time or
+    // earlier, so processes with equal deadlines run in order of arrival.
+    pbio_os_process_t **pp = &timer_queue;
+    while (*pp && pbio_util_time_has_passed(wake_time, (*pp)->wake_time)) {
+        pp = &(*pp)->next_wake;
+    }
+    process->next_wake = *pp;
+    *pp = process;
+    process->wake_time = wake_time;
+    process->wake_time_armed = true;
+}
+
+/**
+ * Polls all processes whose timer has expired and removes them from the
+ * timer queue.
+ *
+ * Reads the clock only once, regardless of the number of processes.
+ */
+static void timer_queue_poll_expired(void) {
+
+    if (!timer_queue) {
+        return;
+    }
+
+    uint32_t now = pbdrv_clock_get_ms();
+
+    while (timer_queue && pbio_util_time_has_passed(now, timer_queue->wake_time)) {
+        pbio_os_process_t *process = timer_queue;
+        timer_queue = process->next_wake;
+        process->wake_time_armed = false;
+        pbio_os_process_request_poll(process);
+    }
+}
+
+/**
+ * Whether code outside of processes requested a wakeup at ::wakeup_time.
+ */
+static bool wakeup_requested;
+static uint32_t wakeup_time;
+
+/**
+ * Requests that the system does not sleep past the given time.
+ *
+ * Processes do not need this because they use ::pbio_os_timer_await. This is
+ * for application code that waits by polling the clock in a loop.
+ *
+ * @param [in]  time    The time by which the system should be awake.
+ */
+void pbio_os_request_wakeup(uint32_t time) {
+    if (!wakeup_requested || pbio_util_time_has_passed(wakeup_time, time)) {
+        wakeup_time = time;
+    }
+    wakeup_requested = true;
+}
+
+/**
+ * Gets the earliest time at which a process awaits a timer or at which a
+ * wakeup was requested.
+ *
+ * This may be used to decide how long the system can sleep. It may be earlier
+ * than strictly needed, but never later.
+ *
+ * @param [out] deadline  The earliest deadline.
+ * @return                Whether there is any deadline.
+ */
+bool pbio_os_timer_get_next_deadline(uint32_t *deadline) {
+
+    // Wakeup requests are one-shot, so drop them once they have passed.
+    if (wakeup_requested && pbio_util_time_has_passed(pbdrv_clock_get_ms(), wakeup_time)) {
+        wakeup_requested = false;
+    }
+
+    if (!timer_queue && !wakeup_requested) {
+        return false;
+    }
+
+    if (!timer_queue) {
+        *deadline = wakeup_time;
+    } else if (!wakeup_requested || pbio_util_time_has_passed(wakeup_time, timer_queue->wake_time)) {
+        *deadline = timer_queue->wake_time;
+    } else {
+        *deadline = wakeup_time;
+    }
+    return true;
+}
+
+/**
+ * Whether the timer has expired, for use in protothreads that are about to
+ * yield until it does.
+ *
+ * If it has not expired, the calling process is added to the timer queue so
+ * that it is polled again as soon as the timer expires. This is what wakes up
+ * processes started with ::pbio_os_process_start_on_event.
+ *
+ * @param timer     The timer to check.
+ * @return          Whether the timer has expired.
+ */
+bool pbio_os_timer_await(pbio_os_timer_t *timer) {
+    if (pbio_os_timer_is_expired(timer)) {
+        return true;
+    }
+
+    pbio_os_process_t *process = current_process;
+    if (!process) {
+        return false;
+    }
+
+    uint32_t wake_time = timer->start + timer->duration;
+
+    // If several timers are awaited, wake up for the earliest one.
+    if (process->wake_time_awaited && pbio_util_time_has_passed(wake_time, process->wake_time)) {
+        return false;
+    }
+    process->wake_time_awaited = true;
+
+    // Usually it is the same timer as on the previous iteration, in which
+    // case it is already in the right place.
+    if (!process->wake_time_armed || process->wake_time != wake_time) {
+        timer_queue_insert(process, wake_time);
+    }
+    return false;
+}
+
 /**
  * Request that the event loop polls all processes.
+ *
+ * Processes started with ::pbio_os_process_start_on_event are only included
+ * if they are waiting for a timer that has expired.
  */
 void pbio_os_request_poll(void) {
     poll_request_is_pending = true;
 }
 
+/**
+ * Request that the event loop polls one process.
+ *
+ * This may be called from interrupt context.
+ *
+ * @param process   The process to poll.
+ */
+void pbio_os_process_request_poll(pbio_os_process_t *process) {
+
+    // Processes that are not event driven run on every broadcast poll anyway.
+    if (!process->on_event) {
+        pbio_os_request_poll();
+        return;
+    }
+
+    pbio_os_irq_flags_t irq_flags = pbio_os_hook_disable_irq();
+
+    if (!process->poll_pending) {
+        process->poll_pending = true;
+        process->next_ready = NULL;
+        if (ready_tail) {
+            ready_tail->next_ready = process;
+        } else {
+            ready_head = process;
+        }
+        ready_tail = process;
+    }
+
+    pbio_os_hook_enable_irq(irq_flags);
+}
+
+/**
+ * Takes the first process from the queue of processes to poll.
+ *
+ * @return          The process or NULL if the queue is empty.
+ */
+static pbio_os_process_t *pop_ready_process(void) {
+
+    pbio_os_irq_flags_t irq_flags = pbio_os_hook_disable_irq();
+
+    pbio_os_process_t *process = ready_head;
+    if (process) {
+        ready_head = process->next_ready;
+        if (!ready_head) {
+            ready_tail = NULL;
+        }
+        process->poll_pending = false;
+    }
+
+    pbio_os_hook_enable_irq(irq_flags);
+
+    return process;
+}
 
 /**
  * Placeholder thread that does nothing and never completes.
@@ -115,11 +351,36 @@ void pbio_os_process_start(pbio_os_process_t *process, pbio_os_process_func_t fu
     process->state = 0;
     process->request = PBIO_OS_PROCESS_REQUEST_TYPE_NONE;
     process->func = func;
+    process->on_event = false;
+    timer_queue_remove(process);
 
     // Request a poll to start the process soon, running to its first yield.
     pbio_os_request_poll();
 }
 
+/**
+ * Like ::pbio_os_process_start, but the process is not run on every broadcast
+ * poll request such as the periodic clock tick.
+ *
+ * Instead, it runs only when polled with ::pbio_os_process_request_poll, when
+ * a request is made to it, or when a timer it awaits with ::PBIO_OS_AWAIT_MS
+ * or ::pbio_os_timer_await expires. This is only suitable for processes that
+ * do not wait for other conditions to become true.
+ *
+ * Running such a process does not poll the other processes. If it changes
+ * something that other processes wait for, it must call
+ * ::pbio_os_request_poll or ::pbio_os_process_request_poll itself.
+ *
+ * @param process   The process to start. Can be an existing process which will be reset.
+ * @param func      The process thread function.
+ * @param context   The context to pass to the process.
+ */
+void pbio_os_process_start_on_event(pbio_os_process_t *process, pbio_os_process_func_t func, void *context) {
+    pbio_os_process_start(process, func, context);
+    process->on_event = true;
+    pbio_os_process_request_poll(process);
+}
+
 /**
  * Makes a request to a process.
  *
@@ -131,11 +392,35 @@ void pbio_os_process_start(pbio_os_process_t *process, pbio_os_process_func_t fu
  */
 void pbio_os_process_make_request(pbio_os_process_t *process, pbio_os_process_request_type_t request) {
     process->request = request;
-    pbio_os_request_poll();
+    pbio_os_process_request_poll(process);
 }
 
 /**
- * Drives the event loop once: Runs one iteration of all processes.
+ * Runs one iteration of the process if not yet completed or errored.
+ *
+ * @param process   The process to run.
+ */
+static void run_process(pbio_os_process_t *process) {
+    if (process->err != PBIO_ERROR_AGAIN) {
+        return;
+    }
+
+    process->wake_time_awaited = false;
+
+    current_process = process;
+    process->err = process->func(&process->state, process->context);
+    current_process = NULL;
+    stats.num_runs++;
+
+    // Drop the deadline if the process is no longer waiting for it.
+    if (!process->wake_time_awaited) {
+        timer_queue_remove(process);
+    }
+}
+
+/**
+ * Drives the event loop once: Runs one iteration of all processes that have
+ * a pending poll request.
  *
  * Can be used in hooks from blocking loops.
  *
@@ -143,23 +428,42 @@ void pbio_os_process_make_request(pbio_os_process_t *process, pbio_os_process_re
  */
 bool pbio_os_run_processes_once(void) {
 
-    if (!poll_request_is_pending) {
+    if (!poll_request_is_pending && !ready_head) {
         return false;
     }
 
-    poll_request_is_pending = false;
+    pbio_os_process_t *process;
+
+    if (poll_request_is_pending) {
+        poll_request_is_pending = false;
+
+        // Event driven processes only need to run if their timer expired.
+        timer_queue_poll_expired();
+
+        for (process = process_list; process; process = process->next) {
+            if (process->on_event) {
+                if (!process->poll_pending && process->err == PBIO_ERROR_AGAIN) {
+                    stats.num_skipped++;
+                }
+                continue;
+            }
+            run_process(process);
+        }
+    }
 
-    pbio_os_process_t *process = process_list;
-    while (process) {
-        // Run one iteration of the process if not yet completed or errored.
-        if (process->err == PBIO_ERROR_AGAIN) {
-            process->err = process->func(&process->state, process->context);
+    // Run the processes that were polled directly. Processes that are polled
+    // again while running are handled on the next call. The full list is only
+    // walked again if one of them made a broadcast poll request.
+    pbio_os_process_t *last = ready_tail;
+    while (last && (process = pop_ready_process())) {
+        run_process(process);
+        if (process == last) {
+            break;
         }
-        process = process->next;
     }
 
     // Poll requests may have been set while running the processes.
-    return poll_request_is_pending;
+    return poll_request_is_pending || ready_head;
 }
 
 /**
@@ -182,7 +486,7 @@ void pbio_os_run_processes_and_wait_for_event(void) {
     // otherwise disabled.
     pbio_os_irq_flags_t irq_flags = pbio_os_hook_disable_irq();
 
-    if (!poll_request_is_pending) {
+    if (!poll_request_is_pending && !ready_head) {
         pbio_os_hook_wait_for_interrupt(irq_flags);
     }
     pbio_os_hook_enable_irq(irq_flags);
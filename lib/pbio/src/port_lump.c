@@ -151,6 +151,14 @@ struct _pbio_port_lump_dev_t {
      * the values could be foreign-endian.
      */
     uint8_t *bin_data;
+    /** Timer used to detect that the device stopped sending data. */
+    pbio_os_timer_t rx_timer;
+    #if PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES
+    /** Ring buffer of recently received data samples. */
+    pbio_port_lump_sample_t *samples;
+    /** Total number of samples received. Not reset on reconnect, so that cursors stay valid. */
+    uint32_t sample_count;
+    #endif
     /**
      * NB: Everything below is reset to 0 when synchronizing with a new device.
      *     type_id field should remain first.
@@ -177,6 +185,10 @@ struct _pbio_port_lump_dev_t {
     uint32_t err_count;
     /** Flag that indicates that good DATA lump_dev->msg has been received since last watchdog timeout. */
     bool data_rec;
+    /** Number of times the data stream was out of sync with message headers. */
+    uint32_t rx_resync_count;
+    /** Number of received bytes discarded while resynchronizing. */
+    uint32_t rx_dropped_bytes;
     /** Angle reported by the device. */
     pbio_angle_t angle;
     #if PBIO_CONFIG_PORT_LUMP_MODE_INFO
@@ -204,6 +216,9 @@ static uint8_t bufs[PBIO_CONFIG_PORT_LUMP_NUM_DEV][NUM_BUF][EV3_UART_MAX_MESSAGE
 // The following data is really just part of lump_devices, but separate allocation reduces overal code size
 static uint8_t data_read_bufs[PBIO_CONFIG_PORT_LUMP_NUM_DEV][LUMP_MAX_MSG_SIZE] __attribute__((aligned(4)));
 static pbdrv_legodev_lump_data_set_t data_set_bufs[PBIO_CONFIG_PORT_LUMP_NUM_DEV];
+#if PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES
+static pbio_port_lump_sample_t sample_bufs[PBIO_CONFIG_PORT_LUMP_NUM_DEV][PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES];
+#endif
 
 pbio_port_lump_dev_t *pbio_port_lump_init_instance(uint8_t device_index) {
     if (device_index >= PBIO_CONFIG_PORT_LUMP_NUM_DEV) {
@@ -216,6 +231,9 @@ pbio_port_lump_dev_t *pbio_port_lump_init_instance(uint8_t device_index) {
     lump_dev->err_count = 0;
     lump_dev->data_set = &data_set_bufs[device_index];
     lump_dev->bin_data = data_read_bufs[device_index];
+    #if PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES
+    lump_dev->samples = sample_bufs[device_index];
+    #endif
     return lump_dev;
 }
 
@@ -653,6 +671,16 @@ static void pbio_port_lump_lump_parse_msg(pbio_port_lump_dev_t *lump_dev) {
             lump_dev->mode = mode;
             pbio_port_lump_handle_known_data(lump_dev);
 
+            #if PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES
+            // Keep timestamped copy of the data.
+            pbio_port_lump_sample_t *sample = &lump_dev->samples[lump_dev->sample_count % PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES];
+            sample->time = pbdrv_clock_get_ms();
+            sample->mode = mode;
+            sample->size = msg_size - 2;
+            memcpy(sample->data, lump_dev->rx_msg + 1, msg_size - 2);
+            lump_dev->sample_count++;
+            #endif
+
             lump_dev->data_rec = true;
             break;
     }
@@ -926,7 +954,7 @@ pbio_error_t pbio_port_lump_data_send_thread(pbio_os_state_t *state, pbio_port_l
 
     for (;;) {
 
-        PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_is_expired(timer) || lump_dev->mode_switch.requested || lump_dev->data_set->size > 0);
+        PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_await(timer) || lump_dev->mode_switch.requested || lump_dev->data_set->size > 0);
 
         // Handle keep alive timeout
         if (pbio_os_timer_is_expired(timer)) {
@@ -985,11 +1013,78 @@ pbio_error_t pbio_port_lump_data_send_thread(pbio_os_state_t *state, pbio_port_l
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
 
+/**
+ * Checks if a message header is valid for a message received while in data mode.
+ *
+ * @param [in]  header      The first byte of the message.
+ * @return                  True if the header starts a data message or a supported command.
+ */
+static bool pbio_port_lump_is_data_header(uint8_t header) {
+    uint8_t size = ev3_uart_get_msg_size(header);
+    if (size < 3 || size > EV3_UART_MAX_MESSAGE_SIZE) {
+        return false;
+    }
+    uint8_t msg_type = header & LUMP_MSG_TYPE_MASK;
+    uint8_t cmd = header & LUMP_MSG_CMD_MASK;
+    return msg_type == LUMP_MSG_TYPE_DATA || (msg_type == LUMP_MSG_TYPE_CMD &&
+                                              (cmd == LUMP_CMD_WRITE || cmd == LUMP_CMD_EXT_MODE));
+}
+
+/**
+ * Parses all complete messages that are waiting in the UART receive buffer.
+ *
+ * Bytes that do not start a valid message are discarded one at a time until
+ * the stream is back in sync. If the last message is incomplete, it is left
+ * in the buffer and lump_dev->rx_msg_size is set to the number of bytes
+ * needed to parse it.
+ *
+ * @param [in]  lump_dev       The LEGO UART device instance.
+ * @param [in]  uart_dev       The UART device instance.
+ */
+static void pbio_port_lump_data_recv_process(pbio_port_lump_dev_t *lump_dev, pbdrv_uart_dev_t *uart_dev) {
+
+    bool in_sync = true;
+    uint8_t header;
+
+    while (pbdrv_uart_peek(uart_dev, 0, &header, 1) == 1) {
+
+        if (!pbio_port_lump_is_data_header(header)) {
+            debug_pr("Bad data message header\n");
+            if (in_sync) {
+                lump_dev->rx_resync_count++;
+                in_sync = false;
+            }
+            lump_dev->rx_dropped_bytes++;
+            pbdrv_uart_skip(uart_dev, 1);
+            continue;
+        }
+        in_sync = true;
+
+        // Wait for the rest of the message if it has not arrived yet.
+        lump_dev->rx_msg_size = ev3_uart_get_msg_size(header);
+        if (pbdrv_uart_in_waiting(uart_dev) < lump_dev->rx_msg_size) {
+            return;
+        }
+
+        // At this point, we have a full message that can be parsed.
+        pbdrv_uart_peek(uart_dev, 0, lump_dev->rx_msg, lump_dev->rx_msg_size);
+        pbdrv_uart_skip(uart_dev, lump_dev->rx_msg_size);
+        pbio_port_lump_lump_parse_msg(lump_dev);
+    }
+
+    // Buffer is empty, so wait for the next header.
+    lump_dev->rx_msg_size = 1;
+}
+
 /**
  * The receive thread for the LEGO UART device.
  *
  * Responsible for receiving data messages and updating mode switch completion state.
  *
+ * Instead of reading each message with separate UART transactions, this
+ * waits for data to arrive and then parses all complete messages in the
+ * receive buffer at once.
+ *
  * @param [in]  state          The protothread state.
  * @param [in]  lump_dev       The LEGO UART device instance.
  * @param [in]  uart_dev       The UART device instance.
@@ -1000,49 +1095,39 @@ pbio_error_t pbio_port_lump_data_recv_thread(pbio_os_state_t *state, pbio_port_l
         return PBIO_ERROR_INVALID_OP;
     }
 
-    pbio_error_t err;
-
-    // REVISIT: This is not the greatest. We can easily get a buffer overrun and
-    // loose data. For now, the retry after bad message size helps get back into
-    // sync with the data stream.
-
     PBIO_OS_ASYNC_BEGIN(state);
 
-    while (true) {
-        PBIO_OS_AWAIT(state, &lump_dev->read_pt, err = pbdrv_uart_read(&lump_dev->read_pt, uart_dev, lump_dev->rx_msg, 1, EV3_UART_IO_TIMEOUT));
-        if (err != PBIO_SUCCESS) {
-            debug_pr("UART Rx data header end error\n");
-            return err;
-        }
-
-        lump_dev->rx_msg_size = ev3_uart_get_msg_size(lump_dev->rx_msg[0]);
-        if (lump_dev->rx_msg_size < 3 || lump_dev->rx_msg_size > EV3_UART_MAX_MESSAGE_SIZE) {
-            debug_pr("Bad data message size\n");
-            continue;
-        }
-
-        uint8_t msg_type = lump_dev->rx_msg[0] & LUMP_MSG_TYPE_MASK;
-        uint8_t cmd = lump_dev->rx_msg[0] & LUMP_MSG_CMD_MASK;
-        if (msg_type != LUMP_MSG_TYPE_DATA && (msg_type != LUMP_MSG_TYPE_CMD ||
-                                               (cmd != LUMP_CMD_WRITE && cmd != LUMP_CMD_EXT_MODE))) {
-            debug_pr("Bad msg type\n");
-            continue;
-        }
+    lump_dev->rx_msg_size = 1;
 
-        PBIO_OS_AWAIT(state, &lump_dev->read_pt, err = pbdrv_uart_read(&lump_dev->read_pt, uart_dev, lump_dev->rx_msg + 1, lump_dev->rx_msg_size - 1, EV3_UART_IO_TIMEOUT));
-        if (err != PBIO_SUCCESS) {
-            debug_pr("UART Rx data end error\n");
-            return err;
+    while (true) {
+        // Wait until the pending message is complete, or at least one byte
+        // has arrived if we are waiting for a new message.
+        pbio_os_timer_set(&lump_dev->rx_timer, EV3_UART_IO_TIMEOUT);
+        PBIO_OS_AWAIT_UNTIL(state, pbdrv_uart_in_waiting(uart_dev) >= lump_dev->rx_msg_size || pbio_os_timer_await(&lump_dev->rx_timer));
+        if (pbdrv_uart_in_waiting(uart_dev) < lump_dev->rx_msg_size) {
+            debug_pr("UART Rx data timeout\n");
+            return PBIO_ERROR_TIMEDOUT;
         }
 
-        // at this point, we have a full lump_dev->msg that can be parsed
-        pbio_port_lump_lump_parse_msg(lump_dev);
+        pbio_port_lump_data_recv_process(lump_dev, uart_dev);
     }
 
     // Unreachable.
     PBIO_OS_ASYNC_END(PBIO_ERROR_FAILED);
 }
 
+/**
+ * Gets receive statistics of the data stream since the device was connected.
+ *
+ * @param [in]  lump_dev       The LEGO UART device instance.
+ * @param [out] resync_count   Number of times the parser had to resynchronize with the data stream.
+ * @param [out] dropped_bytes  Number of bytes discarded while resynchronizing.
+ */
+void pbio_port_lump_get_rx_stats(pbio_port_lump_dev_t *lump_dev, uint32_t *resync_count, uint32_t *dropped_bytes) {
+    *resync_count = lump_dev->rx_resync_count;
+    *dropped_bytes = lump_dev->rx_dropped_bytes;
+}
+
 /**
  * Gets the size of a data type.
  *
@@ -1205,6 +1290,63 @@ pbio_error_t pbio_port_lump_get_data(pbio_port_lump_dev_t *lump_dev, uint8_t mod
     return pbio_port_lump_is_ready(lump_dev);
 }
 
+#if PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES
+
+/**
+ * Gets the cursor that refers to the next data sample to be received.
+ *
+ * Use this with ::pbio_port_lump_get_sample to get only samples that are
+ * received from now on.
+ *
+ * @param [in]  lump_dev    The LEGO UART device instance.
+ * @return                  The cursor.
+ */
+uint32_t pbio_port_lump_get_sample_cursor(pbio_port_lump_dev_t *lump_dev) {
+    return lump_dev ? lump_dev->sample_count : 0;
+}
+
+/**
+ * Gets the oldest data sample at or after the given cursor and advances the
+ * cursor past it.
+ *
+ * Only the most recent ::PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES samples are kept.
+ * If the cursor refers to a sample that was already overwritten, the oldest
+ * sample that is still available is returned instead.
+ *
+ * The sample remains valid until that many new samples have been received,
+ * so it should be used right away.
+ *
+ * @param [in]  lump_dev    The LEGO UART device instance.
+ * @param [in, out] cursor  Cursor of the sample to get. Advanced to the next sample on success.
+ * @param [out] sample      The sample.
+ * @return                  ::PBIO_SUCCESS on success.
+ *                          ::PBIO_ERROR_NO_DEV if the port does not have a device attached.
+ *                          ::PBIO_ERROR_AGAIN if no new sample has been received yet.
+ */
+pbio_error_t pbio_port_lump_get_sample(pbio_port_lump_dev_t *lump_dev, uint32_t *cursor, const pbio_port_lump_sample_t **sample) {
+
+    if (!lump_dev) {
+        return PBIO_ERROR_NO_DEV;
+    }
+
+    // Wait for new data.
+    uint32_t pending = lump_dev->sample_count - *cursor;
+    if (pending == 0) {
+        return PBIO_ERROR_AGAIN;
+    }
+
+    // Skip samples that have already been overwritten.
+    if (pending > PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES) {
+        *cursor = lump_dev->sample_count - PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES;
+    }
+
+    *sample = &lump_dev->samples[*cursor % PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES];
+    (*cursor)++;
+    return PBIO_SUCCESS;
+}
+
+#endif // PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES
+
 /**
  * Set data for the current mode.
  *
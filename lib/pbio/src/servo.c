@@ -22,6 +22,22 @@
 // Servo motor objects
 static pbio_servo_t servos[PBIO_CONFIG_SERVO_NUM_DEV];
 
+#if PBIO_CONFIG_LOGGER
+// Names and scales of the values logged in pbio_servo_update.
+const pbio_logger_column_t pbio_servo_logger_columns[PBIO_SERVO_LOGGER_NUM_COLS] = {
+    { .name = "time", .scale = 10000 },
+    { .name = "angle", .scale = 1 },
+    { .name = "speed", .scale = 1 },
+    { .name = "actuation", .scale = 1 },
+    { .name = "voltage", .scale = 1000 },
+    { .name = "angle_est", .scale = 1 },
+    { .name = "speed_est", .scale = 1 },
+    { .name = "torque_feedback", .scale = 1000000 },
+    { .name = "torque_feedforward", .scale = 1000000 },
+    { .name = "voltage_observer", .scale = 1000 },
+};
+#endif // PBIO_CONFIG_LOGGER
+
 
 /**
  * Initializes servo state structure.
@@ -86,6 +102,14 @@ static pbio_error_t pbio_servo_update(pbio_servo_t *srv) {
     // Check if a control update is needed
     if (pbio_control_is_active(&srv->control)) {
 
+        // Start the next queued maneuver right when the ongoing one ends.
+        if (pbio_control_queue_is_due(&srv->control, time_now)) {
+            err = pbio_control_queue_start_next(&srv->control, time_now);
+            if (err != PBIO_SUCCESS) {
+                return err;
+            }
+        }
+
         // Calculate feedback control signal
         pbio_dcmotor_actuation_t requested_actuation;
         bool external_pause = false;
@@ -778,6 +802,42 @@ pbio_error_t pbio_servo_run_angle(pbio_servo_t *srv, int32_t speed, int32_t angl
     return pbio_control_start_position_control_relative(&srv->control, time_now, &state, angle, speed, on_completion, true);
 }
 
+/**
+ * Queues a relative angle maneuver to start when the ongoing one ends.
+ *
+ * This uses the same sign conventions as ::pbio_servo_run_angle. The angle is
+ * relative to the end of the previous maneuver, so a sequence of queued
+ * maneuvers runs without waiting for the application in between. If no
+ * position maneuver is ongoing or the last one has already ended, this starts
+ * right away.
+ *
+ * @param [in]  srv            The control instance.
+ * @param [in]  speed          Top angular velocity in degrees per second. If zero, the angle is ignored.
+ * @param [in]  angle          Angle to run by.
+ * @param [in]  on_completion  What to do after reaching the final angle.
+ * @return                     Error code.
+ */
+pbio_error_t pbio_servo_queue_angle(pbio_servo_t *srv, int32_t speed, int32_t angle, pbio_control_on_completion_t on_completion) {
+
+    // Don't allow new user command if update loop not registered.
+    if (!pbio_servo_update_loop_is_running(srv)) {
+        return PBIO_ERROR_INVALID_OP;
+    }
+
+    // There is nothing to follow up on, so start now.
+    if (!pbio_control_queue_is_open(&srv->control, pbio_control_get_time_ticks())) {
+        return pbio_servo_run_angle(srv, speed, angle, on_completion);
+    }
+
+    // As in pbio_servo_run_angle, zero speed means the maneuver is done
+    // right away instead of blocking forever.
+    if (speed == 0) {
+        angle = 0;
+    }
+
+    return pbio_control_queue_position_control_relative(&srv->control, angle, speed, on_completion);
+}
+
 /**
  * Steers the servo to the given target and holds it there.
  *
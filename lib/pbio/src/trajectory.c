@@ -156,6 +156,39 @@ pbio_error_t pbio_trajectory_validate_acceleration_limit(int32_t ctl_steps_per_a
     return PBIO_SUCCESS;
 }
 
+/**
+ * Validates that the given acceleration smoothing is within the allowed range.
+ *
+ * @param [in] smoothing                Percentage of acceleration phases with changing acceleration.
+ * @return                              ::PBIO_SUCCESS on valid values.
+ *                                      ::PBIO_ERROR_INVALID_ARG if the argument is outside the allowed range.
+ */
+pbio_error_t pbio_trajectory_validate_smoothing(int32_t smoothing) {
+    if (smoothing < 0 || smoothing > PBIO_TRAJECTORY_SMOOTHING_MAX) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Reduces the acceleration limits of a command such that smoothed acceleration
+ * phases do not exceed the original limits.
+ *
+ * A smoothed acceleration phase ramps the acceleration up and down linearly
+ * during the first and last smoothing/2 percent of the phase. This is
+ * symmetric about the middle of the phase, so it covers the same angle in
+ * the same time as a phase with constant acceleration equal to the average.
+ * The trajectory is therefore computed as a trapezoid with this average
+ * acceleration, and only the evaluation of the reference differs.
+ *
+ * @param [in, out] c   The command to modify.
+ */
+static void pbio_trajectory_scale_for_smoothing(pbio_trajectory_command_t *c) {
+    assert(pbio_trajectory_validate_smoothing(c->smoothing) == PBIO_SUCCESS);
+    c->acceleration = pbio_int_math_mult_then_div(c->acceleration, 200 - c->smoothing, 200);
+    c->deceleration = pbio_int_math_mult_then_div(c->deceleration, 200 - c->smoothing, 200);
+}
+
 /**
  * Reverses a trajectory.
  *
@@ -679,10 +712,14 @@ static pbio_error_t pbio_trajectory_new_forward_angle_command(pbio_trajectory_t
  */
 void pbio_trajectory_stretch(pbio_trajectory_t *trj, const pbio_trajectory_t *leader) {
 
-    // Synchronize timestamps with leading trajectory.
+    // Parameters will change, so the next sample is evaluated from scratch.
+    trj->cache.valid = false;
+
+    // Synchronize timestamps and acceleration shape with leading trajectory.
     trj->t1 = leader->t1;
     trj->t2 = leader->t2;
     trj->t3 = leader->t3;
+    trj->smoothing = leader->smoothing;
 
     if (trj->t3 == 0) {
         // This is a stationary maneuver, so there's nothing to recompute.
@@ -726,6 +763,9 @@ pbio_error_t pbio_trajectory_new_time_command(pbio_trajectory_t *trj, const pbio
     // Copy the command so we can modify it.
     pbio_trajectory_command_t c = *command;
 
+    // Parameters will change, so the next sample is evaluated from scratch.
+    trj->cache.valid = false;
+
     // Return empty maneuver for zero time
     if (c.duration == 0) {
         c.speed_target = 0;
@@ -746,11 +786,15 @@ pbio_error_t pbio_trajectory_new_time_command(pbio_trajectory_t *trj, const pbio
     // Bind target speed by maximum speed.
     c.speed_target = pbio_int_math_min(c.speed_target, c.speed_max);
 
+    // Plan with the average acceleration of smoothed phases.
+    pbio_trajectory_scale_for_smoothing(&c);
+
     // Calculate the trajectory, assumed to be forward.
     pbio_error_t err = pbio_trajectory_new_forward_time_command(trj, &c);
     if (err != PBIO_SUCCESS) {
         return err;
     }
+    trj->smoothing = c.smoothing;
 
     // Reverse the maneuver if the original arguments imposed backward motion.
     if (backward) {
@@ -773,6 +817,9 @@ pbio_error_t pbio_trajectory_new_angle_command(pbio_trajectory_t *trj, const pbi
     // Copy the command so we can modify it.
     pbio_trajectory_command_t c = *command;
 
+    // Parameters will change, so the next sample is evaluated from scratch.
+    trj->cache.valid = false;
+
     // Return error for maneuver that is too long by angle.
     if (!pbio_angle_diff_is_small(&c.position_end, &c.position_start)) {
         return PBIO_ERROR_INVALID_ARG;
@@ -809,11 +856,15 @@ pbio_error_t pbio_trajectory_new_angle_command(pbio_trajectory_t *trj, const pbi
         c.speed_start *= -1;
     }
 
+    // Plan with the average acceleration of smoothed phases.
+    pbio_trajectory_scale_for_smoothing(&c);
+
     // Calculate the trajectory, assumed to be forward.
     pbio_error_t err = pbio_trajectory_new_forward_angle_command(trj, &c);
     if (err != PBIO_SUCCESS) {
         return err;
     }
+    trj->smoothing = c.smoothing;
 
     // Reverse the maneuver if the original arguments imposed backward motion.
     if (backward) {
@@ -914,66 +965,434 @@ uint32_t pbio_trajectory_get_duration(const pbio_trajectory_t *trj) {
 }
 
 /**
- * Gets the calculated reference speed and velocity of the trajectory at the (shifted) time.
+ * Gets the index of the trajectory segment at the given time.
  *
  * @param [in]  trj         The trajectory instance.
- * @param [in]  time_ref    The duration of time after the start of the trajectory in s*10^-4.
- * @param [out] ref         An uninitialized trajectory reference point to hold the result.
+ * @param [in]  time        The time since the start of the trajectory in s*10^-4.
+ * @returns                 0 for acceleration, 1 for constant speed, 2 for
+ *                          deceleration, and 3 for the final speed segment.
  */
-void pbio_trajectory_get_reference(pbio_trajectory_t *trj, uint32_t time_ref, pbio_trajectory_reference_t *ref) {
+static uint8_t pbio_trajectory_get_segment(const pbio_trajectory_t *trj, int32_t time) {
+    if (time - trj->t1 < 0 || (trj->t1 == 0 && time == 0)) {
+        return 0;
+    }
+    if (time - trj->t2 < 0) {
+        return 1;
+    }
+    if (time - trj->t3 < 0) {
+        return 2;
+    }
+    return 3;
+}
 
-    // Time within maneuver since start.
-    int32_t time = TO_TRAJECTORY_TIME(time_ref - trj->start.time);
-    assert_time(time);
+/**
+ * Gets the starting point and acceleration of a trajectory segment.
+ *
+ * @param [in]  trj         The trajectory instance.
+ * @param [in]  segment     The segment index.
+ * @param [out] t           The segment start time in s*10^-4.
+ * @param [out] th          The segment start angle in mdeg.
+ * @param [out] w           The segment start speed in ddeg/s.
+ * @param [out] a           The segment acceleration in deg/s^2.
+ */
+static void pbio_trajectory_get_segment_start(const pbio_trajectory_t *trj, uint8_t segment, int32_t *t, int32_t *th, int32_t *w, int32_t *a) {
+    switch (segment) {
+        case 0:
+            *t = 0;
+            *th = 0;
+            *w = trj->w0;
+            *a = trj->a0;
+            return;
+        case 1:
+            *t = trj->t1;
+            *th = trj->th1;
+            *w = trj->w1;
+            *a = 0;
+            return;
+        case 2:
+            *t = trj->t2;
+            *th = trj->th2;
+            *w = trj->w1;
+            *a = trj->a2;
+            return;
+        default:
+            *t = trj->t3;
+            *th = trj->th3;
+            *w = trj->w3;
+            *a = 0;
+            return;
+    }
+}
 
-    // Get angle, speed, and acceleration along reference
-    int32_t th;
-    int32_t w;
-    int32_t a;
+/**
+ * Scales a value by the ratio of two time values, where the ratio is at most one.
+ *
+ * The time values may be longer than the divisors supported by
+ * ::pbio_int_math_mult_then_div, so this uses a long product instead.
+ *
+ * @param [in]  value   The value to scale.
+ * @param [in]  t_num   The time in s*10^-4 to multiply by.
+ * @param [in]  t_den   The time in s*10^-4 to divide by.
+ * @returns             The scaled value, in the same units as @p value.
+ */
+static int32_t mul_by_t_ratio(int32_t value, int32_t t_num, int32_t t_den) {
+
+    assert(t_num >= 0 && t_num <= t_den);
+    assert_time(t_den);
+
+    return (int64_t)value * t_num / t_den;
+}
+
+/**
+ * Multiplies a speed change by time^2 / (2 * t_jerk * t_mid), giving the speed
+ * gained after accelerating with constant jerk for the given time.
+ *
+ * @param [in]  dw      The speed change of the whole phase in ddeg/s.
+ * @param [in]  t       The time in s*10^-4, at most @p t_jerk.
+ * @param [in]  t_jerk  The duration of the jerk part of the phase in s*10^-4.
+ * @param [in]  t_mid   The phase duration minus @p t_jerk in s*10^-4.
+ * @returns             The speed in ddeg/s.
+ */
+static int32_t mul_dw_by_t2_jerk(int32_t dw, int32_t t, int32_t t_jerk, int32_t t_mid) {
+
+    assert_speed_rel(dw);
+    assert(t_jerk <= t_mid);
+
+    return mul_by_t_ratio(mul_by_t_ratio(dw, t, t_jerk), t, t_mid * 2);
+}
+
+/**
+ * Multiplies a speed change by time^3 / (6 * t_jerk * t_mid), giving the angle
+ * gained after accelerating with constant jerk for the given time.
+ *
+ * The speed gained is not truncated before integrating it, since the time
+ * values are too large for the intermediate result to be accurate.
+ *
+ * @param [in]  dw      The speed change of the whole phase in ddeg/s.
+ * @param [in]  t       The time in s*10^-4, at most @p t_jerk.
+ * @param [in]  t_jerk  The duration of the jerk part of the phase in s*10^-4.
+ * @param [in]  t_mid   The phase duration minus @p t_jerk in s*10^-4.
+ * @returns             The angle in mdeg.
+ */
+static int32_t mul_dw_by_t3_jerk(int32_t dw, int32_t t, int32_t t_jerk, int32_t t_mid) {
+
+    assert_speed_rel(dw);
+    assert_accel_time(t_mid);
+    assert(t >= 0 && t <= t_jerk && t_jerk <= t_mid);
+
+    // Each step is bounded by dw * t, so this can't overflow.
+    int64_t dw_t2 = (int64_t)dw * t * t / t_jerk;
+    return dw_t2 * t / ((int64_t)t_mid * 600);
+}
+
+/**
+ * Evaluates a smoothed acceleration phase, if the given time lies within one.
+ *
+ * The acceleration ramps up linearly during the first t_jerk of the phase,
+ * stays constant, and ramps down linearly during the last t_jerk. The peak
+ * acceleration is chosen to give the same speed change as the trapezoid. The
+ * speed is point-symmetric about the middle of the phase, so the phase covers
+ * the same angle as the trapezoid.
+ *
+ * @param [in]  trj         The trajectory instance.
+ * @param [in]  segment     The segment index at @p time.
+ * @param [in]  time        The time since the start of the trajectory in s*10^-4.
+ * @param [out] th          The angle in mdeg.
+ * @param [out] w           The rotational speed in ddeg/s.
+ * @param [out] a           The acceleration in deg/s^2.
+ * @returns                 True if the result was computed, false if this is
+ *                          not a smoothed phase.
+ */
+static bool pbio_trajectory_get_smoothed(const pbio_trajectory_t *trj, uint8_t segment, int32_t time, int32_t *th, int32_t *w, int32_t *a) {
+
+    if (trj->smoothing == 0 || segment == 1 || segment == 3) {
+        return false;
+    }
+
+    // Get phase duration and boundary values.
+    int32_t t_phase = segment == 0 ? trj->t1 : trj->t3 - trj->t2;
+    int32_t tau = segment == 0 ? time : time - trj->t2;
+    int32_t th_start = segment == 0 ? 0 : trj->th2;
+    int32_t th_end = segment == 0 ? trj->th1 : trj->th3;
+    int32_t w_start = segment == 0 ? trj->w0 : trj->w1;
+    int32_t w_end = segment == 0 ? trj->w1 : trj->w3;
+
+    // Very short phases are not smoothed.
+    int32_t t_jerk = t_phase * trj->smoothing / 200;
+    if (t_jerk == 0) {
+        return false;
+    }
+    int32_t t_mid = t_phase - t_jerk;
+    int32_t dw = w_end - w_start;
+    int32_t a_peak = div_w_by_t(dw, t_mid);
+
+    assert_accel_time(t_phase);
+    assert_speed(w_start);
+    assert_speed(w_end);
+
+    // The angle of the phase is the average speed times its duration. It may
+    // differ slightly from the rounded end angle of the trapezoid, so this
+    // difference is spread out across the phase to end exactly at th_end.
+    int32_t th_phase = ((int64_t)(w_start + w_end) * t_phase) / 200;
+    th_start += mul_by_t_ratio(th_end - th_start - th_phase, tau, t_phase);
+
+    if (tau < t_jerk) {
+        // Acceleration ramping up from zero.
+        *w = w_start + mul_dw_by_t2_jerk(dw, tau, t_jerk, t_mid);
+        *th = th_start + mul_w_by_t(w_start, tau) + mul_dw_by_t3_jerk(dw, tau, t_jerk, t_mid);
+        *a = mul_by_t_ratio(a_peak, tau, t_jerk);
+    } else if (tau <= t_mid) {
+        // Constant peak acceleration. The angle gained by accelerating is
+        // (dw / t_mid) * ((tau - t_jerk / 2)^2 / 2 + t_jerk^2 / 24).
+        int64_t u = tau * 2 - t_jerk;
+        *w = w_start + mul_by_t_ratio(dw, u, t_mid * 2);
+        *th = th_start + mul_w_by_t(w_start, tau) +
+            dw * (3 * u * u + (int64_t)t_jerk * t_jerk) / ((int64_t)t_mid * 2400);
+        *a = a_peak;
+    } else {
+        // Acceleration ramping down to zero. By symmetry, this is the full
+        // phase minus the angle evaluated backwards from the end.
+        int32_t sigma = t_phase - tau;
+        *w = w_end - mul_dw_by_t2_jerk(dw, sigma, t_jerk, t_mid);
+        *th = th_start + th_phase - mul_w_by_t(w_end, sigma) +
+            mul_dw_by_t3_jerk(dw, sigma, t_jerk, t_mid);
+        *a = mul_by_t_ratio(a_peak, sigma, t_jerk);
+    }
+    return true;
+}
+
+/**
+ * Time steps up to this size are evaluated incrementally. This keeps all
+ * increments within 32 bits. Bigger steps are rare and evaluated from scratch.
+ */
+#define CACHE_STEP_MAX (1000)
+
+/**
+ * Splits a value into a quotient rounded towards minus infinity and a
+ * non-negative remainder.
+ *
+ * @param [in]  value       The dividend.
+ * @param [in]  divisor     The positive divisor.
+ * @param [out] q           The quotient.
+ * @param [out] r           The remainder.
+ */
+static void cache_split(int64_t value, int32_t divisor, int32_t *q, int32_t *r) {
+    int64_t quotient = value / divisor;
+    int32_t remainder = value % divisor;
+    if (remainder < 0) {
+        remainder += divisor;
+        quotient--;
+    }
+    *q = quotient;
+    *r = remainder;
+}
+
+/**
+ * Adds an increment to a quotient and remainder pair as made by ::cache_split.
+ *
+ * This is always called with a constant divisor, so the compiler replaces the
+ * division by a multiplication.
+ *
+ * @param [in, out] q           The quotient.
+ * @param [in, out] r           The remainder.
+ * @param [in]      increment   The value to add to the dividend.
+ * @param [in]      divisor     The positive divisor.
+ */
+static inline void cache_add(int32_t *q, int32_t *r, int32_t increment, int32_t divisor) {
+    int32_t dq = increment / divisor;
+    int32_t dr = increment % divisor;
+    if (dr < 0) {
+        dr += divisor;
+        dq--;
+    }
+    *q += dq;
+    *r += dr;
+    if (*r >= divisor) {
+        *r -= divisor;
+        *q += 1;
+    }
+}
+
+/**
+ * Gets a quotient rounded towards zero from a pair made by ::cache_split, to
+ * match the rounding of ::pbio_int_math_mult_then_div.
+ *
+ * @param [in]  q           The quotient rounded towards minus infinity.
+ * @param [in]  r           The non-negative remainder.
+ * @returns                 The quotient rounded towards zero.
+ */
+static inline int32_t cache_trunc(int32_t q, int32_t r) {
+    return q < 0 && r != 0 ? q + 1 : q;
+}
+
+/**
+ * Evaluates the trajectory using the state of the previous evaluation.
+ *
+ * Within one segment, the result is the same as ::pbio_trajectory_get_uncached,
+ * but moving forward in small time steps takes only additions and
+ * multiplications by the time step.
+ *
+ * @param [in]  trj         The trajectory instance.
+ * @param [in]  time        The time since the start of the trajectory in s*10^-4.
+ * @param [out] th          The angle in mdeg.
+ * @param [out] w           The rotational speed in ddeg/s.
+ * @param [out] a           The acceleration in deg/s^2.
+ */
+static void pbio_trajectory_get_cached(pbio_trajectory_t *trj, int32_t time, int32_t *th, int32_t *w, int32_t *a) {
+
+    pbio_trajectory_cache_t *cache = &trj->cache;
+
+    // Smoothed phases are not polynomials of degree two, so they are always
+    // evaluated from scratch.
+    uint8_t segment = pbio_trajectory_get_segment(trj, time);
+    if (pbio_trajectory_get_smoothed(trj, segment, time, th, w, a)) {
+        cache->valid = false;
+        cache->segment = segment;
+        return;
+    }
+
+    // Get polynomial coefficients of the active segment.
+    int32_t t_start;
+    int32_t th_start;
+    int32_t w_start;
+    pbio_trajectory_get_segment_start(trj, segment, &t_start, &th_start, &w_start, a);
+
+    int32_t tau = time - t_start;
+    int32_t dt = tau - cache->time;
+
+    if (!cache->valid || cache->segment != segment || dt < 0 || dt > CACHE_STEP_MAX) {
+        // Entering a new segment or jumping in time, so evaluate from scratch.
+        cache_split((int64_t)*a * tau, 1000, &cache->wq, &cache->wr);
+        cache_split((int64_t)w_start * tau, 100, &cache->thq, &cache->thr);
+        int32_t gain = cache_trunc(cache->wq, cache->wr);
+        cache_split((int64_t)gain * tau, 200, &cache->th2q, &cache->th2r);
+        cache->segment = segment;
+        cache->valid = true;
+    } else if (dt > 0) {
+        // Advance each product by its increment over dt. The speed gain
+        // changes too, so its product with time gets the product rule.
+        int32_t gain_prev = cache_trunc(cache->wq, cache->wr);
+        cache_add(&cache->wq, &cache->wr, *a * dt, 1000);
+        cache_add(&cache->thq, &cache->thr, w_start * dt, 100);
+        int32_t gain = cache_trunc(cache->wq, cache->wr);
+        cache_add(&cache->th2q, &cache->th2r, gain * dt + (gain - gain_prev) * cache->time, 200);
+    }
+    cache->time = tau;
+
+    *w = w_start + cache_trunc(cache->wq, cache->wr);
+    *th = th_start + cache_trunc(cache->thq, cache->thr) + cache_trunc(cache->th2q, cache->th2r);
+}
+
+/**
+ * Evaluates the trajectory from scratch.
+ *
+ * @param [in]  trj         The trajectory instance.
+ * @param [in]  time        The time since the start of the trajectory in s*10^-4.
+ * @param [out] th          The angle in mdeg.
+ * @param [out] w           The rotational speed in ddeg/s.
+ * @param [out] a           The acceleration in deg/s^2.
+ */
+static void pbio_trajectory_get_uncached(const pbio_trajectory_t *trj, int32_t time, int32_t *th, int32_t *w, int32_t *a) {
+
+    if (pbio_trajectory_get_smoothed(trj, pbio_trajectory_get_segment(trj, time), time, th, w, a)) {
+        return;
+    }
 
     if (time - trj->t1 < 0 || (trj->t1 == 0 && time == 0)) {
         // If we are here, then we are still in the acceleration phase.
         // Includes conversion from microseconds to seconds, in two steps to
         // avoid overflows and round off errors
-        w = trj->w0 + mul_a_by_t(trj->a0, time);
-        th = mul_w_by_t(trj->w0, time) + mul_a_by_t2(trj->a0, time);
-        a = trj->a0;
+        *w = trj->w0 + mul_a_by_t(trj->a0, time);
+        *th = mul_w_by_t(trj->w0, time) + mul_a_by_t2(trj->a0, time);
+        *a = trj->a0;
     } else if (time - trj->t2 < 0) {
         // If we are here, then we are in the constant speed phase
-        w = trj->w1;
-        th = trj->th1 + mul_w_by_t(trj->w1, time - trj->t1);
-        a = 0;
+        *w = trj->w1;
+        *th = trj->th1 + mul_w_by_t(trj->w1, time - trj->t1);
+        *a = 0;
     } else if (time - trj->t3 < 0) {
         // If we are here, then we are in the deceleration phase
-        w = trj->w1 + mul_a_by_t(trj->a2, time - trj->t2);
-        th = trj->th2 + mul_w_by_t(trj->w1, time - trj->t2) + mul_a_by_t2(trj->a2, time - trj->t2);
-        a = trj->a2;
+        *w = trj->w1 + mul_a_by_t(trj->a2, time - trj->t2);
+        *th = trj->th2 + mul_w_by_t(trj->w1, time - trj->t2) + mul_a_by_t2(trj->a2, time - trj->t2);
+        *a = trj->a2;
     } else {
         // If we are here, we are in the constant speed phase after the
         // maneuver completes
-        w = trj->w3;
-        th = trj->th3 + mul_w_by_t(trj->w3, time - trj->t3);
-        a = 0;
-
-        // To avoid any overflows of the aforementioned time comparisons,
-        // rebase the trajectory if it has been running a long time.
-        if (time > PBIO_TRAJECTORY_DURATION_FOREVER_MS * PBIO_TRAJECTORY_TICKS_PER_MS) {
-            pbio_angle_t start = trj->start.position;
-            pbio_angle_add_mdeg(&start, th);
-
-            pbio_trajectory_command_t command = {
-                .time_start = time_ref,
-                .speed_target = to_control_speed(trj->w3),
-                .continue_running = true,
-                .position_start = start,
-            };
-            pbio_trajectory_make_constant(trj, &command);
-
-            // w, and a are already set above. Time and angle are 0, since this
-            // is the start of the new maneuver with its new starting point.
-            time = 0;
-            th = 0;
-        }
+        *w = trj->w3;
+        *th = trj->th3 + mul_w_by_t(trj->w3, time - trj->t3);
+        *a = 0;
+    }
+}
+
+/**
+ * Gets the calculated reference speed and velocity of the trajectory at the
+ * (shifted) time, without using or updating the cached state.
+ *
+ * This gives the same result as ::pbio_trajectory_get_reference, but does not
+ * rebase long running trajectories. It is slower for successive samples.
+ *
+ * @param [in]  trj         The trajectory instance.
+ * @param [in]  time_ref    The duration of time after the start of the trajectory in s*10^-4.
+ * @param [out] ref         An uninitialized trajectory reference point to hold the result.
+ */
+void pbio_trajectory_get_reference_uncached(const pbio_trajectory_t *trj, uint32_t time_ref, pbio_trajectory_reference_t *ref) {
+
+    // Time within maneuver since start.
+    int32_t time = TO_TRAJECTORY_TIME(time_ref - trj->start.time);
+    assert_time(time);
+
+    int32_t th;
+    int32_t w;
+    int32_t a;
+    pbio_trajectory_get_uncached(trj, time, &th, &w, &a);
+
+    assert_angle(th);
+    assert_speed(w);
+
+    pbio_trajectory_offset_start(ref, &trj->start, time, th, w, a);
+}
+
+/**
+ * Gets the calculated reference speed and velocity of the trajectory at the (shifted) time.
+ *
+ * The evaluation state is kept in @p trj, so sampling the trajectory at
+ * increasing times with small intervals is faster than random access.
+ *
+ * @param [in]  trj         The trajectory instance.
+ * @param [in]  time_ref    The duration of time after the start of the trajectory in s*10^-4.
+ * @param [out] ref         An uninitialized trajectory reference point to hold the result.
+ */
+void pbio_trajectory_get_reference(pbio_trajectory_t *trj, uint32_t time_ref, pbio_trajectory_reference_t *ref) {
+
+    // Time within maneuver since start.
+    int32_t time = TO_TRAJECTORY_TIME(time_ref - trj->start.time);
+    assert_time(time);
+
+    // Get angle, speed, and acceleration along reference. Successive calls
+    // usually advance by one control tick, which the cache makes cheap.
+    int32_t th;
+    int32_t w;
+    int32_t a;
+    pbio_trajectory_get_cached(trj, time, &th, &w, &a);
+
+    // To avoid any overflows of the segment time comparisons, rebase the
+    // trajectory if it has been running a long time in the final segment.
+    if (trj->cache.segment == 3 && time > PBIO_TRAJECTORY_DURATION_FOREVER_MS * PBIO_TRAJECTORY_TICKS_PER_MS) {
+        pbio_angle_t start = trj->start.position;
+        pbio_angle_add_mdeg(&start, th);
+
+        pbio_trajectory_command_t command = {
+            .time_start = time_ref,
+            .speed_target = to_control_speed(trj->w3),
+            .continue_running = true,
+            .position_start = start,
+        };
+        pbio_trajectory_make_constant(trj, &command);
+
+        // w, and a are already set above. Time and angle are 0, since this
+        // is the start of the new maneuver with its new starting point.
+        time = 0;
+        th = 0;
     }
 
     // Assert that results are bounded
@@ -14,6 +14,7 @@
 #include "./hmi.h"
 #include "./storage.h"
 #include "./program_stop.h"
+#include "./telemetry.h"
 
 static pbsys_command_write_app_data_callback_t write_app_data_callback = NULL;
 
@@ -98,6 +99,13 @@ pbio_pybricks_error_t pbsys_command(const uint8_t *data, uint32_t size) {
             const uint8_t *data_to_write = &data[3];
             return pbio_pybricks_error_from_pbio_error(write_app_data_callback(offset, data_size, data_to_write));
         }
+
+        case PBIO_PYBRICKS_COMMAND_SET_TELEMETRY_INTERVAL:
+            // Requires the channel and the interval.
+            if (size != 4) {
+                return PBIO_PYBRICKS_ERROR_VALUE_NOT_ALLOWED;
+            }
+            return pbio_pybricks_error_from_pbio_error(pbsys_telemetry_set_interval(data[1], pbio_get_uint16_le(&data[2])));
         default:
             return PBIO_PYBRICKS_ERROR_INVALID_COMMAND;
     }
@@ -33,7 +33,7 @@ static pbio_error_t pbsys_system_poll_process_thread(pbio_os_state_t *state, voi
     pbio_os_timer_set(&timer, 50);
 
     for (;;) {
-        PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_is_expired(&timer));
+        PBIO_OS_AWAIT_UNTIL(state, pbio_os_timer_await(&timer));
         pbio_os_timer_extend(&timer);
 
         pbsys_battery_poll();
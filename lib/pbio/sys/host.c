@@ -253,4 +253,26 @@ pbio_error_t pbsys_host_send_event(pbio_os_state_t *state, pbio_pybricks_event_t
     PBIO_OS_ASYNC_END(ble_err != PBIO_SUCCESS ? ble_err : usb_err);
 }
 
+/**
+ * Gets the largest event payload that ::pbsys_host_send_event can send to all
+ * connected hosts in one event.
+ *
+ * @return              The size in bytes.
+ */
+uint32_t pbsys_host_get_event_size_max(void) {
+    #if BLE_ONLY
+    return PBDRV_BLUETOOTH_MAX_CHAR_SIZE - 1;
+    #elif USB_ONLY
+    return PBDRV_CONFIG_USB_MAX_PACKET_SIZE - 2;
+    #elif BLE_AND_USB
+    // Bluetooth has the smaller limit, so it only matters if it is used.
+    if (pbdrv_bluetooth_is_connected(PBDRV_BLUETOOTH_CONNECTION_PYBRICKS) || !pbdrv_usb_connection_is_active()) {
+        return PBDRV_BLUETOOTH_MAX_CHAR_SIZE - 1;
+    }
+    return PBDRV_CONFIG_USB_MAX_PACKET_SIZE - 2;
+    #else
+    return 0;
+    #endif
+}
+
 #endif // PBSYS_CONFIG_HOST
@@ -65,6 +65,8 @@ pbio_error_t pbsys_main_program_request_start(pbio_pybricks_user_program_id_t id
 
     pbio_error_t err = pbsys_main_program_validate(&program);
     if (err != PBIO_SUCCESS) {
+        // Not running, so program data is not used as heap after all.
+        pbsys_storage_restore_program_data();
         return err;
     }
 
@@ -133,6 +135,10 @@ void pbsys_main(void) {
 
         // Finalize application now that system resources are safely closed.
         pbsys_main_run_program_cleanup();
+
+        // Application heap is no longer used, so program data can be restored
+        // if the program ran from storage.
+        pbsys_storage_restore_program_data();
     }
 
     // Stop system processes and selected drivers in reverse order. This will
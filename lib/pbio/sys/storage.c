@@ -7,6 +7,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
 #include <pbio/os.h>
@@ -59,7 +60,58 @@ static struct {
  *
  */
 static pbsys_storage_data_map_t *map;
-static bool data_map_write_on_shutdown = false;
+
+/**
+ * Range of the data map that was changed since it was loaded, as offsets from
+ * the start of the map. Only this part is written to storage on shutdown.
+ */
+static struct {
+    uint32_t start;
+    uint32_t end;
+} dirty = { .start = UINT32_MAX };
+
+/**
+ * Stored data map as memory mapped by the block device, or NULL if the
+ * storage is not memory mapped. Programs that were not changed since boot can
+ * run from there, so that their copy in RAM can be used as application heap.
+ */
+static const pbsys_storage_data_map_t *mapped_map;
+
+/**
+ * Whether the RAM copy of the program data is currently used as application
+ * heap, so that it must be restored before it can be used again.
+ */
+static bool program_data_lent;
+
+/**
+ * Marks part of the data map as changed, so it will be saved on shutdown.
+ *
+ * @param [in]  data    Start of the changed data in the data map.
+ * @param [in]  size    Size of the changed data.
+ */
+static void pbsys_storage_mark_dirty(const void *data, uint32_t size) {
+    uint32_t start = (const uint8_t *)data - (const uint8_t *)map;
+    if (start < dirty.start) {
+        dirty.start = start;
+    }
+    if (start + size > dirty.end) {
+        dirty.end = start + size;
+    }
+}
+
+/**
+ * Tests whether the program data is the same in RAM and in memory mapped
+ * storage, so that programs can run directly from storage.
+ *
+ * @returns             True if programs can run from storage, else false.
+ */
+static bool pbsys_storage_program_data_is_mapped(void) {
+    if (!mapped_map) {
+        return false;
+    }
+    // Nothing changed, or only the data before the programs changed.
+    return dirty.start >= dirty.end || dirty.end <= offsetof(pbsys_storage_data_map_t, program_data);
+}
 
 /**
  * Gets program size or the total size of the sequentially stored slots.
@@ -97,11 +149,11 @@ pbsys_storage_settings_t *pbsys_storage_settings_get_settings(void) {
 }
 
 /**
- * Requests that storage (program, user data, settings) will be saved some
- * time before shutdown. Should be called by functions that change data.
+ * Requests that the settings will be saved some time before shutdown. Should
+ * be called by functions that change the settings.
  */
 void pbsys_storage_request_write(void) {
-    data_map_write_on_shutdown = true;
+    pbsys_storage_mark_dirty(&map->settings, sizeof(map->settings));
 }
 
 /**
@@ -130,7 +182,7 @@ void pbsys_storage_reset_storage(void) {
     strncpy(map->stored_firmware_hash, pbsys_main_get_application_version_hash(), sizeof(map->stored_firmware_hash));
 
     // Ensure new firmware version and default settings are written on poweroff.
-    pbsys_storage_request_write();
+    pbsys_storage_mark_dirty(map, sizeof(pbsys_storage_data_map_t));
 }
 
 /**
@@ -146,9 +198,9 @@ pbio_error_t pbsys_storage_set_user_data(uint32_t offset, const uint8_t *data, u
     if (offset + size > sizeof(map->user_data)) {
         return PBIO_ERROR_INVALID_ARG;
     }
-    // Update data and write size to request write on poweroff.
+    // Update data and request write on poweroff.
     memcpy(map->user_data + offset, data, size);
-    pbsys_storage_request_write();
+    pbsys_storage_mark_dirty(map->user_data + offset, size);
     return PBIO_SUCCESS;
 }
 
@@ -173,6 +225,9 @@ pbio_error_t pbsys_storage_get_user_data(uint32_t offset, uint8_t **data, uint32
 
 static void pbsys_storage_prepare_receive(void) {
 
+    // Slot info will change in all cases below.
+    pbsys_storage_mark_dirty(map->slot_info, sizeof(map->slot_info));
+
     #if PBSYS_CONFIG_STORAGE_NUM_SLOTS == 1
     map->slot_info[download_state.slot].size = 0;
     map->slot_info[download_state.slot].offset = 0;
@@ -222,6 +277,7 @@ static void pbsys_storage_prepare_receive(void) {
 
     // Now move those remaining programs backwards into the "freed" space.
     memmove(map->program_data + destination, map->program_data + source, remaining_programs_size);
+    pbsys_storage_mark_dirty(map->program_data + destination, remaining_programs_size);
 
     // The active slot is now at the end, and ready to receive programs.
     map->slot_info[download_state.slot].size = 0;
@@ -244,7 +300,7 @@ static void pbsys_storage_prepare_receive(void) {
  */
 pbio_error_t pbsys_storage_set_program_size(uint32_t new_size) {
     // we can't allow this to be changed while a user program is running
-    if (pbsys_status_test(PBIO_PYBRICKS_STATUS_USER_PROGRAM_RUNNING)) {
+    if (pbsys_status_test(PBIO_PYBRICKS_STATUS_USER_PROGRAM_RUNNING) || program_data_lent) {
         return PBIO_ERROR_BUSY;
     }
 
@@ -270,8 +326,10 @@ pbio_error_t pbsys_storage_set_program_size(uint32_t new_size) {
     // Set information for the incoming slot.
     map->slot_info[download_state.slot].size = new_size;
 
-    // Program download complete, so request saving on poweroff.
-    pbsys_storage_request_write();
+    // Program download complete, so request saving on poweroff. This
+    // includes the word alignment padding after the received data.
+    pbsys_storage_mark_dirty(&map->slot_info[download_state.slot], sizeof(pbsys_storage_slot_info_t));
+    pbsys_storage_mark_dirty(map->program_data + map->slot_info[download_state.slot].offset, new_size);
     download_state.busy = false;
 
     return PBIO_SUCCESS;
@@ -317,7 +375,7 @@ pbio_error_t pbsys_storage_set_program_data(uint32_t offset, const void *data, u
     }
 
     // We can't allow this to be changed while a user program is running.
-    if (pbsys_status_test(PBIO_PYBRICKS_STATUS_USER_PROGRAM_RUNNING)) {
+    if (pbsys_status_test(PBIO_PYBRICKS_STATUS_USER_PROGRAM_RUNNING) || program_data_lent) {
         return PBIO_ERROR_BUSY;
     }
 
@@ -330,6 +388,7 @@ pbio_error_t pbsys_storage_set_program_data(uint32_t offset, const void *data, u
     pbio_os_timer_reset(&download_state.timer);
 
     memcpy(map->program_data + map->slot_info[download_state.slot].offset + offset, data, size);
+    pbsys_storage_mark_dirty(map->program_data + map->slot_info[download_state.slot].offset + offset, size);
 
     return PBIO_SUCCESS;
 }
@@ -354,6 +413,33 @@ void pbsys_storage_get_program_data(pbsys_main_program_t *program) {
     // User ram starts after the last slot, even if a non-slot program is run.
     program->user_ram_start = map->program_data + pbsys_storage_get_used_program_data_size();
     program->user_ram_end = ((void *)map) + PBDRV_CONFIG_BLOCK_DEVICE_RAM_SIZE;
+
+    // If the programs are unchanged since boot, run them in place from
+    // storage. Then the RAM copy of all slots can be used as application
+    // heap. It is restored from storage once the program is done.
+    if (pbsys_storage_program_data_is_mapped()) {
+        if (program->code_start) {
+            program->code_start = mapped_map->program_data + map->slot_info[program->id].offset;
+            program->code_end = mapped_map->program_data + map->slot_info[program->id].offset + map->slot_info[program->id].size;
+        }
+        program->user_ram_start = map->program_data;
+        program_data_lent = true;
+    }
+}
+
+/**
+ * Restores the RAM copy of the program data after it was used as application
+ * heap by a program that ran from storage.
+ *
+ * Must be called once the application no longer uses its heap. Downloads
+ * are refused until then.
+ */
+void pbsys_storage_restore_program_data(void) {
+    if (!program_data_lent) {
+        return;
+    }
+    memcpy(map->program_data, mapped_map->program_data, pbsys_storage_get_used_program_data_size());
+    program_data_lent = false;
 }
 
 /**
@@ -371,8 +457,8 @@ static pbio_error_t pbsys_storage_deinit_process_thread(pbio_os_state_t *state,
 
     write_size = sizeof(pbsys_storage_data_map_t) + pbsys_storage_get_used_program_data_size();
 
-    // Write the data.
-    PBIO_OS_AWAIT(state, &sub, err = pbdrv_block_device_write_all(&sub, write_size));
+    // Write only the sectors with changed data.
+    PBIO_OS_AWAIT(state, &sub, err = pbdrv_block_device_write_range(&sub, write_size, dirty.start, dirty.end));
 
     // Deinitialization done.
     pbio_busy_count_down();
@@ -393,6 +479,11 @@ void pbsys_storage_init(void) {
         pbsys_storage_reset_storage();
     }
 
+    // Programs can run in place if storage is memory mapped.
+    if (pbdrv_block_device_get_mapped_data(&mapped_map) != PBIO_SUCCESS) {
+        mapped_map = NULL;
+    }
+
     // Apply loaded settings as necesary.
     pbsys_storage_settings_apply_loaded_settings(&map->settings);
 }
@@ -404,8 +495,11 @@ static pbio_os_process_t pbsys_storage_deinit_process;
  */
 void pbsys_storage_deinit(void) {
 
-    // If writing not requested, don't write.
-    if (!data_map_write_on_shutdown) {
+    // The data in RAM is saved, so it must be complete.
+    pbsys_storage_restore_program_data();
+
+    // If nothing changed, don't write.
+    if (dirty.start >= dirty.end) {
         return;
     }
 
@@ -19,6 +19,7 @@ pbio_error_t pbsys_storage_set_program_size(uint32_t size);
 pbio_error_t pbsys_storage_set_program_data(uint32_t offset, const void *data, uint32_t size);
 bool pbsys_storage_slot_change_is_allowed(void);
 void pbsys_storage_get_program_data(pbsys_main_program_t *program);
+void pbsys_storage_restore_program_data(void);
 pbsys_storage_settings_t *pbsys_storage_settings_get_settings(void);
 
 #else
@@ -49,6 +50,8 @@ static inline void pbsys_storage_get_program_data(pbsys_main_program_t *program)
     program->user_ram_start = &pbsys_storage_heap_start;
     program->user_ram_end = &pbsys_storage_heap_end;
 }
+static inline void pbsys_storage_restore_program_data(void) {
+}
 
 #endif // PBSYS_CONFIG_STORAGE
 
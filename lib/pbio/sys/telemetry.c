@@ -5,73 +5,432 @@
 
 #if PBSYS_CONFIG_TELEMETRY
 
-#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
 
+#include <pbdrv/clock.h>
+#include <pbio/drivebase.h>
+#include <pbio/imu.h>
+#include <pbio/int_math.h>
+#include <pbio/motor_process.h>
 #include <pbio/os.h>
 #include <pbio/port_interface.h>
+#include <pbio/port_lump.h>
+#include <pbio/protocol.h>
+#include <pbio/servo.h>
 #include <pbio/util.h>
 
 #include <pbsys/host.h>
 
+#include "telemetry.h"
+
+/**
+ * Gets the current value of one index of a telemetry channel.
+ *
+ * @param [in]  index   Index within the channel, such as the port index.
+ * @param [out] value   The value.
+ * @return              True if there is a value, false if not available.
+ */
+typedef bool (*pbsys_telemetry_get_value_t)(uint8_t index, int32_t *value);
+
+/**
+ * Static information about a telemetry channel.
+ */
 typedef struct {
-    lego_device_type_id_t type_id;
+    /**
+     * Gets the current value.
+     */
+    pbsys_telemetry_get_value_t get_value;
+    /**
+     * Number of indexes in this channel.
+     */
+    uint8_t num_indexes;
+    /**
+     * Interval in ms before the host changes it, or 0 if off by default.
+     */
+    uint16_t default_interval;
+} pbsys_telemetry_channel_info_t;
+
+/**
+ * Largest number of indexes in any channel.
+ */
+#define TELEMETRY_NUM_INDEXES_MAX (PBIO_CONFIG_PORT_NUM_DEV > 3 ? PBIO_CONFIG_PORT_NUM_DEV : 3)
+
+_Static_assert(TELEMETRY_NUM_INDEXES_MAX <= 32, "sent flags must fit all indexes");
+
+/**
+ * Telemetry channel state.
+ */
+typedef struct {
+    /**
+     * Interval in ms as requested by the host, or 0 if off.
+     */
+    uint16_t interval;
+    /**
+     * Time in ms when the channel was last sampled.
+     */
+    uint32_t time;
+    /**
+     * Bit mask of indexes whose last value was sent to the host.
+     */
+    uint32_t sent;
+    /**
+     * Last value sent to the host for each index.
+     */
+    int32_t value[TELEMETRY_NUM_INDEXES_MAX];
+} pbsys_telemetry_channel_t;
+
+/**
+ * A sample that is in the batch currently being sent.
+ */
+typedef struct {
+    uint8_t channel;
+    uint8_t index;
     int32_t value;
-} pbsys_telemetry_port_data_t;
+} pbsys_telemetry_sample_t;
 
-static pbsys_telemetry_port_data_t last_data[PBIO_CONFIG_PORT_NUM_DEV];
+/**
+ * Size of the buffer for a batch of samples sent as one event.
+ */
+#define TELEMETRY_BATCH_SIZE (64)
 
-// Revisit: Come up with a data encoding protocol. Right now it just sends
-// six motor positions to drive the existing motor animation.
-static uint8_t update_port_data(uint8_t index, uint8_t *buf) {
+/**
+ * Most samples in one batch. Each sample is at least 3 bytes.
+ */
+#define TELEMETRY_BATCH_NUM_SAMPLES (TELEMETRY_BATCH_SIZE / 3)
 
-    // Get type and angle.
-    int32_t degrees = 0;
-    pbio_angle_t angle;
-    lego_device_type_id_t type_id = LEGO_DEVICE_TYPE_ID_NONE;
+/**
+ * Longest time in ms to wait before checking the channel intervals again,
+ * so that new subscriptions take effect quickly.
+ */
+#define TELEMETRY_WAIT_MAX_MS (100)
+
+static bool get_device_type(uint8_t index, int32_t *value) {
     pbio_port_t *port = pbio_port_by_index(index);
-    pbio_error_t err = pbio_port_get_angle(port, &angle);
-    if (err == PBIO_SUCCESS) {
-        type_id = LEGO_DEVICE_TYPE_ID_ANY_ENCODED_MOTOR;
-        degrees = pbio_angle_to_low_res(&angle, 1000);
+    pbio_servo_t *srv;
+    pbio_port_lump_dev_t *lump_dev;
+    lego_device_type_id_t type_id = LEGO_DEVICE_TYPE_ID_ANY_ENCODED_MOTOR;
+    if (pbio_port_get_servo(port, &type_id, &srv) != PBIO_SUCCESS) {
+        type_id = LEGO_DEVICE_TYPE_ID_ANY_LUMP_UART;
+        if (pbio_port_get_lump_device(port, &type_id, &lump_dev) != PBIO_SUCCESS) {
+            type_id = LEGO_DEVICE_TYPE_ID_NONE;
+        }
+    }
+    *value = type_id;
+    return true;
+}
+
+static bool get_motor_angle(uint8_t index, int32_t *value) {
+    pbio_angle_t angle;
+    if (pbio_port_get_angle(pbio_port_by_index(index), &angle) != PBIO_SUCCESS) {
+        return false;
+    }
+    *value = pbio_angle_to_low_res(&angle, 1000);
+    return true;
+}
+
+/**
+ * Gets the servo on a port if its control loop is running.
+ */
+static pbio_servo_t *get_running_servo(uint8_t index) {
+    pbio_servo_t *srv;
+    lego_device_type_id_t type_id = LEGO_DEVICE_TYPE_ID_ANY_ENCODED_MOTOR;
+    if (pbio_port_get_servo(pbio_port_by_index(index), &type_id, &srv) != PBIO_SUCCESS ||
+        !pbio_servo_update_loop_is_running(srv)) {
+        return NULL;
+    }
+    return srv;
+}
+
+static bool get_motor_speed(uint8_t index, int32_t *value) {
+    int32_t angle;
+    pbio_servo_t *srv = get_running_servo(index);
+    return srv && pbio_servo_get_state_user(srv, &angle, value) == PBIO_SUCCESS;
+}
+
+static bool get_motor_load(uint8_t index, int32_t *value) {
+    pbio_servo_t *srv = get_running_servo(index);
+    return srv && pbio_servo_get_load(srv, value) == PBIO_SUCCESS;
+}
+
+static bool get_sensor_value(uint8_t index, int32_t *value) {
+    pbio_port_lump_dev_t *lump_dev;
+    lego_device_type_id_t type_id = LEGO_DEVICE_TYPE_ID_ANY_LUMP_UART;
+    if (pbio_port_get_lump_device(pbio_port_by_index(index), &type_id, &lump_dev) != PBIO_SUCCESS) {
+        return false;
     }
 
-    pbsys_telemetry_port_data_t *data = &last_data[index];
+    uint8_t num_modes;
+    uint8_t mode;
+    pbio_port_lump_mode_info_t *mode_info;
+    void *data;
+    if (pbio_port_lump_get_info(lump_dev, &num_modes, &mode, &mode_info) != PBIO_SUCCESS ||
+        pbio_port_lump_get_data(lump_dev, mode, &data) != PBIO_SUCCESS) {
+        return false;
+    }
 
-    if (data->type_id == type_id && data->value == degrees) {
+    switch (mode_info[mode].data_type) {
+        case LUMP_DATA_TYPE_DATA8:
+            *value = *(int8_t *)data;
+            return true;
+        case LUMP_DATA_TYPE_DATA16:
+            *value = *(int16_t *)data;
+            return true;
+        case LUMP_DATA_TYPE_DATA32:
+            *value = *(int32_t *)data;
+            return true;
+        case LUMP_DATA_TYPE_DATAF:
+            *value = *(float *)data * 1000;
+            return true;
+        default:
+            return false;
+    }
+}
+
+#if PBIO_CONFIG_NUM_DRIVEBASES > 0
+
+_Static_assert(PBIO_CONFIG_NUM_DRIVEBASES <= TELEMETRY_NUM_INDEXES_MAX, "telemetry must fit all drivebases");
+
+static bool get_drivebase_state(uint8_t index, int32_t *distance, int32_t *angle) {
+    pbio_drivebase_t *db = pbio_drivebase_by_index(index);
+    int32_t drive_speed;
+    int32_t turn_rate;
+    return db && pbio_drivebase_update_loop_is_running(db) &&
+           pbio_drivebase_get_state_user(db, distance, &drive_speed, angle, &turn_rate) == PBIO_SUCCESS;
+}
+
+static bool get_drivebase_distance(uint8_t index, int32_t *value) {
+    int32_t angle;
+    return get_drivebase_state(index, value, &angle);
+}
+
+static bool get_drivebase_angle(uint8_t index, int32_t *value) {
+    int32_t distance;
+    return get_drivebase_state(index, &distance, value);
+}
+
+#endif // PBIO_CONFIG_NUM_DRIVEBASES > 0
+
+#if PBIO_CONFIG_IMU
+
+static bool get_imu_heading(uint8_t index, int32_t *value) {
+    *value = pbio_imu_get_heading(PBIO_IMU_HEADING_TYPE_3D) * 1000;
+    return true;
+}
+
+#endif // PBIO_CONFIG_IMU
+
+#if PBIO_CONFIG_MOTOR_PROCESS_STATS
+
+static bool get_motor_loop(uint8_t index, int32_t *value) {
+    const pbio_motor_process_stats_t *stats = pbio_motor_process_get_stats();
+    const uint32_t values[] = {
+        stats->num_missed,
+        stats->exec_time_max,
+        stats->latency_max,
+    };
+    *value = values[index];
+    return true;
+}
+
+#endif // PBIO_CONFIG_MOTOR_PROCESS_STATS
+
+/**
+ * Schema of all channels. Channels without a getter are not available on
+ * this hub. By default, only what the virtual hub animation needs is sent.
+ */
+static const pbsys_telemetry_channel_info_t channel_info[PBIO_PYBRICKS_TELEMETRY_NUM_CHANNELS] = {
+    [PBIO_PYBRICKS_TELEMETRY_CHANNEL_DEVICE_TYPE] = {
+        .get_value = get_device_type,
+        .num_indexes = PBIO_CONFIG_PORT_NUM_DEV,
+        .default_interval = 200,
+    },
+    [PBIO_PYBRICKS_TELEMETRY_CHANNEL_MOTOR_ANGLE] = {
+        .get_value = get_motor_angle,
+        .num_indexes = PBIO_CONFIG_PORT_NUM_DEV,
+        .default_interval = 40,
+    },
+    [PBIO_PYBRICKS_TELEMETRY_CHANNEL_MOTOR_SPEED] = {
+        .get_value = get_motor_speed,
+        .num_indexes = PBIO_CONFIG_PORT_NUM_DEV,
+    },
+    [PBIO_PYBRICKS_TELEMETRY_CHANNEL_MOTOR_LOAD] = {
+        .get_value = get_motor_load,
+        .num_indexes = PBIO_CONFIG_PORT_NUM_DEV,
+    },
+    [PBIO_PYBRICKS_TELEMETRY_CHANNEL_SENSOR_VALUE] = {
+        .get_value = get_sensor_value,
+        .num_indexes = PBIO_CONFIG_PORT_NUM_DEV,
+    },
+    #if PBIO_CONFIG_NUM_DRIVEBASES > 0
+    [PBIO_PYBRICKS_TELEMETRY_CHANNEL_DRIVEBASE_DISTANCE] = {
+        .get_value = get_drivebase_distance,
+        .num_indexes = PBIO_CONFIG_NUM_DRIVEBASES,
+    },
+    [PBIO_PYBRICKS_TELEMETRY_CHANNEL_DRIVEBASE_ANGLE] = {
+        .get_value = get_drivebase_angle,
+        .num_indexes = PBIO_CONFIG_NUM_DRIVEBASES,
+    },
+    #endif
+    #if PBIO_CONFIG_IMU
+    [PBIO_PYBRICKS_TELEMETRY_CHANNEL_IMU_HEADING] = {
+        .get_value = get_imu_heading,
+        .num_indexes = 1,
+    },
+    #endif
+    #if PBIO_CONFIG_MOTOR_PROCESS_STATS
+    [PBIO_PYBRICKS_TELEMETRY_CHANNEL_MOTOR_LOOP] = {
+        .get_value = get_motor_loop,
+        .num_indexes = 3,
+        .default_interval = 200,
+    },
+    #endif
+};
+
+static pbsys_telemetry_channel_t channels[PBIO_PYBRICKS_TELEMETRY_NUM_CHANNELS];
+
+static pbsys_telemetry_sample_t batch[TELEMETRY_BATCH_NUM_SAMPLES];
+static uint8_t batch_num_samples;
+
+static pbio_os_process_t pbsys_telemetry_process;
+
+/**
+ * Sets how often a telemetry channel is sent to the host.
+ *
+ * @param [in]  channel     The ::pbio_pybricks_telemetry_channel_t channel.
+ * @param [in]  interval    The interval in ms, or 0 to stop sending it.
+ * @return                  ::PBIO_SUCCESS on success or ::PBIO_ERROR_INVALID_ARG
+ *                          if the channel does not exist on this hub.
+ */
+pbio_error_t pbsys_telemetry_set_interval(uint8_t channel, uint16_t interval) {
+    if (channel >= PBIO_PYBRICKS_TELEMETRY_NUM_CHANNELS || !channel_info[channel].get_value) {
+        return PBIO_ERROR_INVALID_ARG;
+    }
+
+    // Send all current values on the next occasion.
+    channels[channel].interval = interval;
+    channels[channel].time = pbdrv_clock_get_ms() - interval;
+    channels[channel].sent = 0;
+    return PBIO_SUCCESS;
+}
+
+/**
+ * Appends a sample to the buffer if the value changed since it was last sent.
+ *
+ * The value is only marked as sent once the batch is sent successfully. See
+ * ::pbsys_telemetry_end_batch.
+ *
+ * @param [in]  channel     The channel.
+ * @param [in]  index       The index within the channel.
+ * @param [in]  buf         Buffer with room for one full sample.
+ * @return                  Number of bytes written.
+ */
+static uint32_t pbsys_telemetry_encode_sample(uint8_t channel, uint8_t index, uint8_t *buf) {
+    pbsys_telemetry_channel_t *ch = &channels[channel];
+    int32_t value;
+
+    // Send again once it becomes available.
+    if (!channel_info[channel].get_value(index, &value)) {
+        ch->sent &= ~(1 << index);
         return 0;
     }
 
-    data->type_id = type_id;
-    data->value = degrees;
+    if ((ch->sent & (1 << index)) && ch->value[index] == value) {
+        return 0;
+    }
 
-    buf[0] = type_id;
+    batch[batch_num_samples++] = (pbsys_telemetry_sample_t) {
+        .channel = channel,
+        .index = index,
+        .value = value,
+    };
+
+    buf[0] = channel;
     buf[1] = index;
-    pbio_set_uint32_le(&buf[2], degrees);
-    return 6;
+    return 2 + pbio_set_varint_zigzag(&buf[2], value);
+}
+
+/**
+ * Ends the batch that was just sent. If it was sent successfully, its values
+ * are marked as sent. Otherwise they are sent again on the next occasion.
+ *
+ * @param [in]  err         Result of sending the batch.
+ */
+static void pbsys_telemetry_end_batch(pbio_error_t err) {
+    for (uint8_t i = 0; err == PBIO_SUCCESS && i < batch_num_samples; i++) {
+        pbsys_telemetry_channel_t *ch = &channels[batch[i].channel];
+        ch->sent |= 1 << batch[i].index;
+        ch->value[batch[i].index] = batch[i].value;
+    }
+    batch_num_samples = 0;
 }
 
 /**
  * Hub, motor, and sensor telemetry to host.
+ *
+ * Channels that are due are sampled together. All changed values are packed
+ * into as few events as possible.
  */
 static pbio_error_t pbsys_telemetry_process_thread(pbio_os_state_t *state, void *context) {
 
     static pbio_os_timer_t timer;
     static pbio_os_state_t sub;
-    static uint8_t buf[20];
-    static uint8_t size;
-    static uint32_t i = 0;
+    static uint8_t buf[TELEMETRY_BATCH_SIZE];
+    static uint32_t size;
+    static uint32_t size_max;
+    static uint8_t channel;
+    static uint8_t index;
+
+    uint32_t now;
+    uint32_t wait;
+    pbio_error_t err;
 
     PBIO_OS_ASYNC_BEGIN(state);
 
     for (;;) {
-        PBIO_OS_AWAIT_MS(state, &timer, 40);
+        // Sleep until the next channel is due.
+        now = pbdrv_clock_get_ms();
+        wait = TELEMETRY_WAIT_MAX_MS;
+        for (channel = 0; channel < PBIO_PYBRICKS_TELEMETRY_NUM_CHANNELS; channel++) {
+            pbsys_telemetry_channel_t *ch = &channels[channel];
+            if (ch->interval) {
+                int32_t remaining = ch->time + ch->interval - now;
+                wait = pbio_int_math_bind(remaining, 0, wait);
+            }
+        }
+        PBIO_OS_AWAIT_MS(state, &timer, wait);
 
-        // Revisit, could concatenate packages for more efficient BLE sending.
-        for (i = 0; i < PBIO_CONFIG_PORT_NUM_DEV; i++) {
-            size = update_port_data(i, buf);
-            if (size) {
-                PBIO_OS_AWAIT(state, &sub, pbsys_host_send_event(&sub, PBIO_PYBRICKS_EVENT_WRITE_TELEMETRY, buf, size));
+        // Resend everything when a host connects.
+        if (!pbsys_host_is_connected()) {
+            for (channel = 0; channel < PBIO_PYBRICKS_TELEMETRY_NUM_CHANNELS; channel++) {
+                channels[channel].sent = 0;
             }
+            continue;
+        }
+
+        size = 0;
+        size_max = pbio_int_math_min(pbsys_host_get_event_size_max(), sizeof(buf));
+        for (channel = 0; channel < PBIO_PYBRICKS_TELEMETRY_NUM_CHANNELS; channel++) {
+            now = pbdrv_clock_get_ms();
+            if (!channels[channel].interval || !pbio_util_time_has_passed(now, channels[channel].time + channels[channel].interval)) {
+                continue;
+            }
+            channels[channel].time = now;
+
+            for (index = 0; index < channel_info[channel].num_indexes; index++) {
+                // Send what we have if the next sample might not fit.
+                if (size && size + 2 + PBIO_VARINT_ZIGZAG_MAX_SIZE > size_max) {
+                    PBIO_OS_AWAIT(state, &sub, err = pbsys_host_send_event(&sub, PBIO_PYBRICKS_EVENT_WRITE_TELEMETRY, buf, size));
+                    pbsys_telemetry_end_batch(err);
+                    size = 0;
+                }
+                size += pbsys_telemetry_encode_sample(channel, index, &buf[size]);
+            }
+        }
+
+        if (size) {
+            PBIO_OS_AWAIT(state, &sub, err = pbsys_host_send_event(&sub, PBIO_PYBRICKS_EVENT_WRITE_TELEMETRY, buf, size));
+            pbsys_telemetry_end_batch(err);
         }
     }
 
@@ -83,7 +442,9 @@ static pbio_error_t pbsys_telemetry_process_thread(pbio_os_state_t *state, void
  * Starts telemetry process.
  */
 void pbsys_telemetry_init(void) {
-    static pbio_os_process_t pbsys_telemetry_process;
+    for (uint8_t i = 0; i < PBIO_PYBRICKS_TELEMETRY_NUM_CHANNELS; i++) {
+        channels[i].interval = channel_info[i].get_value ? channel_info[i].default_interval : 0;
+    }
     pbio_os_process_start(&pbsys_telemetry_process, pbsys_telemetry_process_thread, NULL);
 }
 
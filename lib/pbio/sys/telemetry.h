@@ -4,17 +4,24 @@
 #ifndef _PBSYS_SYS_TELEMETRY_H_
 #define _PBSYS_SYS_TELEMETRY_H_
 
+#include <stdint.h>
+
+#include <pbio/error.h>
 #include <pbsys/config.h>
 
 
 #if PBSYS_CONFIG_TELEMETRY
 
 void pbsys_telemetry_init(void);
+pbio_error_t pbsys_telemetry_set_interval(uint8_t channel, uint16_t interval);
 
 #else
 
 static inline void pbsys_telemetry_init(void) {
 }
+static inline pbio_error_t pbsys_telemetry_set_interval(uint8_t channel, uint16_t interval) {
+    return PBIO_ERROR_NOT_SUPPORTED;
+}
 
 #endif // PBSYS_CONFIG_TELEMETRY
 
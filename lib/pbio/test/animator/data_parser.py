@@ -2,83 +2,182 @@
 
 # This program receives angle data from the simulated pbio motor driver. The
 # driver outputs it at intervals of 40 ms (25 fps).
+#
+# It can also decode binary logs saved with Logger.save(binary=True):
+#
+#     python data_parser.py decode log.bin [log.csv]
 
 from collections import namedtuple
+import csv
 import socket
+import struct
+import sys
 
 HOST = "127.0.0.1"
 PORT = 5002
 
-angles = []
-
-print(f"Listening on {HOST}:{PORT}")
-
-
-# Wait for a connection once and writes results when simulator disconnects.
-with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
-    s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
-    s.bind((HOST, PORT))
-    s.listen(1)
-    conn, addr = s.accept()
-    print(f"Client connected: {addr}")
-    with conn:
-        # receive until client disconnects
-        buffer = b""
-        while True:
-            data = conn.recv(1024)
-            if not data:
-                print("Client disconnected.")
-                break
-            buffer += data
-            while b"\n" in buffer:
-                line, buffer = buffer.split(b"\n", 1)
-                values = list(map(int, line.decode().strip().split()))
-                print("Angles:", values)
-                angles.append(values)
-
-
-if len(angles) < 1:
-    exit()
-
-duration = (len(angles) - 1) * 0.04
-increment = 100 / len(angles)
-
-# Frame info for each rotatary components
-InfoTuple = namedtuple("FrameInfo", ("name", "index", "gearing", "width", "x", "y"))
-FRAME_INFO = (
-    InfoTuple("shaft", index=4, gearing=1, width=152, x=-453, y=212),
-    InfoTuple("stall", index=2, gearing=1, width=344, x=-455, y=-311),
-    InfoTuple("gear-drive", index=5, gearing=-1, width=54, x=243, y=194),
-    InfoTuple("gear-follow", index=5, gearing=3, width=149, x=337, y=194),
-    InfoTuple("wheel-left", index=0, gearing=-1, width=222, x=542, y=-344),
-    InfoTuple("wheel-right", index=1, gearing=1, width=222, x=367, y=-169),
-)
-
-# Write the CSS component with frames.
-with open("lib/pbio/test/results/frames.css", "w") as frame_file:
-    for info in FRAME_INFO:
-        # CSS rows for each frame.
-        frames = "".join(
-            [
-                f"{i * 100 // (len(angles) - 1)}% {{transform: translate({info.x}px, {info.y}px) rotate( {int(row[info.index]) // info.gearing}deg );}}\n"
-                for i, row in enumerate(angles)
-            ]
+LOG_MAGIC = b"PBLG"
+LOG_VERSION = 1
+
+LogColumn = namedtuple("LogColumn", ("name", "scale"))
+
+
+def read_string(data, index):
+    """Reads a length prefixed string and returns it with the next index."""
+    size = data[index]
+    return data[index + 1 : index + 1 + size].decode(), index + 1 + size
+
+
+def read_varint(data, index):
+    """Reads a variable length integer and returns it with the next index."""
+    value = 0
+    shift = 0
+    while True:
+        byte = data[index]
+        index += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, index
+
+
+def decode_log(data):
+    """Decodes a binary log.
+
+    Returns the file path requested by the hub, the list of columns and the
+    list of rows. Rows contain raw integer values. Divide by the column scale
+    to get the value in base units.
+    """
+    if data[:4] != LOG_MAGIC:
+        raise ValueError("Not a binary log.")
+    version, num_cols, num_rows = struct.unpack_from("<BBI", data, 4)
+    if version != LOG_VERSION:
+        raise ValueError(f"Unsupported log version {version}.")
+
+    path, index = read_string(data, 10)
+
+    columns = []
+    for _ in range(num_cols):
+        (scale,) = struct.unpack_from("<i", data, index)
+        name, index = read_string(data, index + 4)
+        columns.append(LogColumn(name, scale))
+
+    # Each value is the zigzag encoded difference with the previous row.
+    rows = []
+    previous = [0] * num_cols
+    for _ in range(num_rows):
+        row = []
+        for col in range(num_cols):
+            zigzag, index = read_varint(data, index)
+            delta = (zigzag >> 1) ^ -(zigzag & 1)
+            value = (previous[col] + delta + 2**31) % 2**32 - 2**31
+            previous[col] = value
+            row.append(value)
+        rows.append(row)
+
+    return path, columns, rows
+
+
+def decode_log_file(in_path, out_path=None):
+    """Converts a binary log file to comma separated values."""
+    with open(in_path, "rb") as in_file:
+        path, columns, rows = decode_log(in_file.read())
+
+    if out_path is None:
+        out_path = in_path.rsplit(".", 1)[0] + ".csv"
+
+    with open(out_path, "w", newline="") as out_file:
+        writer = csv.writer(out_file)
+        writer.writerow(
+            c.name if c.scale == 1 else f"{c.name} (1/{c.scale})" for c in columns
         )
+        writer.writerows(rows)
+
+    print(f"Decoded {len(rows)} rows of {path} to {out_path}")
+
+
+def receive_angles():
+    """Receives angle data until the simulator disconnects."""
+    angles = []
+
+    print(f"Listening on {HOST}:{PORT}")
+
+    # Wait for a connection once and writes results when simulator disconnects.
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as s:
+        s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        s.bind((HOST, PORT))
+        s.listen(1)
+        conn, addr = s.accept()
+        print(f"Client connected: {addr}")
+        with conn:
+            # receive until client disconnects
+            buffer = b""
+            while True:
+                data = conn.recv(1024)
+                if not data:
+                    print("Client disconnected.")
+                    break
+                buffer += data
+                while b"\n" in buffer:
+                    line, buffer = buffer.split(b"\n", 1)
+                    values = list(map(int, line.decode().strip().split()))
+                    print("Angles:", values)
+                    angles.append(values)
+
+    return angles
+
+
+def write_frames(angles):
+    """Writes CSS animation frames for the received angles."""
+    if len(angles) < 1:
+        return
+
+    duration = (len(angles) - 1) * 0.04
+    increment = 100 / len(angles)
+
+    # Frame info for each rotatary components
+    InfoTuple = namedtuple("FrameInfo", ("name", "index", "gearing", "width", "x", "y"))
+    FRAME_INFO = (
+        InfoTuple("shaft", index=4, gearing=1, width=152, x=-453, y=212),
+        InfoTuple("stall", index=2, gearing=1, width=344, x=-455, y=-311),
+        InfoTuple("gear-drive", index=5, gearing=-1, width=54, x=243, y=194),
+        InfoTuple("gear-follow", index=5, gearing=3, width=149, x=337, y=194),
+        InfoTuple("wheel-left", index=0, gearing=-1, width=222, x=542, y=-344),
+        InfoTuple("wheel-right", index=1, gearing=1, width=222, x=367, y=-169),
+    )
+
+    # Write the CSS component with frames.
+    with open("lib/pbio/test/results/frames.css", "w") as frame_file:
+        for info in FRAME_INFO:
+            # CSS rows for each frame.
+            frames = "".join(
+                [
+                    f"{i * 100 // (len(angles) - 1)}% {{transform: translate({info.x}px, {info.y}px) rotate( {int(row[info.index]) // info.gearing}deg );}}\n"
+                    for i, row in enumerate(angles)
+                ]
+            )
+
+            # Main css for this class.
+            css = f"""
+            .{info.name} {{
+                width: {info.width}px;
+                display: inline-block;
+                animation: {info.name}-frames {duration}s 1s linear;
+                animation-fill-mode: forwards;
+                transform: translate({info.x}px, {info.y}px) rotate( {int(angles[0][info.index]) // info.gearing}deg );
+                transform-origin: 50% 50%;
+                position:absolute;
+            }}
+
+            @keyframes {info.name}-frames {{
+            {frames}
+            }}
+            """
+            frame_file.write(css)
+
 
-        # Main css for this class.
-        css = f"""
-        .{info.name} {{
-            width: {info.width}px;
-            display: inline-block;
-            animation: {info.name}-frames {duration}s 1s linear;
-            animation-fill-mode: forwards;
-            transform: translate({info.x}px, {info.y}px) rotate( {int(angles[0][info.index]) // info.gearing}deg );
-            transform-origin: 50% 50%;
-            position:absolute;
-        }}
-
-        @keyframes {info.name}-frames {{
-        {frames}
-        }}
-        """
-        frame_file.write(css)
+if __name__ == "__main__":
+    if len(sys.argv) > 2 and sys.argv[1] == "decode":
+        decode_log_file(*sys.argv[2:4])
+    else:
+        write_frames(receive_angles())
@@ -13,8 +13,12 @@
 #include <tinytest_macros.h>
 #include <tinytest.h>
 
+#include <pbdrv/bluetooth.h>
+#include <pbio/protocol.h>
+
 #include <test-pbio.h>
 
+#include "../../drv/bluetooth/bluetooth.h"
 #include "../../drv/bluetooth/bluetooth_btstack.h"
 #include "../../drv/clock/clock_test.h"
 
@@ -182,7 +186,28 @@ void pbio_test_bluetooth_enable_pybricks_service_notifications(void) {
     pbio_test_bluetooth_enable_notifications(0x000e);
 }
 
+/**
+ * This simulates a remote device requesting a larger MTU.
+ */
+static void pbio_test_bluetooth_exchange_mtu(uint16_t mtu) {
+    const uint16_t length = 3;
+    uint8_t buffer[length + 9];
+
+    buffer[0] = 0x02; // packet type = ACL Data
+    little_endian_store_16(buffer, 1, 0x0400); // connection handle
+    buffer[2] |= 0x02 << 4; // PB flag
+    little_endian_store_16(buffer, 3, length + 4); // total data length
+    little_endian_store_16(buffer, 5, length); // L2CAP length
+    little_endian_store_16(buffer, 7, 4); // Attribute protocol
+    buffer[9] = ATT_EXCHANGE_MTU_REQUEST;
+    little_endian_store_16(buffer, 10, mtu); // client Rx MTU
+
+    queue_packet(buffer, length + 9);
+}
+
 static uint32_t pybricks_service_notification_count;
+static uint8_t pybricks_service_notification_value[HCI_ACL_PAYLOAD_SIZE];
+static uint16_t pybricks_service_notification_size;
 
 /**
  * This count increases each time the hub sends a notification on the Pybricks
@@ -192,6 +217,15 @@ uint32_t pbio_test_bluetooth_get_pybricks_service_notification_count(void) {
     return pybricks_service_notification_count;
 }
 
+/**
+ * Gets the value of the last notification that the hub sent on the Pybricks
+ * service command characteristic.
+ */
+const uint8_t *pbio_test_bluetooth_get_pybricks_service_notification(uint16_t *size) {
+    *size = pybricks_service_notification_size;
+    return pybricks_service_notification_value;
+}
+
 void pbio_test_bluetooth_send_pybricks_command(const uint8_t *data, uint32_t size) {
     // Pybricks command/event characteristic value (comes from header file generated by .gatt)
     const uint16_t attribute_handle = 0x000d;
@@ -448,6 +482,11 @@ static void handle_send(const uint8_t *buffer, uint16_t length) {
                         }
                         break;
 
+                        case 0x03: { // ATT_EXCHANGE_MTU_RESPONSE
+                            log_debug("ATT_EXCHANGE_MTU_RESPONSE: mtu: %u", little_endian_read_16(buffer, 10));
+                        }
+                        break;
+
                         case 0x13: { // ATT_WRITE_RESPONSE
                             // REVISIT: maybe set a flag here?
                         }
@@ -462,6 +501,8 @@ static void handle_send(const uint8_t *buffer, uint16_t length) {
                             switch (attr_handle) {
                                 case 0x000d:
                                     pybricks_service_notification_count++;
+                                    pybricks_service_notification_size = size;
+                                    memcpy(pybricks_service_notification_value, value, size);
                                     break;
                                 case 0x0013:
                                     uart_service_notification_count++;
@@ -819,8 +860,185 @@ static pbio_error_t test_btstack_run_loop_contiki_poll(pbio_os_state_t *state, v
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
 
+static pbio_error_t test_btstack_event_queue(pbio_os_state_t *state, void *context) {
+    static pbio_os_state_t sub[PBDRV_BLUETOOTH_NUM_EVENT_SLOTS + 1];
+    static pbio_os_timer_t timer;
+    static uint32_t count;
+    static uint32_t i;
+    static const uint8_t data[] = { 0x01, 0x02, 0x03, 0x04 };
+    const uint8_t *value;
+    uint16_t size;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    pbio_test_bluetooth_connect();
+    PBIO_OS_AWAIT_UNTIL(state, pbio_test_bluetooth_is_connected());
+
+    // Enabling notifications sends the status right away.
+    count = pbio_test_bluetooth_get_pybricks_service_notification_count();
+    pbio_test_bluetooth_enable_pybricks_service_notifications();
+    PBIO_OS_AWAIT_UNTIL(state, pbio_test_bluetooth_get_pybricks_service_notification_count() != count);
+    tt_want(pbdrv_bluetooth_is_connected(PBDRV_BLUETOOTH_CONNECTION_PYBRICKS));
+
+    // Let status updates due to the new connection settle.
+    PBIO_OS_AWAIT_MS(state, &timer, 20);
+
+    // -- several producers can queue events of the same type --
+
+    for (i = 0; i < PBDRV_BLUETOOTH_NUM_EVENT_SLOTS; i++) {
+        sub[i] = 0;
+        tt_want_uint_op(pbdrv_bluetooth_send_event_notification(&sub[i],
+            PBIO_PYBRICKS_EVENT_WRITE_TELEMETRY, data, sizeof(data)), ==, PBIO_ERROR_AGAIN);
+    }
+
+    // When all slots are in use, the next one waits for a free slot.
+    sub[i] = 0;
+    tt_want_uint_op(pbdrv_bluetooth_send_event_notification(&sub[i],
+        PBIO_PYBRICKS_EVENT_WRITE_TELEMETRY, data, sizeof(data)), ==, PBIO_ERROR_AGAIN);
+
+    // Data was copied, so all are done as soon as there is room for more.
+    count = pbio_test_bluetooth_get_pybricks_service_notification_count();
+    PBIO_OS_AWAIT_UNTIL(state, pbdrv_bluetooth_send_event_notification(&sub[0],
+        PBIO_PYBRICKS_EVENT_WRITE_TELEMETRY, NULL, 0) == PBIO_SUCCESS);
+    for (i = 1; i < PBDRV_BLUETOOTH_NUM_EVENT_SLOTS; i++) {
+        tt_want_uint_op(pbdrv_bluetooth_send_event_notification(&sub[i],
+            PBIO_PYBRICKS_EVENT_WRITE_TELEMETRY, NULL, 0), ==, PBIO_SUCCESS);
+    }
+
+    // Telemetry events are packed into one notification.
+    PBIO_OS_AWAIT_UNTIL(state, pbio_test_bluetooth_get_pybricks_service_notification_count() != count);
+    value = pbio_test_bluetooth_get_pybricks_service_notification(&size);
+    tt_want_uint_op(size, ==, 1 + PBDRV_BLUETOOTH_NUM_EVENT_SLOTS * sizeof(data));
+    tt_want_uint_op(value[0], ==, PBIO_PYBRICKS_EVENT_WRITE_TELEMETRY);
+    tt_want_int_op(memcmp(&value[1], data, sizeof(data)), ==, 0);
+    tt_want_int_op(memcmp(&value[size - sizeof(data)], data, sizeof(data)), ==, 0);
+
+    // The waiting producer copies its data now that a slot is free.
+    i = PBDRV_BLUETOOTH_NUM_EVENT_SLOTS;
+    PBIO_OS_AWAIT(state, &sub[i], pbdrv_bluetooth_send_event_notification(&sub[i],
+        PBIO_PYBRICKS_EVENT_WRITE_TELEMETRY, data, sizeof(data)));
+    PBIO_OS_AWAIT_UNTIL(state, pbio_test_bluetooth_get_pybricks_service_notification_count() == count + 2);
+    value = pbio_test_bluetooth_get_pybricks_service_notification(&size);
+    tt_want_uint_op(size, ==, 1 + sizeof(data));
+
+    PBIO_OS_AWAIT_MS(state, &timer, 10);
+    tt_want_uint_op(pbio_test_bluetooth_get_pybricks_service_notification_count(), ==, count + 2);
+
+    // -- app data events are sent one by one --
+
+    sub[0] = sub[1] = 0;
+    tt_want_uint_op(pbdrv_bluetooth_send_event_notification(&sub[0],
+        PBIO_PYBRICKS_EVENT_WRITE_APP_DATA, data, sizeof(data)), ==, PBIO_ERROR_AGAIN);
+    tt_want_uint_op(pbdrv_bluetooth_send_event_notification(&sub[1],
+        PBIO_PYBRICKS_EVENT_WRITE_APP_DATA, data, 2), ==, PBIO_ERROR_AGAIN);
+
+    count = pbio_test_bluetooth_get_pybricks_service_notification_count();
+    PBIO_OS_AWAIT_UNTIL(state, pbio_test_bluetooth_get_pybricks_service_notification_count() == count + 2);
+    value = pbio_test_bluetooth_get_pybricks_service_notification(&size);
+    tt_want_uint_op(size, ==, 1 + 2);
+    tt_want_uint_op(value[0], ==, PBIO_PYBRICKS_EVENT_WRITE_APP_DATA);
+
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+// Small enough that notifications fit in one ACL packet of the simulated
+// controller.
+#define TEST_STDOUT_MTU (158)
+
+static pbio_error_t test_btstack_stdout_buffer(pbio_os_state_t *state, void *context) {
+    static pbio_os_state_t sub;
+    static pbio_os_timer_t timer;
+    static uint32_t count;
+    static uint8_t data[200];
+    const uint8_t *value;
+    uint16_t value_size;
+    uint32_t size;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    for (size = 0; size < sizeof(data); size++) {
+        data[size] = size;
+    }
+
+    pbio_test_bluetooth_connect();
+    PBIO_OS_AWAIT_UNTIL(state, pbio_test_bluetooth_is_connected());
+
+    count = pbio_test_bluetooth_get_pybricks_service_notification_count();
+    pbio_test_bluetooth_enable_pybricks_service_notifications();
+    PBIO_OS_AWAIT_UNTIL(state, pbio_test_bluetooth_get_pybricks_service_notification_count() != count);
+    PBIO_OS_AWAIT_MS(state, &timer, 20);
+
+    // -- the queue can be resized while it is empty --
+
+    tt_want_uint_op(pbdrv_bluetooth_tx_get_buffer_size(), ==, PBDRV_BLUETOOTH_STDOUT_BUF_SIZE);
+    tt_want_uint_op(pbdrv_bluetooth_tx_set_buffer_size(PBDRV_BLUETOOTH_MAX_CHAR_SIZE - 1), ==, PBIO_ERROR_INVALID_ARG);
+    tt_want_uint_op(pbdrv_bluetooth_tx_set_buffer_size(PBDRV_BLUETOOTH_STDOUT_BUF_SIZE + 1), ==, PBIO_ERROR_INVALID_ARG);
+    tt_want_uint_op(pbdrv_bluetooth_tx_set_buffer_size(100), ==, PBIO_SUCCESS);
+    tt_want_uint_op(pbdrv_bluetooth_tx_get_buffer_size(), ==, 100);
+    tt_want_uint_op(pbdrv_bluetooth_tx_get_high_watermark(), ==, 0);
+
+    // Writes are cut off when the queue is full. The peak usage is tracked.
+    size = 150;
+    tt_want_uint_op(pbdrv_bluetooth_tx(data, &size), ==, PBIO_SUCCESS);
+    tt_want_uint_op(size, ==, 100);
+    tt_want_uint_op(pbdrv_bluetooth_tx_get_high_watermark(), ==, 100);
+    size = 1;
+    tt_want_uint_op(pbdrv_bluetooth_tx(data, &size), ==, PBIO_ERROR_AGAIN);
+    tt_want_uint_op(pbdrv_bluetooth_tx_set_buffer_size(200), ==, PBIO_ERROR_BUSY);
+
+    // With the default MTU, stdout is sent in notifications of that size.
+    count = pbio_test_bluetooth_get_pybricks_service_notification_count();
+    PBIO_OS_AWAIT_UNTIL(state, pbio_test_bluetooth_get_pybricks_service_notification_count() != count);
+    value = pbio_test_bluetooth_get_pybricks_service_notification(&value_size);
+    tt_want_uint_op(value_size, ==, ATT_DEFAULT_MTU - 3);
+    tt_want_uint_op(value[0], ==, PBIO_PYBRICKS_EVENT_WRITE_STDOUT);
+    tt_want_int_op(memcmp(&value[1], data, value_size - 1), ==, 0);
+    PBIO_OS_AWAIT_UNTIL(state, pbdrv_bluetooth_tx_is_idle());
+
+    // -- stdout is drained in notifications as big as the MTU --
+
+    pbio_test_bluetooth_exchange_mtu(TEST_STDOUT_MTU);
+    PBIO_OS_AWAIT_UNTIL(state, pbdrv_bluetooth_get_pybricks_mtu() == TEST_STDOUT_MTU);
+
+    tt_want_uint_op(pbdrv_bluetooth_tx_set_buffer_size(sizeof(data)), ==, PBIO_SUCCESS);
+    tt_want_uint_op(pbdrv_bluetooth_tx_get_high_watermark(), ==, 0);
+    size = sizeof(data);
+    tt_want_uint_op(pbdrv_bluetooth_tx(data, &size), ==, PBIO_SUCCESS);
+    tt_want_uint_op(size, ==, sizeof(data));
+    tt_want_uint_op(pbdrv_bluetooth_tx_get_high_watermark(), ==, sizeof(data));
+
+    count = pbio_test_bluetooth_get_pybricks_service_notification_count();
+    PBIO_OS_AWAIT_UNTIL(state, pbio_test_bluetooth_get_pybricks_service_notification_count() != count);
+    value = pbio_test_bluetooth_get_pybricks_service_notification(&value_size);
+    tt_want_uint_op(value_size, ==, TEST_STDOUT_MTU - 3);
+    tt_want_uint_op(value[0], ==, PBIO_PYBRICKS_EVENT_WRITE_STDOUT);
+    tt_want_int_op(memcmp(&value[1], data, value_size - 1), ==, 0);
+
+    // The rest follows in the next notification.
+    PBIO_OS_AWAIT_UNTIL(state, pbio_test_bluetooth_get_pybricks_service_notification_count() == count + 2);
+    value = pbio_test_bluetooth_get_pybricks_service_notification(&value_size);
+    tt_want_uint_op(value_size, ==, 1 + sizeof(data) - (TEST_STDOUT_MTU - 4));
+    tt_want_uint_op(value[0], ==, PBIO_PYBRICKS_EVENT_WRITE_STDOUT);
+    tt_want_int_op(memcmp(&value[1], &data[TEST_STDOUT_MTU - 4], value_size - 1), ==, 0);
+    PBIO_OS_AWAIT_UNTIL(state, pbdrv_bluetooth_tx_is_idle());
+
+    // The peak remains until the size is set again.
+    tt_want_uint_op(pbdrv_bluetooth_tx_get_high_watermark(), ==, sizeof(data));
+
+    // -- the default size is restored when the program ends --
+
+    pbio_os_timer_set(&timer, 1000);
+    PBIO_OS_AWAIT(state, &sub, pbdrv_bluetooth_close_user_tasks(&sub, &timer));
+    tt_want_uint_op(pbdrv_bluetooth_tx_get_buffer_size(), ==, PBDRV_BLUETOOTH_STDOUT_BUF_SIZE);
+    tt_want_uint_op(pbdrv_bluetooth_tx_get_high_watermark(), ==, 0);
+
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
 struct testcase_t pbdrv_bluetooth_btstack_tests[] = {
     PBIO_THREAD_TEST(test_btstack_run_loop_contiki_timer),
     PBIO_THREAD_TEST(test_btstack_run_loop_contiki_poll),
+    PBIO_THREAD_TEST(test_btstack_event_queue),
+    PBIO_THREAD_TEST(test_btstack_stdout_buffer),
     END_OF_TESTCASES
 };
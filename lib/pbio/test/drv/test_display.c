@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+#include <pbio/util.h>
+#include <test-pbio.h>
+
+#include "../drv/display/display_convert.h"
+
+/**
+ * Tests that triplets encoded with the lookup tables are the same as those
+ * encoded one pixel at a time, including values that are clamped to black.
+ */
+static void test_st7586s_encode_lut(void *env) {
+    static uint8_t lut[3][256];
+    pbdrv_display_st7586s_init_encode_lut(lut);
+
+    // Any value of one pixel, combined with all valid values and a few
+    // out of range values of the other pixels.
+    static const uint8_t others[] = { 0, 1, 2, 3, 4, 128, 255 };
+    for (uint32_t value = 0; value < 256; value++) {
+        for (uint32_t i = 0; i < PBIO_ARRAY_SIZE(others); i++) {
+            for (uint32_t j = 0; j < PBIO_ARRAY_SIZE(others); j++) {
+                uint8_t a = others[i];
+                uint8_t b = others[j];
+                tt_want_int_op(lut[0][value] | lut[1][a] | lut[2][b], ==, pbdrv_display_st7586s_encode_triplet(value, a, b));
+                tt_want_int_op(lut[0][a] | lut[1][value] | lut[2][b], ==, pbdrv_display_st7586s_encode_triplet(a, value, b));
+                tt_want_int_op(lut[0][a] | lut[1][b] | lut[2][value], ==, pbdrv_display_st7586s_encode_triplet(a, b, value));
+            }
+        }
+    }
+
+    // Known patterns.
+    tt_want_int_op(pbdrv_display_st7586s_encode_triplet(0, 0, 0), ==, 0x00);
+    tt_want_int_op(pbdrv_display_st7586s_encode_triplet(1, 2, 0), ==, 0b01010000);
+    tt_want_int_op(pbdrv_display_st7586s_encode_triplet(3, 3, 3), ==, 0xFF);
+
+    // Values above the maximum are black.
+    for (uint32_t value = PBDRV_DISPLAY_ST7586S_VALUE_MAX; value < 256; value++) {
+        tt_want_int_op(lut[0][value] | lut[1][value] | lut[2][value], ==, 0xFF);
+    }
+}
+
+#define UC1601_NUM_COLS (100)
+#define UC1601_NUM_ROWS (64)
+
+/**
+ * Reference page conversion that builds each column byte separately, as the
+ * NXT display driver originally did.
+ */
+static void reference_uc1601_convert_page(uint8_t *dst, uint8_t frame[][UC1601_NUM_COLS], int page) {
+    for (int x = 0; x < UC1601_NUM_COLS; x++) {
+        uint8_t b = 0;
+        for (int y = 0; y < 8; y++) {
+            if (frame[page * 8 + y][x]) {
+                b |= 1 << y;
+            }
+        }
+        dst[x] = b;
+    }
+}
+
+/**
+ * Tests that pages are converted the same as with the reference conversion,
+ * for frames with few, some, and many black pixels.
+ */
+static void test_uc1601_convert_page(void *env) {
+    static uint8_t frame[UC1601_NUM_ROWS][UC1601_NUM_COLS] __attribute__((aligned(4)));
+    uint8_t expected[UC1601_NUM_COLS];
+    uint8_t actual[UC1601_NUM_COLS];
+
+    srand(0);
+
+    static const int percentages[] = { 0, 1, 10, 50, 90, 100 };
+    for (uint32_t p = 0; p < PBIO_ARRAY_SIZE(percentages); p++) {
+        for (int y = 0; y < UC1601_NUM_ROWS; y++) {
+            for (int x = 0; x < UC1601_NUM_COLS; x++) {
+                // Any nonzero value is black.
+                frame[y][x] = rand() % 100 < percentages[p] ? rand() % 255 + 1 : 0;
+            }
+        }
+
+        for (int page = 0; page < UC1601_NUM_ROWS / 8; page++) {
+            // Output must not depend on what was in the buffer before.
+            memset(actual, 0xAA, sizeof(actual));
+            reference_uc1601_convert_page(expected, frame, page);
+            pbdrv_display_uc1601_convert_page(actual, frame[page * 8], UC1601_NUM_COLS);
+            tt_want_int_op(memcmp(actual, expected, sizeof(expected)), ==, 0);
+        }
+    }
+}
+
+struct testcase_t pbdrv_display_tests[] = {
+    PBIO_TEST(test_st7586s_encode_lut),
+    PBIO_TEST(test_uc1601_convert_page),
+    END_OF_TESTCASES
+};
@@ -0,0 +1,116 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2026 The Pybricks Authors
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <pbio/angle.h>
+#include <pbio/control_settings.h>
+#include <pbio/differentiator.h>
+#include <pbio/int_math.h>
+
+#include <test-pbio.h>
+
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+/**
+ * Reference differentiator that sums the increments in the window on every
+ * call, as the differentiator originally did.
+ */
+typedef struct {
+    pbio_angle_t prev_angle;
+    int16_t history[PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE];
+    uint8_t index;
+} reference_t;
+
+static int32_t reference_calc_speed(reference_t *ref, uint8_t window_size) {
+    uint8_t start_index = (ref->index - (window_size - 1) + PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE) % PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE;
+    int32_t total = ref->history[ref->index];
+    for (uint8_t i = start_index; i != ref->index; i = (i + 1) % PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE) {
+        total += ref->history[i];
+    }
+    return total * (1000 / PBIO_CONFIG_CONTROL_LOOP_TIME_MS) / window_size;
+}
+
+static int32_t reference_update(reference_t *ref, const pbio_angle_t *angle) {
+    ref->index = (ref->index + 1) % PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE;
+    ref->history[ref->index] = pbio_int_math_clamp(pbio_angle_diff_mdeg(angle, &ref->prev_angle), INT16_MAX);
+    ref->prev_angle = *angle;
+    return reference_calc_speed(ref, PBIO_CONFIG_DIFFERENTIATOR_WINDOW_SIZE);
+}
+
+static void reference_reset(reference_t *ref, const pbio_angle_t *angle) {
+    *ref = (reference_t) {
+        .prev_angle = *angle,
+    };
+}
+
+/**
+ * Feeds the same angles to the differentiator and the reference and checks
+ * that they give the same speed for every window size.
+ */
+static void test_compare_reference(void *env) {
+
+    srand(0);
+
+    // Start close to a full rotation so that millidegrees wrap around often.
+    pbio_angle_t angle = {
+        .rotations = -1,
+        .millidegrees = 359000,
+    };
+
+    pbio_differentiator_t dif = { 0 };
+    reference_t ref = { 0 };
+    pbio_differentiator_reset(&dif, &angle);
+    reference_reset(&ref, &angle);
+
+    // Run long enough for the ring buffer index to wrap many times.
+    for (uint32_t i = 0; i < 5000; i++) {
+
+        int32_t step;
+        if (i % 500 == 250) {
+            // A big jump such as a reset of the angle, which gets clamped.
+            step = (rand() % 2 ? 1 : -1) * 200000;
+        } else {
+            // Up to about 1000 deg/s in either direction.
+            step = rand() % 10001 - 5000;
+        }
+        pbio_angle_add_mdeg(&angle, step);
+
+        tt_want_int_op(pbio_differentiator_update_and_get_speed(&dif, &angle), ==, reference_update(&ref, &angle));
+
+        for (uint8_t w = 1; w < PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE; w++) {
+            int32_t speed;
+            tt_want_int_op(pbio_differentiator_get_speed(&dif, w * PBIO_CONFIG_CONTROL_LOOP_TIME_MS, &speed), ==, PBIO_SUCCESS);
+            tt_want_int_op(speed, ==, reference_calc_speed(&ref, w));
+        }
+
+        // Reset once in a while, which should bring both back to zero speed.
+        if (i % 1000 == 999) {
+            pbio_differentiator_reset(&dif, &angle);
+            reference_reset(&ref, &angle);
+        }
+    }
+}
+
+/**
+ * Tests that windows that do not fit in the buffer are rejected.
+ */
+static void test_window_bounds(void *env) {
+    pbio_angle_t angle = { 0 };
+    pbio_differentiator_t dif = { 0 };
+    pbio_differentiator_reset(&dif, &angle);
+
+    int32_t speed;
+    tt_want_int_op(pbio_differentiator_get_speed(&dif, 0, &speed), ==, PBIO_ERROR_INVALID_ARG);
+    tt_want_int_op(pbio_differentiator_get_speed(&dif, (PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE - 1) * PBIO_CONFIG_CONTROL_LOOP_TIME_MS, &speed), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_differentiator_get_speed(&dif, PBIO_CONFIG_DIFFERENTIATOR_BUFFER_SIZE * PBIO_CONFIG_CONTROL_LOOP_TIME_MS, &speed), ==, PBIO_ERROR_INVALID_ARG);
+}
+
+struct testcase_t pbio_differentiator_tests[] = {
+    PBIO_TEST(test_compare_reference),
+    PBIO_TEST(test_window_bounds),
+    END_OF_TESTCASES
+};
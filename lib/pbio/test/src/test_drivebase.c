@@ -239,8 +239,94 @@ end:
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
 
+/**
+ * Queues a sequence of segments ahead of time and checks that the drivebase
+ * runs through all of them without stopping in between.
+ */
+static pbio_error_t test_drivebase_queue(pbio_os_state_t *state, void *context) {
+
+    static pbio_servo_t *srv_left;
+    static pbio_servo_t *srv_right;
+    static pbio_drivebase_t *db;
+    static pbio_port_t *port;
+
+    static int32_t drive_distance_start;
+    static int32_t drive_distance;
+    static int32_t drive_speed;
+    static int32_t turn_angle_start;
+    static int32_t turn_angle;
+    static int32_t turn_rate;
+
+    static pbio_os_timer_t timer;
+    static pbio_trajectory_reference_t end;
+    pbio_trajectory_reference_t ref;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    // Initialize the servos.
+    lego_device_type_id_t id = LEGO_DEVICE_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbio_port_get_port(PBIO_PORT_ID_A, &port), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_port_get_servo(port, &id, &srv_left), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv_left, id, PBIO_DIRECTION_COUNTERCLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_port_get_port(PBIO_PORT_ID_B, &port), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_port_get_servo(port, &id, &srv_right), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv_right, id, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+
+    // Set up the drivebase.
+    tt_uint_op(pbio_drivebase_get_drivebase(&db, srv_left, srv_right, 56000, 112000), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_drivebase_get_state_user(db, &drive_distance_start, &drive_speed, &turn_angle_start, &turn_rate), ==, PBIO_SUCCESS);
+
+    // Queue everything up front: straight, curve right, curve left, straight.
+    tt_uint_op(pbio_drivebase_queue_straight(db, 500, PBIO_CONTROL_ON_COMPLETION_CONTINUE), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_drivebase_queue_curve(db, 200, 90, PBIO_CONTROL_ON_COMPLETION_CONTINUE), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_drivebase_queue_arc_angle(db, -200, 90, PBIO_CONTROL_ON_COMPLETION_CONTINUE), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_drivebase_queue_straight(db, 500, PBIO_CONTROL_ON_COMPLETION_CONTINUE), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_drivebase_queue_straight(db, 0, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+
+    // The first segment started right away, and the queue is now full.
+    tt_uint_op(pbio_drivebase_queue_straight(db, 100, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_ERROR_BUSY);
+    tt_want(!pbio_drivebase_is_done(db));
+
+    // Run through all segments.
+    PBIO_OS_AWAIT_UNTIL(state, pbio_drivebase_is_done(db));
+
+    // The arcs cancel each other out, so the robot should be facing forward
+    // after traveling both straight segments and two quarter circles.
+    tt_uint_op(pbio_drivebase_get_state_user(db, &drive_distance, &drive_speed, &turn_angle, &turn_rate), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(drive_distance - drive_distance_start, 500 + 314 + 314 + 500, 30));
+    tt_want(pbio_test_int_is_close(turn_angle, turn_angle_start, 5));
+
+    // Starting a new command discards anything that was queued.
+    drive_distance_start = drive_distance;
+    tt_uint_op(pbio_drivebase_drive_straight(db, 200, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_drivebase_queue_straight(db, 1000, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_drivebase_drive_straight(db, 0, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    PBIO_OS_AWAIT_UNTIL(state, pbio_drivebase_is_done(db));
+    tt_uint_op(pbio_drivebase_get_state_user(db, &drive_distance, &drive_speed, &turn_angle, &turn_rate), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(drive_distance, drive_distance_start, 30));
+
+    // Queueing while holding after a completed maneuver starts from where
+    // the robot is now, not from the old endpoint, so the reference does not
+    // jump ahead.
+    PBIO_OS_AWAIT_MS(state, &timer, 1000);
+    pbio_trajectory_get_endpoint(&db->control_distance.trajectory, &end);
+    tt_uint_op(pbio_drivebase_queue_straight(db, 100, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    tt_want_int_op(db->control_distance.queue.count, ==, 0);
+    PBIO_OS_AWAIT_MS(state, &timer, 20);
+    pbio_trajectory_get_reference_uncached(&db->control_distance.trajectory, pbio_control_get_ref_time(&db->control_distance, pbio_control_get_time_ticks()), &ref);
+    tt_want(pbio_test_int_is_close(pbio_angle_diff_mdeg(&ref.position, &end.position), 0, 5000));
+    PBIO_OS_AWAIT_UNTIL(state, pbio_drivebase_is_done(db));
+    tt_uint_op(pbio_drivebase_get_state_user(db, &drive_distance, &drive_speed, &turn_angle, &turn_rate), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(drive_distance, drive_distance_start + 100, 30));
+
+end:
+
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
 struct testcase_t pbio_drivebase_tests[] = {
     PBIO_THREAD_TEST(test_drivebase_basics),
     PBIO_THREAD_TEST(test_drivebase_stalling),
+    PBIO_THREAD_TEST(test_drivebase_queue),
     END_OF_TESTCASES
 };
@@ -6,12 +6,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include <tinytest.h>
 #include <tinytest_macros.h>
 #include <test-pbio.h>
 
 #include <pbio/image.h>
+#include <pbio/util.h>
 
 // Tests use an outer image and an inner image which is a sub-image of the
 // outer image.
@@ -1000,6 +1002,245 @@ static void test_image_print(void *env) {
         "..*....***...***....");
 }
 
+static void test_image_dirty(void *env) {
+    pbio_image_t small, sub;
+    pbio_image_dirty_t dirty;
+    pbio_image_rect_t rect;
+
+    test_image_prepare_small_image(&small);
+    pbio_image_track_dirty(&small, &dirty);
+
+    // Whole image is initially modified.
+    tt_want(pbio_image_take_dirty(&dirty, &rect));
+    tt_want_int_op(rect.x, ==, 0);
+    tt_want_int_op(rect.y, ==, 0);
+    tt_want_int_op(rect.width, ==, SMALL_IMAGE_WIDTH);
+    tt_want_int_op(rect.height, ==, SMALL_IMAGE_HEIGHT);
+    tt_want(!pbio_image_take_dirty(&dirty, &rect));
+
+    // Clipped drawing only extends the visible part.
+    pbio_image_draw_pixel(&small, 3, 2, '*');
+    pbio_image_draw_hline(&small, -5, 4, 7, '*');
+    pbio_image_draw_pixel(&small, 50, 50, '*');
+    tt_want(pbio_image_take_dirty(&dirty, &rect));
+    tt_want_int_op(rect.x, ==, 0);
+    tt_want_int_op(rect.y, ==, 2);
+    tt_want_int_op(rect.width, ==, 4);
+    tt_want_int_op(rect.height, ==, 3);
+
+    // Drawing in a viewport is reported in tracked image coordinates.
+    pbio_image_init_sub(&sub, &small, 10, 1, 5, 5);
+    pbio_image_fill_rect(&sub, 1, 1, 10, 2, '#');
+    tt_want(pbio_image_take_dirty(&dirty, &rect));
+    tt_want_int_op(rect.x, ==, 11);
+    tt_want_int_op(rect.y, ==, 2);
+    tt_want_int_op(rect.width, ==, 4);
+    tt_want_int_op(rect.height, ==, 2);
+
+    // Drawing outside of the image does not modify anything.
+    pbio_image_draw_vline(&sub, 6, 0, 3, '#');
+    tt_want(!pbio_image_take_dirty(&dirty, &rect));
+}
+
+// Image for glyph drawing tests, large enough for one line of text.
+#define GLYPH_IMAGE_WIDTH 160
+#define GLYPH_IMAGE_HEIGHT 24
+
+static uint8_t test_image_glyph_pixels[2][GLYPH_IMAGE_HEIGHT][GLYPH_IMAGE_WIDTH];
+
+// Font with glyphs that are too complex to fit in the glyph cache, so that
+// the glyphs are drawn without it. All glyphs share the same bitmap.
+static const uint8_t test_image_striped_font_data[16 * 2] = {
+    0xaa, 0xaa, 0x55, 0x55, 0xaa, 0xaa, 0x55, 0x55,
+    0xaa, 0xaa, 0x55, 0x55, 0xaa, 0xaa, 0x55, 0x55,
+    0xaa, 0xaa, 0x55, 0x55, 0xaa, 0xaa, 0x55, 0x55,
+    0xaa, 0xaa, 0x55, 0x55, 0xaa, 0xaa, 0x55, 0x55,
+};
+
+static pbio_font_glyph_t test_image_striped_font_glyphs['~' - ' ' + 2];
+
+static const pbio_font_t test_image_striped_font = {
+    .first = ' ',
+    .last = '~',
+    .line_height = 18,
+    .top_max = 14,
+    .glyphs = test_image_striped_font_glyphs,
+    .data = test_image_striped_font_data,
+    .kernings = NULL,
+    .family_name = "Test",
+    .style_name = "Striped",
+};
+
+static void test_image_prepare_striped_font(void) {
+    for (size_t i = 0; i < PBIO_ARRAY_SIZE(test_image_striped_font_glyphs); i++) {
+        test_image_striped_font_glyphs[i] = (pbio_font_glyph_t) {
+            .width = 13,
+            .height = 16,
+            .advance = 14,
+            .left = 0,
+            .top = 14,
+        };
+    }
+}
+
+// Draws text one pixel at a time, as a reference for the optimized glyph
+// drawing. Layout is the same as pbio_image_draw_text.
+static void test_image_draw_text_reference(pbio_image_t *image,
+    const pbio_font_t *font, int x, int y, const char *text, uint8_t value) {
+    int x_left = x;
+    char prev = 0;
+
+    for (const char *p = text; *p; p++) {
+        char c = *p;
+        if (c == '\n') {
+            x = x_left;
+            y += font->line_height;
+        } else if (c >= font->first && c <= font->last) {
+            const pbio_font_glyph_t *g = &font->glyphs[c - font->first];
+            if (font->kernings && prev) {
+                for (const pbio_font_kerning_t *k = &font->kernings[g->kerning_index];
+                     k != &font->kernings[(g + 1)->kerning_index]; k++) {
+                    if (prev == k->previous) {
+                        x += k->kerning;
+                        break;
+                    }
+                }
+            }
+            int row_size = (g->width + 7) / 8;
+            const uint8_t *row = &font->data[g->data_index];
+            for (int dy = 0; dy < g->height; dy++, row += row_size) {
+                for (int dx = 0; dx < g->width; dx++) {
+                    if (row[dx / 8] & (0x80 >> (dx % 8))) {
+                        pbio_image_draw_pixel(image, x + g->left + dx,
+                            y - g->top + dy, value);
+                    }
+                }
+            }
+            x += g->advance;
+        }
+        prev = c;
+    }
+}
+
+static void test_image_prepare_glyph_images(pbio_image_t *image,
+    pbio_image_t *reference) {
+    memset(test_image_glyph_pixels, 0, sizeof(test_image_glyph_pixels));
+    pbio_image_init(image, &test_image_glyph_pixels[0][0][0],
+        GLYPH_IMAGE_WIDTH, GLYPH_IMAGE_HEIGHT, GLYPH_IMAGE_WIDTH);
+    pbio_image_init(reference, &test_image_glyph_pixels[1][0][0],
+        GLYPH_IMAGE_WIDTH, GLYPH_IMAGE_HEIGHT, GLYPH_IMAGE_WIDTH);
+}
+
+static bool test_image_glyph_images_equal(void) {
+    return !memcmp(test_image_glyph_pixels[0], test_image_glyph_pixels[1],
+        sizeof(test_image_glyph_pixels[0]));
+}
+
+// Glyphs drawn by the span blitter, from the glyph cache, and partly clipped
+// must be identical to drawing them one pixel at a time.
+static void test_image_draw_glyphs(void *env) {
+    static const char text[] = "AVA Wj{q}!";
+    static const struct {
+        int x;
+        int y;
+    } positions[] = {
+        // Fully visible.
+        { 1, 0 },
+        // Clipped on one side.
+        { -5, 0 },
+        { 1, -6 },
+        { 1, GLYPH_IMAGE_HEIGHT - 10 },
+        { GLYPH_IMAGE_WIDTH - 40, 0 },
+        // Clipped on two sides.
+        { -7, -9 },
+    };
+    const pbio_font_t *fonts[] = {
+        &pbio_font_liberationsans_regular_14,
+        &pbio_font_terminus_normal_16,
+        &pbio_font_mono_8x5_8,
+        &test_image_striped_font,
+    };
+    pbio_image_t image, reference;
+    pbio_image_rect_t rect;
+
+    test_image_prepare_striped_font();
+
+    for (size_t f = 0; f < PBIO_ARRAY_SIZE(fonts); f++) {
+        const pbio_font_t *font = fonts[f];
+        for (size_t i = 0; i < PBIO_ARRAY_SIZE(positions); i++) {
+            int x = positions[i].x;
+            int y_top = positions[i].y;
+
+            // Drawing text always uses the span blitter.
+            test_image_prepare_glyph_images(&image, &reference);
+            pbio_image_draw_text(&image, font, x, y_top + font->top_max,
+                text, strlen(text), 3);
+            test_image_draw_text_reference(&reference, font, x,
+                y_top + font->top_max, text, 3);
+            tt_want_msg(test_image_glyph_images_equal(), font->family_name);
+
+            // Printing uses the glyph cache for fully visible glyphs if the
+            // font fits. It wraps instead of clipping on the right side.
+            pbio_image_bbox_text(font, text, strlen(text), &rect);
+            if (x + rect.x + rect.width > GLYPH_IMAGE_WIDTH) {
+                continue;
+            }
+            test_image_prepare_glyph_images(&image, &reference);
+            image.print_font = font;
+            image.print_value = 3;
+            image.print_x_left = x;
+            image.print_y_top = y_top;
+            pbio_image_print(&image, text, strlen(text));
+            test_image_draw_text_reference(&reference, font, x,
+                y_top + font->top_max, text, 3);
+            tt_want_msg(test_image_glyph_images_equal(), font->family_name);
+        }
+    }
+}
+
+// Benchmark text drawing, using a display sized image. Results are only
+// shown in verbose mode.
+static void test_image_text_speed(void *env) {
+    static uint8_t pixels[128][180];
+    static const char text[] = "The quick brown fox jumps over the lazy dog.\n";
+    const pbio_font_t *font = &pbio_font_terminus_normal_16;
+    pbio_image_t image;
+    clock_t start;
+    double elapsed;
+    int glyphs;
+
+    pbio_image_init(&image, &pixels[0][0], 178, 128, 180);
+    pbio_image_fill(&image, 0);
+    image.print_font = font;
+    image.print_value = 3;
+
+    glyphs = 0;
+    start = clock();
+    for (int i = 0; i < 2000; i++) {
+        pbio_image_draw_text(&image, font, (i % 8) * 4, (i % 8) * 16 + 12,
+            text, sizeof(text) - 2, 3);
+        glyphs += sizeof(text) - 2;
+    }
+    elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    if (tinytest_get_verbosity_() > 1) {
+        printf("\n    draw_text: %.0f glyphs/s", glyphs / (elapsed > 0 ? elapsed : 1e-9));
+    }
+
+    glyphs = 0;
+    start = clock();
+    for (int i = 0; i < 2000; i++) {
+        pbio_image_print(&image, text, sizeof(text) - 1);
+        glyphs += sizeof(text) - 1;
+    }
+    elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    if (tinytest_get_verbosity_() > 1) {
+        printf("\n    print: %.0f glyphs/s", glyphs / (elapsed > 0 ? elapsed : 1e-9));
+    }
+
+    // Something was drawn.
+    tt_want(memchr(pixels, 3, sizeof(pixels)) != NULL);
+}
+
 struct testcase_t pbio_image_tests[] = {
     PBIO_TEST(test_image_fill),
     PBIO_TEST(test_image_draw_image),
@@ -1014,5 +1255,8 @@ struct testcase_t pbio_image_tests[] = {
     PBIO_TEST(test_image_fill_circle),
     PBIO_TEST(test_image_draw_text),
     PBIO_TEST(test_image_print),
+    PBIO_TEST(test_image_dirty),
+    PBIO_TEST(test_image_draw_glyphs),
+    PBIO_TEST(test_image_text_speed),
     END_OF_TESTCASES
 };
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+#include <stdio.h>
+#include <string.h>
+
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+#include <pbio/logger.h>
+#include <test-pbio.h>
+
+static void test_logger_stream(void *env) {
+
+    static pbio_log_t log;
+    static int32_t buf[4 * 2];
+    const int32_t *row;
+
+    pbio_logger_start_stream(&log, buf, 4, 2, 1);
+    tt_want(pbio_logger_is_active(&log));
+    tt_want(pbio_logger_is_stream(&log));
+    tt_want_ptr_op(pbio_logger_stream_read_row(&log), ==, NULL);
+
+    // Fill the buffer and overflow it by two rows, which get dropped.
+    for (int32_t i = 0; i < 6; i++) {
+        pbio_logger_add_row(&log, &i);
+    }
+    tt_want_uint_op(pbio_logger_stream_get_num_available(&log), ==, 4);
+    tt_want_uint_op(pbio_logger_stream_get_num_overruns(&log), ==, 2);
+    tt_want(pbio_logger_is_active(&log));
+
+    // Read two rows, then keep adding rows while reading the rest, so that
+    // the ring buffer wraps around.
+    for (int32_t i = 0; i < 2; i++) {
+        row = pbio_logger_stream_read_row(&log);
+        tt_want_int_op(row[1], ==, i);
+    }
+    for (int32_t i = 10; i < 12; i++) {
+        pbio_logger_add_row(&log, &i);
+    }
+    tt_want_uint_op(pbio_logger_stream_get_num_available(&log), ==, 4);
+
+    const int32_t expected[] = { 2, 3, 10, 11 };
+    for (size_t i = 0; i < 4; i++) {
+        row = pbio_logger_stream_read_row(&log);
+        tt_want_int_op(row[1], ==, expected[i]);
+    }
+    tt_want_ptr_op(pbio_logger_stream_read_row(&log), ==, NULL);
+    tt_want_uint_op(pbio_logger_stream_get_num_overruns(&log), ==, 2);
+
+    // Stopping keeps the unread data.
+    int32_t value = 20;
+    pbio_logger_add_row(&log, &value);
+    pbio_logger_stop(&log);
+    tt_want(!pbio_logger_is_active(&log));
+    tt_want_uint_op(pbio_logger_stream_get_num_available(&log), ==, 1);
+    row = pbio_logger_stream_read_row(&log);
+    tt_want_int_op(row[1], ==, value);
+}
+
+static void test_logger_binary(void *env) {
+
+    #define NUM_ROWS (100)
+    static pbio_log_t log;
+    static int32_t buf[NUM_ROWS * 3];
+    static const pbio_logger_column_t columns[] = {
+        { .name = "angle", .scale = 1 },
+        { .name = "voltage", .scale = 1000 },
+    };
+
+    pbio_logger_start(&log, buf, NUM_ROWS, 3, 1);
+    for (int32_t i = 0; i < NUM_ROWS; i++) {
+        int32_t row[] = { i * 3 - 50, i % 2 ? INT32_MIN : INT32_MAX };
+        pbio_logger_add_row(&log, row);
+    }
+
+    uint8_t header[64];
+    size_t size = pbio_logger_binary_encode_header(&log, columns, "log.bin", header, sizeof(header));
+    const uint8_t expected[] = {
+        'P', 'B', 'L', 'G', PBIO_LOGGER_BINARY_VERSION, 3, NUM_ROWS, 0, 0, 0,
+        7, 'l', 'o', 'g', '.', 'b', 'i', 'n',
+        0xe8, 0x03, 0, 0, 8, 'l', 'o', 'g', '_', 't', 'i', 'm', 'e',
+        1, 0, 0, 0, 5, 'a', 'n', 'g', 'l', 'e',
+        0xe8, 0x03, 0, 0, 7, 'v', 'o', 'l', 't', 'a', 'g', 'e',
+    };
+    tt_want_uint_op(size, ==, sizeof(expected));
+    tt_want(memcmp(header, expected, sizeof(expected)) == 0);
+
+    // Header does not fit.
+    tt_want_uint_op(pbio_logger_binary_encode_header(&log, columns, "log.bin", header, sizeof(expected) - 1), ==, 0);
+
+    // Encode in small chunks like they would be sent to the host.
+    static uint8_t data[NUM_ROWS * 3 * PBIO_LOGGER_BINARY_MAX_VALUE_SIZE];
+    uint32_t cursor = 0;
+    size = 0;
+    size_t chunk_size;
+    while ((chunk_size = pbio_logger_binary_encode_rows(&log, &cursor, data + size, 19))) {
+        tt_want_uint_op(chunk_size, <=, 19);
+        size += chunk_size;
+    }
+    tt_want_uint_op(cursor, ==, NUM_ROWS * 3);
+
+    // Decode and compare with the original data.
+    uint32_t previous[3] = { 0 };
+    size_t index = 0;
+    for (uint32_t i = 0; i < NUM_ROWS * 3; i++) {
+        uint32_t zigzag = 0;
+        for (uint32_t shift = 0; index < size; shift += 7) {
+            uint8_t byte = data[index++];
+            zigzag |= (uint32_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                break;
+            }
+        }
+        uint32_t delta = (zigzag >> 1) ^ (zigzag & 1 ? UINT32_MAX : 0);
+        previous[i % 3] += delta;
+        tt_want_int_op((int32_t)previous[i % 3], ==, buf[i]);
+    }
+    tt_want_uint_op(index, ==, size);
+
+    // Only the alternating extreme column should need many bytes.
+    tt_want_uint_op(size, <, NUM_ROWS * (2 + PBIO_LOGGER_BINARY_MAX_VALUE_SIZE));
+    #undef NUM_ROWS
+}
+
+struct testcase_t pbio_logger_tests[] = {
+    PBIO_TEST(test_logger_stream),
+    PBIO_TEST(test_logger_binary),
+    END_OF_TESTCASES
+};
@@ -31,9 +31,8 @@
 struct _pbdrv_uart_dev_t {
     int baud;
     pbio_os_timer_t rx_timer;
-    uint8_t *rx_msg;
-    uint8_t rx_msg_length;
-    pbio_error_t rx_msg_result;
+    uint8_t rx_data[64];
+    uint32_t rx_data_length;
     const uint8_t *tx_msg;
     pbio_os_timer_t tx_timer;
     uint8_t tx_msg_length;
@@ -56,30 +55,31 @@ pbio_error_t simulate_rx_msg(pbio_os_state_t *state, const uint8_t *msg, uint8_t
 
     PBIO_OS_ASYNC_BEGIN(state);
 
-    // First uartdev reads one byte header
-    PBIO_OS_AWAIT_UNTIL(state, test_uart.rx_msg_result == PBIO_ERROR_AGAIN);
-    tt_uint_op(test_uart.rx_msg_length, ==, 1);
-    memcpy(test_uart.rx_msg, msg, 1);
-    test_uart.rx_msg_result = PBIO_SUCCESS;
+    // The whole message arrives in the receive buffer at once.
+    tt_uint_op(test_uart.rx_data_length + length, <=, sizeof(test_uart.rx_data));
+    memcpy(&test_uart.rx_data[test_uart.rx_data_length], msg, length);
+    test_uart.rx_data_length += length;
 
     simulate_uart_complete_irq();
 
-    if (length == 1) {
-        return PBIO_SUCCESS;
-    }
-
-    // then read rest of message
-    PBIO_OS_AWAIT_UNTIL(state, test_uart.rx_msg_result == PBIO_ERROR_AGAIN);
-    tt_uint_op(test_uart.rx_msg_length, ==, length - 1);
-    memcpy(test_uart.rx_msg, &msg[1], length - 1);
-    test_uart.rx_msg_result = PBIO_SUCCESS;
-
-    simulate_uart_complete_irq();
+    // Wait for the message to be consumed by the reader.
+    PBIO_OS_AWAIT_UNTIL(state, test_uart.rx_data_length == 0);
 
 end:
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
 
+/**
+ * Adds data to the receive buffer without waiting for it to be read. This is
+ * used to simulate a message that arrives in parts.
+ */
+static void simulate_rx_partial_msg(const uint8_t *msg, uint8_t length) {
+    tt_want_uint_op(test_uart.rx_data_length + length, <=, sizeof(test_uart.rx_data));
+    memcpy(&test_uart.rx_data[test_uart.rx_data_length], msg, length);
+    test_uart.rx_data_length += length;
+    simulate_uart_complete_irq();
+}
+
 pbio_error_t simulate_tx_msg(pbio_os_state_t *state, const uint8_t *msg, uint8_t length) {
     PBIO_OS_ASYNC_BEGIN(state);
 
@@ -224,6 +224,8 @@ static pbio_error_t test_boost_color_distance_sensor(pbio_os_state_t *state, voi
     static pbio_port_lump_mode_info_t *mode_info;
     static uint8_t current_mode;
     static uint8_t num_modes;
+    static uint32_t sample_cursor;
+    static const pbio_port_lump_sample_t *sample;
 
     pbio_error_t err;
 
@@ -438,10 +440,20 @@ static pbio_error_t test_boost_color_distance_sensor(pbio_os_state_t *state, voi
     // should be blocked since data with new mode has not been received yet
     tt_uint_op(pbio_port_lump_is_ready(lump_dev), ==, PBIO_ERROR_AGAIN);
 
+    // no samples since now
+    sample_cursor = pbio_port_lump_get_sample_cursor(lump_dev);
+    tt_uint_op(pbio_port_lump_get_sample(lump_dev, &sample_cursor, &sample), ==, PBIO_ERROR_AGAIN);
+
     // send data message with new mode
     SIMULATE_RX_MSG(msg90);
     SIMULATE_RX_MSG(msg91);
 
+    // only the data message is recorded as a sample
+    tt_uint_op(pbio_port_lump_get_sample(lump_dev, &sample_cursor, &sample), ==, PBIO_SUCCESS);
+    tt_uint_op(sample->mode, ==, 8);
+    tt_uint_op(sample->size, ==, 4);
+    tt_uint_op(pbio_port_lump_get_sample(lump_dev, &sample_cursor, &sample), ==, PBIO_ERROR_AGAIN);
+
     PBIO_OS_AWAIT_WHILE(state, (err = pbio_port_lump_is_ready(lump_dev)) == PBIO_ERROR_AGAIN);
     tt_uint_op(err, ==, PBIO_SUCCESS);
     type_id = LEGO_DEVICE_TYPE_ID_ANY_LUMP_UART;
@@ -500,6 +512,11 @@ static pbio_error_t test_boost_interactive_motor(pbio_os_state_t *state, void *c
 
     static const uint8_t msg37[] = { 0x02 }; // NACK
 
+    // Corrupted data stream.
+    static const uint8_t msg38[] = { 0x00, 0x00, 0x00 }; // noise
+    static const uint8_t msg39[] = { 0xD2, 0x5A, 0x00, 0x00, 0x00, 0x77 }; // mode 2, angle 90
+    static const uint8_t msg40[] = { 0x00, 0xD2, 0xB4, 0x00, 0x00, 0x00, 0x99 }; // noise, then mode 2, angle 180
+
     // used in SIMULATE_RX/TX_MSG macros
     static pbio_os_state_t child;
 
@@ -510,6 +527,10 @@ static pbio_error_t test_boost_interactive_motor(pbio_os_state_t *state, void *c
     static uint8_t current_mode;
     static uint8_t num_modes;
     static pbio_error_t err;
+    static pbio_os_timer_t timer;
+    uint32_t resync_count;
+    uint32_t dropped_bytes;
+    int32_t *angle;
 
     PBIO_OS_ASYNC_BEGIN(state);
 
@@ -609,6 +630,39 @@ static pbio_error_t test_boost_interactive_motor(pbio_os_state_t *state, void *c
     tt_want_uint_op(mode_info[3].data_type, ==, LUMP_DATA_TYPE_DATA16);
     tt_want_uint_op(mode_info[3].writable, ==, 0);
 
+    // So far, the data stream was clean.
+    pbio_port_lump_get_rx_stats(lump_dev, &resync_count, &dropped_bytes);
+    tt_want_uint_op(resync_count, ==, 0);
+    tt_want_uint_op(dropped_bytes, ==, 0);
+
+    // Consecutive bad bytes are dropped, but count as one resync.
+    SIMULATE_RX_MSG(msg38);
+    pbio_port_lump_get_rx_stats(lump_dev, &resync_count, &dropped_bytes);
+    tt_want_uint_op(resync_count, ==, 1);
+    tt_want_uint_op(dropped_bytes, ==, 3);
+
+    // The first part of a message is kept until the rest arrives.
+    simulate_rx_partial_msg(msg39, 2);
+    PBIO_OS_AWAIT_MS(state, &timer, 5);
+    tt_want_uint_op(test_uart.rx_data_length, ==, 2);
+    PBIO_OS_AWAIT(state, &child, err = simulate_rx_msg(&child, &msg39[2], sizeof(msg39) - 2));
+    tt_uint_op(err, ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_port_lump_get_data(lump_dev, LEGO_DEVICE_MODE_PUP_REL_MOTOR__POS, (void **)&angle), ==, PBIO_SUCCESS);
+    tt_want_int_op(*angle, ==, 90);
+
+    // A split message is not an error.
+    pbio_port_lump_get_rx_stats(lump_dev, &resync_count, &dropped_bytes);
+    tt_want_uint_op(resync_count, ==, 1);
+    tt_want_uint_op(dropped_bytes, ==, 3);
+
+    // A message right after noise is still found.
+    SIMULATE_RX_MSG(msg40);
+    tt_uint_op(pbio_port_lump_get_data(lump_dev, LEGO_DEVICE_MODE_PUP_REL_MOTOR__POS, (void **)&angle), ==, PBIO_SUCCESS);
+    tt_want_int_op(*angle, ==, 180);
+    pbio_port_lump_get_rx_stats(lump_dev, &resync_count, &dropped_bytes);
+    tt_want_uint_op(resync_count, ==, 2);
+    tt_want_uint_op(dropped_bytes, ==, 4);
+
 
 end:
 
@@ -1057,28 +1111,44 @@ void pbdrv_uart_init(void) {
 void pbdrv_uart_stop(pbdrv_uart_dev_t *uart_dev) {
 }
 
+uint32_t pbdrv_uart_in_waiting(pbdrv_uart_dev_t *uart_dev) {
+    return uart_dev->rx_data_length;
+}
+
+uint32_t pbdrv_uart_peek(pbdrv_uart_dev_t *uart_dev, uint32_t offset, uint8_t *data, uint32_t length) {
+    if (offset >= uart_dev->rx_data_length) {
+        return 0;
+    }
+    if (length > uart_dev->rx_data_length - offset) {
+        length = uart_dev->rx_data_length - offset;
+    }
+    memcpy(data, &uart_dev->rx_data[offset], length);
+    return length;
+}
+
+void pbdrv_uart_skip(pbdrv_uart_dev_t *uart_dev, uint32_t length) {
+    if (length > uart_dev->rx_data_length) {
+        length = uart_dev->rx_data_length;
+    }
+    uart_dev->rx_data_length -= length;
+    memmove(uart_dev->rx_data, &uart_dev->rx_data[length], uart_dev->rx_data_length);
+}
+
 pbio_error_t pbdrv_uart_read(pbio_os_state_t *state, pbdrv_uart_dev_t *uart_dev, uint8_t *msg, uint32_t length, uint32_t timeout) {
 
     PBIO_OS_ASYNC_BEGIN(state);
 
-    PBIO_OS_AWAIT_WHILE(state, uart_dev->rx_msg);
-
-    uart_dev->rx_msg = msg;
-    uart_dev->rx_msg_length = length;
-    uart_dev->rx_msg_result = PBIO_ERROR_AGAIN;
     pbio_os_timer_set(&uart_dev->rx_timer, timeout);
 
-    // If read_pos is less that read_length then we have not read everything yet
-    PBIO_OS_AWAIT_WHILE(state, uart_dev->rx_msg_result == PBIO_ERROR_AGAIN && !pbio_os_timer_is_expired(&uart_dev->rx_timer));
-    if (pbio_os_timer_is_expired(&uart_dev->rx_timer)) {
-        uart_dev->rx_msg_result = PBIO_ERROR_TIMEDOUT;
+    PBIO_OS_AWAIT_UNTIL(state, uart_dev->rx_data_length >= length || pbio_os_timer_is_expired(&uart_dev->rx_timer));
+    if (uart_dev->rx_data_length < length) {
+        return PBIO_ERROR_TIMEDOUT;
     }
 
-    if (uart_dev->rx_msg_result != PBIO_ERROR_AGAIN) {
-        uart_dev->rx_msg = NULL;
-    }
+    pbdrv_uart_peek(uart_dev, 0, msg, length);
+    pbdrv_uart_skip(uart_dev, length);
 
-    PBIO_OS_ASYNC_END(uart_dev->rx_msg_result);
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
 
 pbio_error_t pbdrv_uart_write(pbio_os_state_t *state, pbdrv_uart_dev_t *uart_dev, const uint8_t *msg, uint32_t length, uint32_t timeout) {
@@ -4,8 +4,10 @@
 #include <stdio.h>
 
 #include <math.h>
+#include <time.h>
 
 #include <pbio/int_math.h>
+#include <pbio/util.h>
 #include <test-pbio.h>
 
 #include <tinytest.h>
@@ -120,9 +122,60 @@ static void test_mult_and_scale(void *env) {
     }
 }
 
+static void test_div_reciprocal(void *env) {
+
+    // Divisors from the observer models plus edge cases.
+    static const int32_t divisors[] = {
+        1, -1, 2, -2, 3, 7, 934, 1000, 1587, -2332, 8311, 65536, -165023,
+        -919183, 7431528, INT32_MAX, -INT32_MAX,
+    };
+
+    // Numerators, with edge cases first and then a spread of other values.
+    int32_t numerators[4096] = { 0, 1, -1, INT32_MAX, -INT32_MAX, INT32_MIN };
+    uint32_t seed = 1;
+    for (size_t i = 6; i < PBIO_ARRAY_SIZE(numerators); i++) {
+        seed = seed * 1664525 + 1013904223;
+        numerators[i] = (int32_t)seed >> (i % 24);
+    }
+
+    volatile int32_t sink = 0;
+    clock_t time_div = 0;
+    clock_t time_reciprocal = 0;
+
+    for (size_t d = 0; d < PBIO_ARRAY_SIZE(divisors); d++) {
+        // Not optimized away as a constant, like real model data.
+        volatile int32_t divisor = divisors[d];
+        const pbio_int_math_reciprocal_t reciprocal = PBIO_INT_MATH_RECIPROCAL(divisor);
+
+        for (size_t i = 0; i < PBIO_ARRAY_SIZE(numerators); i++) {
+            int32_t n = numerators[i];
+            // Overflows for C division too.
+            if (n == INT32_MIN && divisor == -1) {
+                continue;
+            }
+            tt_want_int_op(pbio_int_math_div_reciprocal(n, &reciprocal), ==, n / divisor);
+        }
+
+        // Compare speed with the division instruction, skipping edge cases.
+        clock_t start = clock();
+        for (size_t i = 6; i < PBIO_ARRAY_SIZE(numerators); i++) {
+            sink += numerators[i] / divisor;
+        }
+        time_div += clock() - start;
+        start = clock();
+        for (size_t i = 6; i < PBIO_ARRAY_SIZE(numerators); i++) {
+            sink += pbio_int_math_div_reciprocal(numerators[i], &reciprocal);
+        }
+        time_reciprocal += clock() - start;
+    }
+
+    TT_BLATHER(("division: %ld ticks, reciprocal: %ld ticks", (long)time_div, (long)time_reciprocal));
+}
+
 struct testcase_t pbio_int_math_tests[] = {
     PBIO_TEST(test_atan2),
     PBIO_TEST(test_clamp),
+    PBIO_TEST(test_div_reciprocal),
     PBIO_TEST(test_mult_and_scale),
     PBIO_TEST(test_sqrt),
     END_OF_TESTCASES
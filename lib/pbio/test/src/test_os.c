@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: MIT
+// Copyright (c) 2025 The Pybricks Authors
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <pbio/os.h>
+#include <test-pbio.h>
+
+#include <tinytest.h>
+#include <tinytest_macros.h>
+
+typedef struct {
+    pbio_os_process_t process;
+    pbio_os_timer_t timer;
+    uint32_t period;
+    uint32_t num_calls;
+    uint32_t num_expired;
+} test_periodic_t;
+
+static pbio_error_t test_periodic_thread(pbio_os_state_t *state, void *context) {
+
+    test_periodic_t *p = context;
+
+    p->num_calls++;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    for (;;) {
+        PBIO_OS_AWAIT_MS(state, &p->timer, p->period);
+        p->num_expired++;
+    }
+
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+static bool test_flag;
+static uint32_t test_flag_num_calls;
+
+static pbio_error_t test_flag_thread(pbio_os_state_t *state, void *context) {
+
+    test_flag_num_calls++;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    PBIO_OS_AWAIT_UNTIL(state, test_flag);
+
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+static pbio_error_t test_event_driven_processes(pbio_os_state_t *state, void *context) {
+
+    static pbio_os_timer_t timer;
+    static test_periodic_t fast = { .period = 10 };
+    static test_periodic_t slow = { .period = 25 };
+    static pbio_os_process_t flag_process;
+    static uint32_t num_skipped;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    pbio_os_process_start_on_event(&fast.process, test_periodic_thread, &fast);
+    pbio_os_process_start_on_event(&slow.process, test_periodic_thread, &slow);
+    pbio_os_process_start_on_event(&flag_process, test_flag_thread, NULL);
+    num_skipped = pbio_os_get_stats()->num_skipped;
+
+    PBIO_OS_AWAIT_MS(state, &timer, 105);
+
+    // Processes run once to start and then only when their timer expires.
+    tt_want(pbio_test_int_is_close(fast.num_expired, 10, 1));
+    tt_want(pbio_test_int_is_close(slow.num_expired, 4, 1));
+    tt_want_uint_op(fast.num_calls, ==, fast.num_expired + 1);
+    tt_want_uint_op(slow.num_calls, ==, slow.num_expired + 1);
+
+    // The condition waiting process was not polled again.
+    tt_want_uint_op(test_flag_num_calls, ==, 1);
+    tt_want_uint_op(pbio_os_get_stats()->num_skipped, >, num_skipped);
+
+    // The earliest deadline belongs to one of the periodic processes.
+    uint32_t deadline;
+    tt_want(pbio_os_timer_get_next_deadline(&deadline));
+    tt_want(deadline == fast.timer.start + fast.timer.duration || deadline == slow.timer.start + slow.timer.duration);
+
+    // Polling it directly runs it.
+    test_flag = true;
+    pbio_os_process_request_poll(&flag_process);
+    PBIO_OS_AWAIT_ONCE(state);
+    tt_want_uint_op(test_flag_num_calls, ==, 2);
+    tt_want_uint_op(flag_process.err, ==, PBIO_SUCCESS);
+
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+static uint32_t test_count_num_calls;
+
+static pbio_error_t test_count_thread(pbio_os_state_t *state, void *context) {
+    test_count_num_calls++;
+    return PBIO_ERROR_AGAIN;
+}
+
+static void test_targeted_poll(void *env) {
+
+    pbio_os_process_t broadcast_process = { 0 };
+    pbio_os_process_t event_process = { 0 };
+
+    pbio_os_process_start(&broadcast_process, test_count_thread, NULL);
+    pbio_os_process_start_on_event(&event_process, test_flag_thread, NULL);
+    while (pbio_os_run_processes_once()) {
+        ;
+    }
+    tt_want_uint_op(test_count_num_calls, ==, 1);
+    tt_want_uint_op(test_flag_num_calls, ==, 1);
+
+    // A targeted poll only runs the polled process.
+    uint32_t num_runs = pbio_os_get_stats()->num_runs;
+    pbio_os_process_request_poll(&event_process);
+    tt_want(!pbio_os_run_processes_once());
+    tt_want_uint_op(test_flag_num_calls, ==, 2);
+    tt_want_uint_op(test_count_num_calls, ==, 1);
+    tt_want_uint_op(pbio_os_get_stats()->num_runs, ==, num_runs + 1);
+
+    // A broadcast poll runs the other processes.
+    pbio_os_request_poll();
+    tt_want(!pbio_os_run_processes_once());
+    tt_want_uint_op(test_count_num_calls, ==, 2);
+    tt_want_uint_op(test_flag_num_calls, ==, 2);
+}
+
+struct testcase_t pbio_os_tests[] = {
+    PBIO_THREAD_TEST(test_event_driven_processes),
+    PBIO_TEST(test_targeted_poll),
+    END_OF_TESTCASES
+};
@@ -14,9 +14,11 @@
 #include <tinytest.h>
 #include <tinytest_macros.h>
 
+#include <pbdrv/clock.h>
 #include <pbdrv/motor_driver.h>
 #include <pbio/angle.h>
 #include <pbio/control.h>
+#include <pbio/control_settings.h>
 #include <pbio/error.h>
 #include <pbio/logger.h>
 #include <pbio/int_math.h>
@@ -24,6 +26,7 @@
 #include <pbio/os.h>
 #include <pbio/port_interface.h>
 #include <pbio/servo.h>
+#include <pbio/util.h>
 #include <test-pbio.h>
 
 #include "../drv/clock/clock_test.h"
@@ -74,6 +77,12 @@ static pbio_error_t test_servo_basics(pbio_os_state_t *state, void *context) {
     PBIO_OS_AWAIT_UNTIL(state, pbio_control_is_done(&srv->control));
     tt_want(pbio_test_int_is_close(speed, 0, 50));
 
+    // With the test clock, the control loop never falls behind.
+    const pbio_motor_process_stats_t *stats = pbio_motor_process_get_stats();
+    tt_want(stats->num_ticks > 0);
+    tt_want_uint_op(stats->num_missed, ==, 0);
+    tt_want_uint_op(stats->latency_histogram[0], ==, stats->num_ticks);
+
 end:;
 
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
@@ -178,9 +187,114 @@ end:
     PBIO_OS_ASYNC_END(PBIO_SUCCESS);
 }
 
+/**
+ * Tests that acceleration smoothing set through the control settings is used
+ * by servo maneuvers.
+ */
+static pbio_error_t test_servo_smoothing(pbio_os_state_t *state, void *context) {
+
+    static pbio_servo_t *srv;
+    static pbio_port_t *port;
+
+    static int32_t angle;
+    static int32_t speed;
+    static uint32_t time_start;
+    static uint32_t duration_trapezoid;
+    static uint32_t duration_smooth;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    lego_device_type_id_t id = LEGO_DEVICE_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbio_port_get_port(PBIO_PORT_ID_B, &port), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_port_get_servo(port, &id, &srv), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv, LEGO_DEVICE_TYPE_ID_SPIKE_M_MOTOR, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+
+    // Defaults to trapezoid and only accepts percentages.
+    tt_want_int_op(pbio_control_settings_get_trajectory_smoothing(&srv->control.settings), ==, 0);
+    tt_want_uint_op(pbio_control_settings_set_trajectory_smoothing(&srv->control.settings, -1), ==, PBIO_ERROR_INVALID_ARG);
+    tt_want_uint_op(pbio_control_settings_set_trajectory_smoothing(&srv->control.settings, 101), ==, PBIO_ERROR_INVALID_ARG);
+
+    // Run a trapezoidal maneuver.
+    time_start = pbdrv_clock_get_ms();
+    tt_uint_op(pbio_servo_run_target(srv, 500, 720, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    PBIO_OS_AWAIT_UNTIL(state, pbio_control_is_done(&srv->control));
+    duration_trapezoid = pbdrv_clock_get_ms() - time_start;
+    tt_uint_op(pbio_servo_get_state_user(srv, &angle, &speed), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(angle, 720, 5));
+
+    // The same maneuver back, fully smoothed. This halves the average
+    // acceleration, so it takes longer but arrives at the target all the same.
+    tt_uint_op(pbio_control_settings_set_trajectory_smoothing(&srv->control.settings, 100), ==, PBIO_SUCCESS);
+    tt_want_int_op(pbio_control_settings_get_trajectory_smoothing(&srv->control.settings), ==, 100);
+    time_start = pbdrv_clock_get_ms();
+    tt_uint_op(pbio_servo_run_target(srv, 500, 0, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    tt_want_int_op(srv->control.trajectory.smoothing, ==, 100);
+    PBIO_OS_AWAIT_UNTIL(state, pbio_control_is_done(&srv->control));
+    duration_smooth = pbdrv_clock_get_ms() - time_start;
+    tt_uint_op(pbio_servo_get_state_user(srv, &angle, &speed), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(angle, 0, 5));
+    tt_want_uint_op(duration_smooth, >, duration_trapezoid + 100);
+
+end:
+
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+static pbio_error_t test_servo_queue_after_hold(pbio_os_state_t *state, void *context) {
+
+    static pbio_servo_t *srv;
+    static pbio_port_t *port;
+    static pbio_os_timer_t timer;
+
+    static pbio_trajectory_reference_t end;
+    static uint32_t time_queued;
+    static int32_t angle;
+    static int32_t speed;
+
+    pbio_trajectory_reference_t ref;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    lego_device_type_id_t id = LEGO_DEVICE_TYPE_ID_ANY_ENCODED_MOTOR;
+    tt_uint_op(pbio_port_get_port(PBIO_PORT_ID_B, &port), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_port_get_servo(port, &id, &srv), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_setup(srv, LEGO_DEVICE_TYPE_ID_SPIKE_M_MOTOR, PBIO_DIRECTION_CLOCKWISE, 1000, true, 0), ==, PBIO_SUCCESS);
+    tt_uint_op(pbio_servo_reset_angle(srv, 0, false), ==, PBIO_SUCCESS);
+
+    // Complete a maneuver and keep holding for a while.
+    tt_uint_op(pbio_servo_run_angle(srv, 500, 180, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    PBIO_OS_AWAIT_UNTIL(state, pbio_control_is_done(&srv->control));
+    PBIO_OS_AWAIT_MS(state, &timer, 1000);
+    tt_want(pbio_control_type_is_position(&srv->control));
+    pbio_trajectory_get_endpoint(&srv->control.trajectory, &end);
+
+    // Queueing after the maneuver has ended starts right away, from where
+    // the motor is holding, instead of from the old endpoint.
+    time_queued = pbio_control_get_time_ticks();
+    tt_uint_op(pbio_servo_queue_angle(srv, 500, 180, PBIO_CONTROL_ON_COMPLETION_HOLD), ==, PBIO_SUCCESS);
+    tt_want(!pbio_util_time_has_passed(time_queued, srv->control.trajectory.start.time + 1));
+    tt_want_int_op(srv->control.queue.count, ==, 0);
+
+    // Shortly after, the reference has only just started accelerating.
+    PBIO_OS_AWAIT_MS(state, &timer, 20);
+    pbio_trajectory_get_reference_uncached(&srv->control.trajectory, pbio_control_get_ref_time(&srv->control, pbio_control_get_time_ticks()), &ref);
+    tt_want(pbio_test_int_is_close(pbio_angle_diff_mdeg(&ref.position, &end.position), 0, 5000));
+
+    // It still ends up at the new target.
+    PBIO_OS_AWAIT_UNTIL(state, pbio_control_is_done(&srv->control));
+    tt_uint_op(pbio_servo_get_state_user(srv, &angle, &speed), ==, PBIO_SUCCESS);
+    tt_want(pbio_test_int_is_close(angle, 360, 5));
+
+end:
+
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
 struct testcase_t pbio_servo_tests[] = {
     PBIO_THREAD_TEST(test_servo_basics),
     PBIO_THREAD_TEST(test_servo_stall),
     PBIO_THREAD_TEST(test_servo_gearing),
+    PBIO_THREAD_TEST(test_servo_smoothing),
+    PBIO_THREAD_TEST(test_servo_queue_after_hold),
     END_OF_TESTCASES
 };
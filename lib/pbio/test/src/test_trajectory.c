@@ -3,6 +3,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include <pbio/int_math.h>
 #include <pbio/trajectory.h>
@@ -65,6 +66,85 @@ static void test_simple_trajectory(void *env) {
     tt_want_int_op(trj.a2, ==, -command.deceleration / MDEG_PER_DEG);
 }
 
+/**
+ * This tests the same simple command as above, but with acceleration phases
+ * smoothed into an S-curve.
+ */
+static void test_simple_smoothed_trajectory(void *env) {
+
+    // Command: Run for 10000 degrees at 1000 deg/s with a = 2000 deg/s/s, with
+    // full smoothing. The acceleration ramps up to 2000 deg/s/s in 500 ms and
+    // back down in another 500 ms, so the average is 1000 deg/s/s. We travel
+    // 500 degrees on each ramp, so overall expected duration is 11000 ms.
+
+    static pbio_angle_t start = {
+        .rotations = 0,
+        .millidegrees = 0,
+    };
+
+    pbio_angle_t end = {
+        .rotations = 27,
+        .millidegrees = 280 * MDEG_PER_DEG,
+    };
+
+    pbio_trajectory_command_t command = {
+        .time_start = 0,
+        .position_start = start,
+        .position_end = end,
+        .speed_start = 0,
+        .speed_target = 1000 * MDEG_PER_DEG,
+        .speed_max = 1000 * MDEG_PER_DEG,
+        .acceleration = 2000 * MDEG_PER_DEG,
+        .deceleration = 2000 * MDEG_PER_DEG,
+        .smoothing = PBIO_TRAJECTORY_SMOOTHING_MAX,
+        .continue_running = false,
+    };
+
+    pbio_trajectory_t trj;
+    pbio_error_t err = pbio_trajectory_new_angle_command(&trj, &command);
+    tt_want_int_op(err, ==, PBIO_SUCCESS);
+
+    tt_want_int_op(trj.t1, ==, 1000 * 10);
+    tt_want_int_op(trj.t2, ==, 10000 * 10);
+    tt_want_int_op(trj.t3, ==, 11000 * 10);
+    tt_want_int_op(trj.th1, ==, 500 * MDEG_PER_DEG);
+    tt_want_int_op(trj.th2, ==, 9500 * MDEG_PER_DEG);
+    tt_want_int_op(trj.th3, ==, 10000 * MDEG_PER_DEG);
+    tt_want_int_op(trj.a0, ==, command.acceleration / MDEG_PER_DEG / 2);
+    tt_want_int_op(trj.a2, ==, -command.deceleration / MDEG_PER_DEG / 2);
+
+    // Acceleration starts at zero and ramps up linearly.
+    pbio_trajectory_reference_t ref;
+    pbio_trajectory_get_reference(&trj, 0, &ref);
+    tt_want_int_op(ref.speed, ==, 0);
+    tt_want_int_op(ref.acceleration, ==, 0);
+
+    pbio_trajectory_get_reference(&trj, 250 * 10, &ref);
+    tt_want_int_op(ref.speed, ==, 125 * MDEG_PER_DEG);
+    tt_want_int_op(ref.acceleration, ==, 1000 * MDEG_PER_DEG);
+
+    // Peak acceleration equals the configured limit.
+    pbio_trajectory_get_reference(&trj, 500 * 10, &ref);
+    tt_want_int_op(ref.speed, ==, 500 * MDEG_PER_DEG);
+    tt_want_int_op(ref.acceleration, ==, command.acceleration);
+    tt_want_int_op(pbio_angle_diff_mdeg(&ref.position, &start), ==, 83333);
+
+    // The second half is the reverse of the first.
+    pbio_trajectory_get_reference(&trj, 750 * 10, &ref);
+    tt_want_int_op(ref.speed, ==, 875 * MDEG_PER_DEG);
+    tt_want_int_op(ref.acceleration, ==, 1000 * MDEG_PER_DEG);
+    tt_want_int_op(pbio_angle_diff_mdeg(&ref.position, &start), ==, 260416);
+
+    // The same holds for the deceleration, which ends where the trapezoid would.
+    pbio_trajectory_get_reference(&trj, 10500 * 10, &ref);
+    tt_want_int_op(ref.speed, ==, 500 * MDEG_PER_DEG);
+    tt_want_int_op(ref.acceleration, ==, -command.deceleration);
+    pbio_trajectory_get_reference(&trj, 11000 * 10, &ref);
+    tt_want_int_op(ref.speed, ==, 0);
+    tt_want_int_op(ref.acceleration, ==, 0);
+    tt_want_int_op(pbio_angle_diff_mdeg(&ref.position, &end), ==, 0);
+}
+
 static void walk_trajectory(pbio_trajectory_t *trj) {
 
     // Get the starting reference.
@@ -97,8 +177,10 @@ static void walk_trajectory(pbio_trajectory_t *trj) {
         pbio_trajectory_get_reference(trj, now, &ref_now);
 
         // Skip if current time equals start time. Then there is no previous
-        // sample to compare to.
+        // sample to compare to. This also happens if the trajectory was just
+        // rebased, so take this sample as the previous one for the next.
         if (now == trj->start.time) {
+            ref_prev = ref_now;
             continue;
         }
 
@@ -119,8 +201,10 @@ static void walk_trajectory(pbio_trajectory_t *trj) {
         pbio_trajectory_reference_t last_vertex_prev;
         pbio_trajectory_get_last_vertex(trj, now - increment, &last_vertex_prev);
 
-        // Now we can compare the speeds.
+        // Now we can compare the speeds. Smoothed phases may have equal
+        // acceleration on both samples without it being constant in between.
         if (ref_now.acceleration == ref_prev.acceleration &&
+            (trj->smoothing == 0 || ref_now.acceleration == 0) &&
             last_vertex_now.time == last_vertex_prev.time) {
             int32_t delta = ref_now.speed - ref_prev.speed;
             int32_t delta_expected = ref_now.acceleration * (increment / 10000.0f);
@@ -191,6 +275,7 @@ static void get_infinite_command(uint32_t index, pbio_trajectory_command_t *c) {
     c->duration = DURATION_FOREVER_TICKS;
     c->speed_max = 1000 * MDEG_PER_DEG;
     c->continue_running = true;
+    c->smoothing = 0;
 
     c->position_start = angles[index % PBIO_ARRAY_SIZE(angles)];
     index /= PBIO_ARRAY_SIZE(angles);
@@ -287,6 +372,7 @@ static const uint32_t num_position_trajectories =
 static void get_position_command(uint32_t index, pbio_trajectory_command_t *c) {
 
     c->speed_max = 1000 * MDEG_PER_DEG;
+    c->smoothing = 0;
 
     c->continue_running = index % 2;
     index /= 2;
@@ -370,9 +456,209 @@ static void test_position_trajectory(void *env) {
     }
 }
 
+/**
+ * Walks a smoothed trajectory and asserts that the acceleration changes
+ * gradually and stays within the limits of the command.
+ */
+static void walk_smoothed_trajectory(pbio_trajectory_t *trj, const pbio_trajectory_command_t *c) {
+
+    // Very low limits are raised to the minimum first, so allow for that.
+    int32_t acceleration_max = pbio_int_math_max(pbio_int_math_max(c->acceleration, c->deceleration), 100 * MDEG_PER_DEG);
+
+    // Acceleration changes can be large in short phases, so only check jerk
+    // if all phases take at least a tenth of a second.
+    int32_t t_ramp = trj->t1;
+    if (trj->t3 != trj->t2) {
+        t_ramp = pbio_int_math_min(t_ramp, trj->t3 - trj->t2);
+    }
+    bool check_jerk = t_ramp >= 1000;
+
+    pbio_trajectory_reference_t ref_prev, ref_now;
+    pbio_trajectory_get_reference(trj, trj->start.time, &ref_prev);
+
+    if (trj->t1 > 0 && trj->t1 * c->smoothing / 200 > 0) {
+        tt_want_int_op(ref_prev.acceleration, ==, 0);
+    }
+
+    uint32_t duration = trj->t3 == DURATION_FOREVER_TICKS ? trj->t1 * 2 + 10000 : trj->t3 + 10000;
+    const uint32_t increment = 50;
+    for (uint32_t t = increment; t < duration; t += increment) {
+        pbio_trajectory_get_reference(trj, trj->start.time + t, &ref_now);
+
+        tt_want_int_op(pbio_int_math_abs(ref_now.acceleration), <=, acceleration_max + acceleration_max / 50);
+        if (check_jerk) {
+            // Between samples, the acceleration changes at most by the peak
+            // times the step over the shortest jerk duration.
+            int32_t change_max = acceleration_max / (t_ramp * c->smoothing / 200) * 11 / 10 * (int32_t)increment + MDEG_PER_DEG;
+            tt_want_int_op(pbio_int_math_abs(ref_now.acceleration - ref_prev.acceleration), <=, change_max);
+        }
+        ref_prev = ref_now;
+    }
+}
+
+/**
+ * Walks a trajectory with cached and uncached evaluation and asserts that they
+ * give the same result. Most steps are one control tick, with occasional
+ * repeats and jumps to cover re-evaluation from scratch.
+ */
+static void compare_cached_trajectory(pbio_trajectory_t *trj, clock_t *time_cached, clock_t *time_uncached) {
+
+    uint32_t duration = pbio_trajectory_get_duration(trj);
+    if (duration == DURATION_FOREVER_TICKS) {
+        duration = trj->t1 * 2 + 10000;
+    } else {
+        duration = pbio_int_math_min(duration + 10000, duration * 2);
+    }
+
+    // Collect sample times first, so both variants evaluate the same points.
+    static uint32_t times[4096];
+    size_t num_times = 0;
+    for (uint32_t t = 0; t < duration && num_times < PBIO_ARRAY_SIZE(times); num_times++) {
+        times[num_times] = trj->start.time + t;
+        t += num_times % 97 == 0 ? 1234 : num_times % 31 == 0 ? 0 : 50;
+    }
+
+    static pbio_trajectory_reference_t refs[PBIO_ARRAY_SIZE(times)];
+
+    clock_t start = clock();
+    for (size_t i = 0; i < num_times; i++) {
+        pbio_trajectory_get_reference(trj, times[i], &refs[i]);
+    }
+    *time_cached += clock() - start;
+
+    pbio_trajectory_reference_t ref;
+    start = clock();
+    for (size_t i = 0; i < num_times; i++) {
+        pbio_trajectory_get_reference_uncached(trj, times[i], &ref);
+    }
+    *time_uncached += clock() - start;
+
+    for (size_t i = 0; i < num_times; i++) {
+        pbio_trajectory_get_reference_uncached(trj, times[i], &ref);
+        tt_want_int_op(refs[i].time, ==, ref.time);
+        tt_want_int_op(pbio_angle_diff_mdeg(&refs[i].position, &ref.position), ==, 0);
+        tt_want_int_op(refs[i].speed, ==, ref.speed);
+        tt_want_int_op(refs[i].acceleration, ==, ref.acceleration);
+    }
+}
+
+// Smoothing values to test, alternated between trajectories.
+static const int32_t smoothings[] = {
+    1, 50, PBIO_TRAJECTORY_SMOOTHING_MAX,
+};
+
+// Only every few trajectories are tested with smoothing, to save time.
+#define SMOOTHED_TRAJECTORY_STRIDE (5)
+
+static void test_smoothed_position_trajectory(void *env) {
+
+    pbio_trajectory_command_t command;
+
+    for (uint32_t i = 0; i < num_position_trajectories; i += SMOOTHED_TRAJECTORY_STRIDE) {
+        get_position_command(i, &command);
+        command.smoothing = smoothings[i % PBIO_ARRAY_SIZE(smoothings)];
+
+        // Calculate the trajectory.
+        pbio_trajectory_t trj;
+        pbio_error_t err = pbio_trajectory_new_angle_command(&trj, &command);
+
+        // Very low speeds or accelerations with long angles are not valid.
+        if (err == PBIO_ERROR_INVALID_ARG) {
+            continue;
+        }
+
+        // Otherwise we want success.
+        tt_want_int_op(err, ==, PBIO_SUCCESS);
+
+        // Smoothing does not change the endpoint.
+        pbio_trajectory_reference_t end;
+        pbio_trajectory_get_endpoint(&trj, &end);
+        if (command.speed_target != 0) {
+            tt_want_int_op(pbio_angle_diff_mdeg(&end.position, &command.position_end), ==, 0);
+        }
+
+        // Walk the whole trajectory.
+        walk_trajectory(&trj);
+        walk_smoothed_trajectory(&trj, &command);
+    }
+}
+
+static void test_smoothed_infinite_trajectory(void *env) {
+
+    pbio_trajectory_command_t command;
+
+    for (uint32_t i = 0; i < num_infinite_trajectories; i += SMOOTHED_TRAJECTORY_STRIDE) {
+        get_infinite_command(i, &command);
+        command.smoothing = smoothings[i % PBIO_ARRAY_SIZE(smoothings)];
+
+        // Calculate the trajectory.
+        pbio_trajectory_t trj;
+        pbio_error_t err = pbio_trajectory_new_time_command(&trj, &command);
+        tt_want_int_op(err, ==, PBIO_SUCCESS);
+
+        // Verify that we maintain a constant speed when done.
+        tt_want_int_op(trj.w1, ==, trj.w3);
+
+        // Walk the whole trajectory.
+        walk_trajectory(&trj);
+
+        err = pbio_trajectory_new_time_command(&trj, &command);
+        tt_want_int_op(err, ==, PBIO_SUCCESS);
+        walk_smoothed_trajectory(&trj, &command);
+
+        // The target speed is reached and kept after the smoothed on-ramp.
+        int32_t expected_speed = pbio_int_math_abs(command.speed_target) < command.speed_max ?
+            command.speed_target :
+            pbio_int_math_sign(command.speed_target) * command.speed_max;
+        pbio_trajectory_reference_t ref;
+        pbio_trajectory_get_reference(&trj, command.time_start + trj.t1 + DURATION_FOREVER_TICKS / 4, &ref);
+        tt_want_int_op(ref.speed, ==, expected_speed);
+        tt_want_int_op(ref.acceleration, ==, 0);
+    }
+}
+
+static void test_cached_trajectory(void *env) {
+
+    pbio_trajectory_command_t command;
+    pbio_trajectory_t trj;
+    clock_t time_cached = 0;
+    clock_t time_uncached = 0;
+
+    for (uint32_t i = 0; i < num_position_trajectories; i++) {
+        get_position_command(i, &command);
+        if (pbio_trajectory_new_angle_command(&trj, &command) != PBIO_SUCCESS) {
+            continue;
+        }
+        compare_cached_trajectory(&trj, &time_cached, &time_uncached);
+    }
+
+    for (uint32_t i = 0; i < num_infinite_trajectories; i++) {
+        get_infinite_command(i, &command);
+        tt_want_int_op(pbio_trajectory_new_time_command(&trj, &command), ==, PBIO_SUCCESS);
+        compare_cached_trajectory(&trj, &time_cached, &time_uncached);
+    }
+
+    // Smoothed phases are always evaluated from scratch, but the remaining
+    // segments must still agree when switching between the two.
+    for (uint32_t i = 0; i < num_position_trajectories; i += SMOOTHED_TRAJECTORY_STRIDE) {
+        get_position_command(i, &command);
+        command.smoothing = smoothings[i % PBIO_ARRAY_SIZE(smoothings)];
+        if (pbio_trajectory_new_angle_command(&trj, &command) != PBIO_SUCCESS) {
+            continue;
+        }
+        compare_cached_trajectory(&trj, &time_cached, &time_uncached);
+    }
+
+    TT_BLATHER(("cached: %ld ticks, uncached: %ld ticks", (long)time_cached, (long)time_uncached));
+}
+
 struct testcase_t pbio_trajectory_tests[] = {
     PBIO_TEST(test_simple_trajectory),
     PBIO_TEST(test_position_trajectory),
     PBIO_TEST(test_infinite_trajectory),
+    PBIO_TEST(test_simple_smoothed_trajectory),
+    PBIO_TEST(test_smoothed_position_trajectory),
+    PBIO_TEST(test_smoothed_infinite_trajectory),
+    PBIO_TEST(test_cached_trajectory),
     END_OF_TESTCASES
 };
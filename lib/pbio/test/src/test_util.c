@@ -63,9 +63,34 @@ static void test_oneshot(void *env) {
     tt_want(pbio_oneshot(true, &test_oneshot));
 }
 
+static void test_varint_zigzag(void *env) {
+    uint8_t buf[PBIO_VARINT_ZIGZAG_MAX_SIZE];
+
+    // Small values of either sign take one byte.
+    tt_want_uint_op(pbio_set_varint_zigzag(buf, 0), ==, 1);
+    tt_want_uint_op(buf[0], ==, 0);
+    tt_want_uint_op(pbio_set_varint_zigzag(buf, -1), ==, 1);
+    tt_want_uint_op(buf[0], ==, 1);
+    tt_want_uint_op(pbio_set_varint_zigzag(buf, 63), ==, 1);
+    tt_want_uint_op(buf[0], ==, 126);
+
+    tt_want_uint_op(pbio_set_varint_zigzag(buf, -65), ==, 2);
+    tt_want_uint_op(buf[0], ==, 0x81);
+    tt_want_uint_op(buf[1], ==, 0x01);
+
+    const uint8_t max[] = { 0xfe, 0xff, 0xff, 0xff, 0x0f };
+    tt_want_uint_op(pbio_set_varint_zigzag(buf, INT32_MAX), ==, 5);
+    tt_want_int_op(memcmp(buf, max, 5), ==, 0);
+
+    const uint8_t min[] = { 0xff, 0xff, 0xff, 0xff, 0x0f };
+    tt_want_uint_op(pbio_set_varint_zigzag(buf, INT32_MIN), ==, 5);
+    tt_want_int_op(memcmp(buf, min, 5), ==, 0);
+}
+
 struct testcase_t pbio_util_tests[] = {
     PBIO_TEST(test_uuid128_reverse_compare),
     PBIO_TEST(test_uuid128_reverse_copy),
     PBIO_TEST(test_oneshot),
+    PBIO_TEST(test_varint_zigzag),
     END_OF_TESTCASES
 };
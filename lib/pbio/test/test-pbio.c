@@ -91,16 +91,20 @@ struct testcase_setup_t pbio_test_setup = {
 };
 
 extern struct testcase_t pbdrv_bluetooth_btstack_tests[];
+extern struct testcase_t pbdrv_display_tests[];
 extern struct testcase_t pbdrv_pwm_tests[];
 extern struct testcase_t pbio_angle_tests[];
 extern struct testcase_t pbio_battery_tests[];
 extern struct testcase_t pbio_color_tests[];
+extern struct testcase_t pbio_differentiator_tests[];
 extern struct testcase_t pbio_drivebase_tests[];
 extern struct testcase_t pbio_image_tests[];
 extern struct testcase_t pbio_light_animation_tests[];
 extern struct testcase_t pbio_color_light_tests[];
 extern struct testcase_t pbio_light_matrix_tests[];
 extern struct testcase_t pbio_int_math_tests[];
+extern struct testcase_t pbio_logger_tests[];
+extern struct testcase_t pbio_os_tests[];
 extern struct testcase_t pbio_port_lump_tests[];
 extern struct testcase_t pbio_servo_tests[];
 extern struct testcase_t pbio_trajectory_tests[];
@@ -109,16 +113,20 @@ extern struct testcase_t pbdrv_bluetooth_tests[];
 extern struct testcase_t pbsys_status_tests[];
 static struct testgroup_t test_groups[] = {
     { "drv/bluetooth/", pbdrv_bluetooth_btstack_tests },
+    { "drv/display/", pbdrv_display_tests },
     { "drv/pwm/", pbdrv_pwm_tests },
     { "src/angle/", pbio_angle_tests },
     { "src/battery/", pbio_battery_tests },
     { "src/color/", pbio_color_tests },
+    { "src/differentiator/", pbio_differentiator_tests },
     { "src/drivebase/", pbio_drivebase_tests },
     { "src/image/", pbio_image_tests },
     { "src/light/", pbio_light_animation_tests },
     { "src/light/", pbio_color_light_tests },
     { "src/light/", pbio_light_matrix_tests },
+    { "src/logger/", pbio_logger_tests },
     { "src/math/", pbio_int_math_tests },
+    { "src/os/", pbio_os_tests },
     { "src/port_lump/", pbio_port_lump_tests },
     { "src/servo/", pbio_servo_tests },
     { "src/trajectory/", pbio_trajectory_tests },
@@ -98,7 +98,7 @@ mp_obj_t pb_type_MotorModel_obj_make_new(pbio_observer_t *observer);
 
 #if PYBRICKS_PY_COMMON_LOGGER
 // pybricks._common.Logger()
-mp_obj_t common_Logger_obj_make_new(pbio_log_t *log, uint8_t num_values);
+mp_obj_t common_Logger_obj_make_new(pbio_log_t *log, uint8_t num_values, const pbio_logger_column_t *columns);
 #endif
 
 // pybricks.common.DCMotor and pybricks.common.Motor
@@ -72,7 +72,7 @@ mp_obj_t pb_type_Control_obj_make_new(pbio_control_t *control) {
 
     #if PYBRICKS_PY_COMMON_LOGGER
     // Create an instance of the Logger class
-    self->logger = common_Logger_obj_make_new(&self->control->log, PBIO_CONTROL_LOGGER_NUM_COLS);
+    self->logger = common_Logger_obj_make_new(&self->control->log, PBIO_CONTROL_LOGGER_NUM_COLS, pbio_control_logger_columns);
     #endif
 
     self->scale = mp_obj_new_int(control->settings.ctl_steps_per_app_step);
@@ -87,14 +87,16 @@ static mp_obj_t pb_type_Control_limits(size_t n_args, const mp_obj_t *pos_args,
         pb_type_Control_obj_t, self,
         PB_ARG_DEFAULT_NONE(speed),
         PB_ARG_DEFAULT_NONE(acceleration),
-        PB_ARG_DEFAULT_NONE(torque));
+        PB_ARG_DEFAULT_NONE(torque),
+        PB_ARG_DEFAULT_NONE(smoothing));
 
     // Read current values.
     int32_t speed, acceleration, deceleration, torque;
     pbio_control_settings_get_trajectory_limits(&self->control->settings, &speed, &acceleration, &deceleration);
     torque = pbio_control_settings_get_actuation_limit(&self->control->settings);
 
-    // If all given values are none, return current values
+    // If all given values are none, return current values. Smoothing is not
+    // included, so existing programs that unpack three values keep working.
     if (PB_PARSE_ARGS_METHOD_ALL_NONE()) {
         mp_obj_t ret[] = {
             mp_obj_new_int(speed),
@@ -112,6 +114,9 @@ static mp_obj_t pb_type_Control_limits(size_t n_args, const mp_obj_t *pos_args,
     // Set new values.
     pb_assert(pbio_control_settings_set_trajectory_limits(&self->control->settings, speed, acceleration, deceleration));
     pb_assert(pbio_control_settings_set_actuation_limit(&self->control->settings, torque));
+    if (smoothing_in != mp_const_none) {
+        pb_assert(pbio_control_settings_set_trajectory_smoothing(&self->control->settings, pb_obj_get_int(smoothing_in)));
+    }
 
     return mp_const_none;
 }
@@ -72,6 +72,33 @@ static pbio_error_t pb_pup_device_iter_once(pbio_os_state_t *state, mp_obj_t sel
     return pbio_port_lump_is_ready(sensor->lump_dev);
 }
 
+/**
+ * Tests that a new data sample for the requested mode has been received since
+ * the sensor method was called. Unlike ::pb_pup_device_iter_once, this does
+ * not complete right away if the mode was already set, so that loops can run
+ * at the rate at which the sensor sends data.
+ *
+ * The state is the sample cursor, and the awaitable context is the mode.
+ */
+static pbio_error_t pb_pup_device_iter_new_sample(pbio_os_state_t *state, mp_obj_t self_in) {
+    pb_type_device_obj_base_t *sensor = MP_OBJ_TO_PTR(self_in);
+
+    pbio_error_t err = pbio_port_lump_is_ready(sensor->lump_dev);
+    if (err != PBIO_SUCCESS) {
+        return err;
+    }
+
+    // Skip samples for other modes, such as those received before the mode
+    // switch completed.
+    const pbio_port_lump_sample_t *sample;
+    while ((err = pbio_port_lump_get_sample(sensor->lump_dev, state, &sample)) == PBIO_SUCCESS) {
+        if (sample->mode == pb_type_async_get_context(state)) {
+            return PBIO_SUCCESS;
+        }
+    }
+    return err;
+}
+
 /**
  * Implements calling of async sensor methods. This is called when a (constant)
  * entry of pb_type_device_method type in a sensor class is called. It is
@@ -86,8 +113,23 @@ static pbio_error_t pb_pup_device_iter_once(pbio_os_state_t *state, mp_obj_t sel
 mp_obj_t pb_type_device_method_call(mp_obj_t self_in, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     assert(mp_obj_is_type(self_in, &pb_type_device_method));
     pb_type_device_method_obj_t *method = MP_OBJ_TO_PTR(self_in);
+
+    // The only keyword argument is fresh, which is keyword-only. Anything
+    // else is refused by the argument check below.
+    bool fresh = false;
+    if (n_kw == 1 && args[n_args] == MP_OBJ_NEW_QSTR(MP_QSTR_fresh)) {
+        fresh = mp_obj_is_true(args[n_args + 1]);
+        n_kw = 0;
+    }
     mp_arg_check_num(n_args, n_kw, 1, 1, false);
 
+    // Hubs without a sample history can't tell new samples from old ones.
+    #if !PBIO_CONFIG_PORT_LUMP_NUM_SAMPLES
+    if (fresh) {
+        pb_assert(PBIO_ERROR_NOT_SUPPORTED);
+    }
+    #endif
+
     mp_obj_t sensor_in = args[0];
     pb_type_device_obj_base_t *sensor = MP_OBJ_TO_PTR(sensor_in);
     pb_assert(pbio_port_lump_set_mode(sensor->lump_dev, method->mode));
@@ -97,6 +139,14 @@ mp_obj_t pb_type_device_method_call(mp_obj_t self_in, size_t n_args, size_t n_kw
         .parent_obj = sensor_in,
         .return_map = method->get_values,
     };
+
+    // Optionally wait for a sample that is newer than this call.
+    if (fresh) {
+        config.iter_once = pb_pup_device_iter_new_sample;
+        config.state = pbio_port_lump_get_sample_cursor(sensor->lump_dev);
+        config.context = method->mode;
+    }
+
     return pb_type_async_wait_or_await(&config, &sensor->last_awaitable, false);
 }
 
@@ -13,7 +13,11 @@
 #include <pbio/config.h>
 #include <pbio/logger.h>
 #include <pbio/int_math.h>
+#include <pbio/os.h>
+#include <pbio/protocol.h>
 #include <pbio/servo.h>
+#include <pbsys/host.h>
+#include <pbsys/status.h>
 
 #include "py/obj.h"
 #include "py/runtime.h"
@@ -44,6 +48,10 @@ typedef struct _tools_Logger_obj_t {
      * Buffer size. Used to free (renew) old data when resetting logger.
      */
     uint32_t last_size;
+    /**
+     * Names and scales of the logged values, used for binary exports.
+     */
+    const pbio_logger_column_t *columns;
 } tools_Logger_obj_t;
 
 static mp_obj_t tools_Logger_start(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
@@ -68,6 +76,220 @@ static mp_obj_t tools_Logger_start(size_t n_args, const mp_obj_t *pos_args, mp_m
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(tools_Logger_start_obj, 1, tools_Logger_start);
 
+/**
+ * State of the logger that is currently streaming. Only one logger can stream
+ * at a time.
+ */
+static struct {
+    /**
+     * Log being streamed, or NULL if there is none.
+     */
+    pbio_log_t *log;
+    #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+    /**
+     * File to which rows are written.
+     */
+    FILE *file;
+    #else
+    /**
+     * Remote file name that the IDE should open.
+     */
+    char path[64];
+    #endif // PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+    /**
+     * Formatted line that is being written. Fits any row logged by servos
+     * or controllers.
+     */
+    char line[256];
+    /**
+     * Size of the formatted line.
+     */
+    uint32_t line_size;
+    /**
+     * How much of the formatted line has been written.
+     */
+    uint32_t line_done;
+    #if !PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+    /**
+     * State of the event that is being sent.
+     */
+    pbio_os_state_t send_state;
+    /**
+     * Size of the event that is being sent, or 0 if there is none.
+     */
+    uint32_t send_size;
+    #endif
+} stream;
+
+static pbio_os_process_t stream_process;
+
+/**
+ * Prepares the stream to write a new line that is already in the buffer.
+ */
+static void tools_Logger_stream_begin_line(uint32_t size) {
+    stream.line_size = size;
+    stream.line_done = 0;
+    #if !PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+    stream.send_size = 0;
+    #endif
+}
+
+/**
+ * Formats one row of log data as a line of comma separated values.
+ */
+static void tools_Logger_stream_format_row(const int32_t *row_data, uint8_t num_cols) {
+    uint32_t size = 0;
+    for (uint32_t col = 0; col < num_cols && size < sizeof(stream.line); col++) {
+        const char *format = col + 1 < num_cols ? "%" PRId32 ", " : "%" PRId32 "\n";
+        size += snprintf(stream.line + size, sizeof(stream.line) - size, format, row_data[col]);
+    }
+    // If the row does not fit, it is cut off but still ends the line.
+    if (size >= sizeof(stream.line)) {
+        size = sizeof(stream.line);
+        stream.line[size - 1] = '\n';
+    }
+    tools_Logger_stream_begin_line(size);
+}
+
+/**
+ * Writes as much of the formatted line as possible without blocking.
+ *
+ * The data is sent as log events, so it does not get mixed up with stdout.
+ *
+ * @return  True if the whole line has been written.
+ */
+static bool tools_Logger_stream_write_line(void) {
+    #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+    fwrite(stream.line, 1, stream.line_size, stream.file);
+    #else
+    while (stream.line_done < stream.line_size) {
+        // Send as much as one event can carry on the current connection.
+        if (!stream.send_size) {
+            stream.send_size = pbio_int_math_min(stream.line_size - stream.line_done, pbsys_host_get_event_size_max());
+            stream.send_state = 0;
+            if (!stream.send_size) {
+                // Nobody is listening, so drop the data.
+                break;
+            }
+        }
+        pbio_error_t err = pbsys_host_send_event(&stream.send_state, PBIO_PYBRICKS_EVENT_WRITE_LOG,
+            (const uint8_t *)stream.line + stream.line_done, stream.send_size);
+        if (err == PBIO_ERROR_AGAIN) {
+            return false;
+        }
+        if (err == PBIO_ERROR_BUSY) {
+            // The previous event has not been sent yet, so try again later.
+            stream.send_state = 0;
+            return false;
+        }
+        if (err != PBIO_SUCCESS) {
+            // Nobody is listening, so drop the data.
+            break;
+        }
+        stream.line_done += stream.send_size;
+        stream.send_size = 0;
+    }
+    #endif // PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+    stream.line_done = stream.line_size;
+    return true;
+}
+
+/**
+ * Background process that drains a streaming log to the host or file.
+ */
+static pbio_error_t tools_Logger_stream_process_thread(pbio_os_state_t *state, void *context) {
+
+    static pbio_os_timer_t timer;
+
+    PBIO_OS_ASYNC_BEGIN(state);
+
+    #if !PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+    // Tell IDE to open remote file.
+    tools_Logger_stream_begin_line(snprintf(stream.line, sizeof(stream.line), "PB_OF:%s\n", stream.path));
+    PBIO_OS_AWAIT_UNTIL(state, tools_Logger_stream_write_line());
+    #endif
+
+    for (;;) {
+        // The buffer is on the MicroPython heap, which is gone when the
+        // program ends.
+        if (!pbsys_status_test(PBIO_PYBRICKS_STATUS_USER_PROGRAM_RUNNING)) {
+            break;
+        }
+
+        const int32_t *row_data = pbio_logger_stream_read_row(stream.log);
+        if (row_data) {
+            tools_Logger_stream_format_row(row_data, stream.log->num_cols);
+            PBIO_OS_AWAIT_UNTIL(state, tools_Logger_stream_write_line());
+            continue;
+        }
+
+        // Done when stopped and all rows have been written.
+        if (!pbio_logger_is_active(stream.log)) {
+            break;
+        }
+
+        // Control loops add rows every few milliseconds, so check for more
+        // data at a similar rate.
+        PBIO_OS_AWAIT_MS(state, &timer, PBIO_CONFIG_CONTROL_LOOP_TIME_MS * 2);
+    }
+
+    #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+    fclose(stream.file);
+    #else
+    tools_Logger_stream_begin_line(snprintf(stream.line, sizeof(stream.line), "PB_EOF\n"));
+    PBIO_OS_AWAIT_UNTIL(state, tools_Logger_stream_write_line() || !pbsys_status_test(PBIO_PYBRICKS_STATUS_USER_PROGRAM_RUNNING));
+    #endif
+    stream.log = NULL;
+
+    PBIO_OS_ASYNC_END(PBIO_SUCCESS);
+}
+
+static mp_obj_t tools_Logger_stream(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
+        tools_Logger_obj_t, self,
+        PB_ARG_DEFAULT_NONE(path),
+        PB_ARG_DEFAULT_INT(buffer, 1000),
+        PB_ARG_DEFAULT_INT(down_sample, 1));
+
+    // Only one log can be streamed at a time.
+    if (stream.log) {
+        pb_assert(PBIO_ERROR_BUSY);
+    }
+
+    // Get log file path.
+    const char *path = path_in == mp_const_none ? "log.txt" : mp_obj_str_get_str(path_in);
+
+    // Buffer holds rows for the given duration until they are sent.
+    mp_uint_t down_sample = pbio_int_math_max(pb_obj_get_int(down_sample_in), 1);
+    mp_uint_t num_rows = pbio_int_math_max(pb_obj_get_int(buffer_in) / PBIO_CONFIG_CONTROL_LOOP_TIME_MS / down_sample, 1);
+    mp_int_t size = num_rows * self->num_cols;
+    self->buf = m_renew(int32_t, self->buf, self->last_size, size);
+    self->last_size = size;
+
+    #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+    stream.file = fopen(path, "w");
+    if (stream.file == NULL) {
+        pb_assert(PBIO_ERROR_IO);
+    }
+    #else
+    snprintf(stream.path, sizeof(stream.path), "%s", path);
+    #endif // PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+
+    // Rows are sent in the background while the log is active.
+    pbio_logger_start_stream(self->log, self->buf, num_rows, self->num_cols, down_sample);
+    stream.log = self->log;
+    pbio_os_process_start(&stream_process, tools_Logger_stream_process_thread, NULL);
+
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(tools_Logger_stream_obj, 1, tools_Logger_stream);
+
+static mp_obj_t tools_Logger_overruns(mp_obj_t self_in) {
+    tools_Logger_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_int_from_uint(pbio_logger_stream_get_num_overruns(self->log));
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(tools_Logger_overruns_obj, tools_Logger_overruns);
+
 static mp_obj_t tools_Logger_stop(mp_obj_t self_in) {
     tools_Logger_obj_t *self = MP_OBJ_TO_PTR(self_in);
 
@@ -78,17 +300,120 @@ static mp_obj_t tools_Logger_stop(mp_obj_t self_in) {
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(tools_Logger_stop_obj, tools_Logger_stop);
 
+// Binary rows are encoded in blocks of this size. When sending to the host,
+// each block is split into the largest events that all hosts accept. These are
+// queued back to back, so Bluetooth can combine them into notifications as big
+// as the negotiated MTU allows.
+#define LOGGER_BINARY_CHUNK_SIZE (256)
+
+// Large enough for the header of any log made by servos or controllers.
+#define LOGGER_BINARY_HEADER_SIZE (512)
+
+/**
+ * Writes binary log data to the file or sends it to the host.
+ *
+ * This blocks until the data is queued for sending, but lets MicroPython
+ * handle pending events such as the stop button while waiting.
+ */
+static pbio_error_t tools_Logger_write_binary(FILE *log_file, const uint8_t *data, size_t size) {
+    #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+    return fwrite(data, 1, size, log_file) == size ? PBIO_SUCCESS : PBIO_ERROR_IO;
+    #else
+    while (size) {
+        // Send as much as one event can carry on the current connection.
+        size_t event_size = pbio_int_math_min(size, pbsys_host_get_event_size_max());
+        if (!event_size) {
+            return PBIO_ERROR_INVALID_OP;
+        }
+
+        // Also wait if another event of this type is still being sent.
+        pbio_os_state_t state = 0;
+        pbio_error_t err;
+        while ((err = pbsys_host_send_event(&state, PBIO_PYBRICKS_EVENT_WRITE_LOG, data, event_size)) == PBIO_ERROR_AGAIN || err == PBIO_ERROR_BUSY) {
+            if (err == PBIO_ERROR_BUSY) {
+                state = 0;
+            }
+            mp_event_wait_indefinite();
+        }
+        if (err != PBIO_SUCCESS) {
+            return err;
+        }
+        data += event_size;
+        size -= event_size;
+    }
+    return PBIO_SUCCESS;
+    #endif // PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+}
+
+/**
+ * Saves the log in the compact binary format, with a header that describes
+ * the columns followed by delta encoded rows.
+ */
+static void tools_Logger_save_binary(tools_Logger_obj_t *self, const char *path) {
+
+    #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+    FILE *log_file = fopen(path, "wb");
+    if (log_file == NULL) {
+        pb_assert(PBIO_ERROR_IO);
+    }
+    #else
+    FILE *log_file = NULL;
+    #endif // PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+
+    uint8_t *header = m_new(uint8_t, LOGGER_BINARY_HEADER_SIZE);
+    size_t header_size = pbio_logger_binary_encode_header(self->log, self->columns, path, header, LOGGER_BINARY_HEADER_SIZE);
+    pbio_error_t err = header_size ? PBIO_SUCCESS : PBIO_ERROR_INVALID_ARG;
+
+    if (err == PBIO_SUCCESS) {
+        err = tools_Logger_write_binary(log_file, header, header_size);
+    }
+    m_del(uint8_t, header, LOGGER_BINARY_HEADER_SIZE);
+
+    // Encode and send the rows one block at a time.
+    uint8_t chunk[LOGGER_BINARY_CHUNK_SIZE];
+    uint32_t cursor = 0;
+    size_t size;
+    while (err == PBIO_SUCCESS && (size = pbio_logger_binary_encode_rows(self->log, &cursor, chunk, sizeof(chunk)))) {
+        err = tools_Logger_write_binary(log_file, chunk, size);
+    }
+
+    #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+    if (fclose(log_file) != 0 && err == PBIO_SUCCESS) {
+        err = PBIO_ERROR_IO;
+    }
+    pb_assert(err);
+    #else
+    // Like text output, data is silently dropped if no host is listening.
+    if (err != PBIO_ERROR_INVALID_OP && err != PBIO_ERROR_NOT_SUPPORTED) {
+        pb_assert(err);
+    }
+    #endif // PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
+}
+
 static mp_obj_t tools_Logger_save(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
 
     PB_PARSE_ARGS_METHOD(n_args, pos_args, kw_args,
         tools_Logger_obj_t, self,
-        PB_ARG_DEFAULT_NONE(path));
+        PB_ARG_DEFAULT_NONE(path),
+        PB_ARG_DEFAULT_FALSE(binary));
 
     // Don't allow any more data to be added to logs.
     pbio_logger_stop(self->log);
 
+    // Streamed data has already been saved as it was logged.
+    if (pbio_logger_is_stream(self->log)) {
+        return mp_const_none;
+    }
+
+    bool binary = mp_obj_is_true(binary_in);
+
     // Get log file path.
-    const char *path = path_in == mp_const_none ? "log.txt" : mp_obj_str_get_str(path_in);
+    const char *path = path_in == mp_const_none ? (binary ? "log.bin" : "log.txt") : mp_obj_str_get_str(path_in);
+
+    if (binary) {
+        tools_Logger_save_binary(self, path);
+        return mp_const_none;
+    }
 
     #if PYBRICKS_PY_COMMON_LOGGER_REAL_FILE
     // Create an empty log file locally.
@@ -148,6 +473,8 @@ static const mp_rom_map_elem_t tools_Logger_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_start), MP_ROM_PTR(&tools_Logger_start_obj) },
     { MP_ROM_QSTR(MP_QSTR_stop), MP_ROM_PTR(&tools_Logger_stop_obj) },
     { MP_ROM_QSTR(MP_QSTR_save), MP_ROM_PTR(&tools_Logger_save_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stream), MP_ROM_PTR(&tools_Logger_stream_obj) },
+    { MP_ROM_QSTR(MP_QSTR_overruns), MP_ROM_PTR(&tools_Logger_overruns_obj) },
 };
 static MP_DEFINE_CONST_DICT(tools_Logger_locals_dict, tools_Logger_locals_dict_table);
 
@@ -157,9 +484,10 @@ static MP_DEFINE_CONST_OBJ_TYPE(tools_Logger_type,
     MP_TYPE_FLAG_NONE,
     locals_dict, &tools_Logger_locals_dict);
 
-mp_obj_t common_Logger_obj_make_new(pbio_log_t *log, uint8_t num_values) {
+mp_obj_t common_Logger_obj_make_new(pbio_log_t *log, uint8_t num_values, const pbio_logger_column_t *columns) {
     tools_Logger_obj_t *logger = mp_obj_malloc(tools_Logger_obj_t, &tools_Logger_type);
     logger->log = log;
+    logger->columns = columns;
     logger->num_cols = num_values + PBIO_LOGGER_NUM_DEFAULT_COLS;
     return MP_OBJ_FROM_PTR(logger);
 }
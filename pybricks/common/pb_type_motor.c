@@ -145,7 +145,7 @@ static mp_obj_t pb_type_Motor_make_new(const mp_obj_type_t *type, size_t n_args,
 
     #if PYBRICKS_PY_COMMON_LOGGER
     // Create an instance of the Logger class
-    self->logger = common_Logger_obj_make_new(&self->srv->log, PBIO_SERVO_LOGGER_NUM_COLS);
+    self->logger = common_Logger_obj_make_new(&self->srv->log, PBIO_SERVO_LOGGER_NUM_COLS, pbio_servo_logger_columns);
     #endif
 
     self->last_awaitable = NULL;
@@ -243,7 +243,7 @@ static mp_obj_t pb_type_Motor_reset_angle(size_t n_args, const mp_obj_t *pos_arg
 
     // Set the new angle
     pb_assert(pbio_servo_reset_angle(self->srv, reset_angle, reset_to_abs));
-    pb_type_async_schedule_stop_iteration(self->last_awaitable);
+    pb_type_async_schedule_stop_iteration(&self->last_awaitable);
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Motor_reset_angle_obj, 1, pb_type_Motor_reset_angle);
@@ -268,7 +268,7 @@ static mp_obj_t pb_type_Motor_run(size_t n_args, const mp_obj_t *pos_args, mp_ma
 
     mp_int_t speed = pb_obj_get_int(speed_in);
     pb_assert(pbio_servo_run_forever(self->srv, speed));
-    pb_type_async_schedule_stop_iteration(self->last_awaitable);
+    pb_type_async_schedule_stop_iteration(&self->last_awaitable);
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Motor_run_obj, 1, pb_type_Motor_run);
@@ -277,7 +277,7 @@ static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Motor_run_obj, 1, pb_type_Motor_run);
 static mp_obj_t pb_type_Motor_hold(mp_obj_t self_in) {
     pb_type_Motor_obj_t *self = MP_OBJ_TO_PTR(self_in);
     pb_assert(pbio_servo_stop(self->srv, PBIO_CONTROL_ON_COMPLETION_HOLD));
-    pb_type_async_schedule_stop_iteration(self->last_awaitable);
+    pb_type_async_schedule_stop_iteration(&self->last_awaitable);
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_1(pb_type_Motor_hold_obj, pb_type_Motor_hold);
@@ -377,14 +377,20 @@ static mp_obj_t pb_type_Motor_run_angle(size_t n_args, const mp_obj_t *pos_args,
         PB_ARG_REQUIRED(speed),
         PB_ARG_REQUIRED(rotation_angle),
         PB_ARG_DEFAULT_OBJ(then, pb_Stop_HOLD_obj),
-        PB_ARG_DEFAULT_TRUE(wait));
+        PB_ARG_DEFAULT_TRUE(wait),
+        PB_ARG_DEFAULT_FALSE(queue));
 
     mp_int_t speed = pb_obj_get_int(speed_in);
     mp_int_t angle = pb_obj_get_int(rotation_angle_in);
     pbio_control_on_completion_t then = pb_type_enum_get_value(then_in, &pb_enum_type_Stop);
 
     // Call pbio with parsed user/default arguments
-    pb_assert(pbio_servo_run_angle(self->srv, speed, angle, then));
+    if (mp_obj_is_true(queue_in)) {
+        // Start when the ongoing maneuver ends.
+        pb_assert(pbio_servo_queue_angle(self->srv, speed, angle, then));
+    } else {
+        pb_assert(pbio_servo_run_angle(self->srv, speed, angle, then));
+    }
 
     // Old way to do parallel movement is to start and not wait on anything.
     if (!mp_obj_is_true(wait_in)) {
@@ -428,7 +434,7 @@ static mp_obj_t pb_type_Motor_track_target(size_t n_args, const mp_obj_t *pos_ar
 
     mp_int_t target_angle = pb_obj_get_int(target_angle_in);
     pb_assert(pbio_servo_track_target(self->srv, target_angle));
-    pb_type_async_schedule_stop_iteration(self->last_awaitable);
+    pb_type_async_schedule_stop_iteration(&self->last_awaitable);
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_Motor_track_target_obj, 1, pb_type_Motor_track_target);
@@ -150,6 +150,32 @@ static mp_obj_t pb_type_System_storage(size_t n_args, const mp_obj_t *pos_args,
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_System_storage_obj, 0, pb_type_System_storage);
 
+#if PBDRV_CONFIG_BLUETOOTH
+
+static mp_obj_t pb_type_System_stdout_buffer(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_FUNCTION(n_args, pos_args, kw_args,
+        PB_ARG_DEFAULT_NONE(size));
+
+    // Optionally resize. This resets the high watermark.
+    if (size_in != mp_const_none) {
+        mp_int_t size = pb_obj_get_int(size_in);
+        if (size < 0) {
+            pb_assert(PBIO_ERROR_INVALID_ARG);
+        }
+        pb_assert(pbdrv_bluetooth_tx_set_buffer_size(size));
+        return mp_const_none;
+    }
+
+    mp_obj_t ret[] = {
+        mp_obj_new_int(pbdrv_bluetooth_tx_get_buffer_size()),
+        mp_obj_new_int(pbdrv_bluetooth_tx_get_high_watermark()),
+    };
+    return mp_obj_new_tuple(MP_ARRAY_SIZE(ret), ret);
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(pb_type_System_stdout_buffer_obj, 0, pb_type_System_stdout_buffer);
+
+#endif // PBDRV_CONFIG_BLUETOOTH
+
 static mp_obj_t pb_type_System_reset_storage(void) {
     pbsys_storage_reset_storage();
     return mp_const_none;
@@ -184,6 +210,9 @@ static const mp_rom_map_elem_t common_System_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_reset_storage), MP_ROM_PTR(&pb_type_System_reset_storage_obj) },
     { MP_ROM_QSTR(MP_QSTR_shutdown), MP_ROM_PTR(&pb_type_System_shutdown_obj) },
     { MP_ROM_QSTR(MP_QSTR_storage), MP_ROM_PTR(&pb_type_System_storage_obj) },
+    #if PBDRV_CONFIG_BLUETOOTH
+    { MP_ROM_QSTR(MP_QSTR_stdout_buffer), MP_ROM_PTR(&pb_type_System_stdout_buffer_obj) },
+    #endif
     #endif
     #if PYBRICKS_PY_COMMON_SYSTEM_UMM_INFO
     { MP_ROM_QSTR(MP_QSTR_umm_info), MP_ROM_PTR(&pb_type_System_umm_info_obj) },
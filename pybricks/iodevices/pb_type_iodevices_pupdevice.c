@@ -99,7 +99,7 @@ static mp_obj_t iodevices_PUPDevice_info(mp_obj_t self_in) {
     pb_assert(pbio_port_lump_assert_type_id(self->device_base.lump_dev, &type_id));
     pb_assert(pbio_port_lump_get_info(self->device_base.lump_dev, &num_modes, &current_mode, &mode_info));
 
-    mp_obj_t info_dict = mp_obj_new_dict(2);
+    mp_obj_t info_dict = mp_obj_new_dict(3);
 
     // Store device ID.
     mp_obj_dict_store(info_dict, MP_ROM_QSTR(MP_QSTR_id), MP_OBJ_NEW_SMALL_INT(type_id));
@@ -116,6 +116,16 @@ static mp_obj_t iodevices_PUPDevice_info(mp_obj_t self_in) {
     }
     mp_obj_dict_store(info_dict, MP_ROM_QSTR(MP_QSTR_modes), mp_obj_new_tuple(num_modes, modes));
 
+    // Store how often the data stream was corrupted, to diagnose bad cables.
+    uint32_t resync_count;
+    uint32_t dropped_bytes;
+    pbio_port_lump_get_rx_stats(self->device_base.lump_dev, &resync_count, &dropped_bytes);
+    mp_obj_t rx_errors[] = {
+        mp_obj_new_int_from_uint(resync_count),
+        mp_obj_new_int_from_uint(dropped_bytes),
+    };
+    mp_obj_dict_store(info_dict, MP_ROM_QSTR(MP_QSTR_rx_errors), mp_obj_new_tuple(MP_ARRAY_SIZE(rx_errors), rx_errors));
+
     return info_dict;
 }
 MP_DEFINE_CONST_FUN_OBJ_1(iodevices_PUPDevice_info_obj, iodevices_PUPDevice_info);
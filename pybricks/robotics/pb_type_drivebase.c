@@ -100,7 +100,7 @@ static mp_obj_t pb_type_DriveBase_stop(mp_obj_t self_in) {
 
     // Cancel awaitables.
     pb_type_DriveBase_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    pb_type_async_schedule_stop_iteration(self->last_awaitable);
+    pb_type_async_schedule_stop_iteration(&self->last_awaitable);
 
     // Stop hardware.
     pb_assert(pbio_drivebase_stop(self->db, PBIO_CONTROL_ON_COMPLETION_COAST));
@@ -128,12 +128,18 @@ static mp_obj_t pb_type_DriveBase_straight(size_t n_args, const mp_obj_t *pos_ar
         pb_type_DriveBase_obj_t, self,
         PB_ARG_REQUIRED(distance),
         PB_ARG_DEFAULT_OBJ(then, pb_Stop_HOLD_obj),
-        PB_ARG_DEFAULT_TRUE(wait));
+        PB_ARG_DEFAULT_TRUE(wait),
+        PB_ARG_DEFAULT_FALSE(queue));
 
     mp_int_t distance = pb_obj_get_int(distance_in);
     pbio_control_on_completion_t then = pb_type_enum_get_value(then_in, &pb_enum_type_Stop);
 
-    pb_assert(pbio_drivebase_drive_straight(self->db, distance, then));
+    if (mp_obj_is_true(queue_in)) {
+        // Start when the ongoing maneuver ends.
+        pb_assert(pbio_drivebase_queue_straight(self->db, distance, then));
+    } else {
+        pb_assert(pbio_drivebase_drive_straight(self->db, distance, then));
+    }
 
     // Old way to do parallel movement is to start and not wait on anything.
     if (!mp_obj_is_true(wait_in)) {
@@ -150,13 +156,19 @@ static mp_obj_t pb_type_DriveBase_turn(size_t n_args, const mp_obj_t *pos_args,
         pb_type_DriveBase_obj_t, self,
         PB_ARG_REQUIRED(angle),
         PB_ARG_DEFAULT_OBJ(then, pb_Stop_HOLD_obj),
-        PB_ARG_DEFAULT_TRUE(wait));
+        PB_ARG_DEFAULT_TRUE(wait),
+        PB_ARG_DEFAULT_FALSE(queue));
 
     mp_int_t angle = pb_obj_get_int(angle_in);
     pbio_control_on_completion_t then = pb_type_enum_get_value(then_in, &pb_enum_type_Stop);
 
     // Turning in place is done as a curve with zero radius and a given angle.
-    pb_assert(pbio_drivebase_drive_curve(self->db, 0, angle, then));
+    if (mp_obj_is_true(queue_in)) {
+        // Start when the ongoing maneuver ends.
+        pb_assert(pbio_drivebase_queue_curve(self->db, 0, angle, then));
+    } else {
+        pb_assert(pbio_drivebase_drive_curve(self->db, 0, angle, then));
+    }
 
     // Old way to do parallel movement is to start and not wait on anything.
     if (!mp_obj_is_true(wait_in)) {
@@ -174,13 +186,19 @@ static mp_obj_t pb_type_DriveBase_curve(size_t n_args, const mp_obj_t *pos_args,
         PB_ARG_REQUIRED(radius),
         PB_ARG_REQUIRED(angle),
         PB_ARG_DEFAULT_OBJ(then, pb_Stop_HOLD_obj),
-        PB_ARG_DEFAULT_TRUE(wait));
+        PB_ARG_DEFAULT_TRUE(wait),
+        PB_ARG_DEFAULT_FALSE(queue));
 
     mp_int_t radius = pb_obj_get_int(radius_in);
     mp_int_t angle = pb_obj_get_int(angle_in);
     pbio_control_on_completion_t then = pb_type_enum_get_value(then_in, &pb_enum_type_Stop);
 
-    pb_assert(pbio_drivebase_drive_curve(self->db, radius, angle, then));
+    if (mp_obj_is_true(queue_in)) {
+        // Start when the ongoing maneuver ends.
+        pb_assert(pbio_drivebase_queue_curve(self->db, radius, angle, then));
+    } else {
+        pb_assert(pbio_drivebase_drive_curve(self->db, radius, angle, then));
+    }
 
     // Old way to do parallel movement is to start and not wait on anything.
     if (!mp_obj_is_true(wait_in)) {
@@ -199,7 +217,8 @@ static mp_obj_t pb_type_DriveBase_arc(size_t n_args, const mp_obj_t *pos_args, m
         PB_ARG_DEFAULT_NONE(angle),
         PB_ARG_DEFAULT_NONE(distance),
         PB_ARG_DEFAULT_OBJ(then, pb_Stop_HOLD_obj),
-        PB_ARG_DEFAULT_TRUE(wait));
+        PB_ARG_DEFAULT_TRUE(wait),
+        PB_ARG_DEFAULT_FALSE(queue));
 
     // Parse user arguments.
     mp_int_t radius = pb_obj_get_int(radius_in);
@@ -209,10 +228,18 @@ static mp_obj_t pb_type_DriveBase_arc(size_t n_args, const mp_obj_t *pos_args, m
 
     pbio_control_on_completion_t then = pb_type_enum_get_value(then_in, &pb_enum_type_Stop);
 
+    bool queue = mp_obj_is_true(queue_in);
+
     if (distance_in != mp_const_none) {
-        pb_assert(pbio_drivebase_drive_arc_distance(self->db, radius, pb_obj_get_int(distance_in), then));
+        mp_int_t distance = pb_obj_get_int(distance_in);
+        pb_assert(queue ?
+            pbio_drivebase_queue_arc_distance(self->db, radius, distance, then) :
+            pbio_drivebase_drive_arc_distance(self->db, radius, distance, then));
     } else {
-        pb_assert(pbio_drivebase_drive_arc_angle(self->db, radius, pb_obj_get_int(angle_in), then));
+        mp_int_t angle = pb_obj_get_int(angle_in);
+        pb_assert(queue ?
+            pbio_drivebase_queue_arc_angle(self->db, radius, angle, then) :
+            pbio_drivebase_drive_arc_angle(self->db, radius, angle, then));
     }
 
     // Old way to do parallel movement is to start and not wait on anything.
@@ -236,7 +263,7 @@ static mp_obj_t pb_type_DriveBase_drive(size_t n_args, const mp_obj_t *pos_args,
     mp_int_t turn_rate = pb_obj_get_int(turn_rate_in);
 
     // Cancel awaitables but not hardware. Drive forever will handle this.
-    pb_type_async_schedule_stop_iteration(self->last_awaitable);
+    pb_type_async_schedule_stop_iteration(&self->last_awaitable);
 
     pb_assert(pbio_drivebase_drive_forever(self->db, speed, turn_rate));
     return mp_const_none;
@@ -248,7 +275,7 @@ static mp_obj_t pb_type_DriveBase_brake(mp_obj_t self_in) {
 
     // Cancel awaitables.
     pb_type_DriveBase_obj_t *self = MP_OBJ_TO_PTR(self_in);
-    pb_type_async_schedule_stop_iteration(self->last_awaitable);
+    pb_type_async_schedule_stop_iteration(&self->last_awaitable);
 
     // Stop hardware.
     pb_assert(pbio_drivebase_stop(self->db, PBIO_CONTROL_ON_COMPLETION_BRAKE));
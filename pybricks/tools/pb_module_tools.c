@@ -17,6 +17,8 @@
 #include <pbdrv/clock.h>
 
 #include <pbio/int_math.h>
+#include <pbio/motor_process.h>
+#include <pbio/os.h>
 #include <pbio/util.h>
 #include <pbsys/light.h>
 #include <pbsys/program_stop.h>
@@ -47,20 +49,14 @@ void pb_module_tools_assert_blocking(void) {
     }
 }
 
-/**
- * Statically allocated wait objects that can be re-used without allocation
- * once exhausted. Should be sufficient for trivial applications.
- *
- * More are allocated as needed. If a user has more than this many parallel
- * waits, the user can probably afford to allocate anyway.
- *
- * This is set to zero each time MicroPython starts.
- */
-static pb_type_async_t waits[6];
-
 static pbio_error_t pb_module_tools_wait_iter_once(pbio_os_state_t *state, mp_obj_t parent_obj) {
     // Not a protothread, but using the state variable to store final time.
-    return pbio_util_time_has_passed(pbdrv_clock_get_ms(), (uint32_t)*state) ? PBIO_SUCCESS: PBIO_ERROR_AGAIN;
+    if (pbio_util_time_has_passed(pbdrv_clock_get_ms(), (uint32_t)*state)) {
+        return PBIO_SUCCESS;
+    }
+    // Don't let the system sleep past the end of the wait.
+    pbio_os_request_wakeup((uint32_t)*state);
+    return PBIO_ERROR_AGAIN;
 }
 
 static mp_obj_t pb_module_tools_wait(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
@@ -77,17 +73,6 @@ static mp_obj_t pb_module_tools_wait(size_t n_args, const mp_obj_t *pos_args, mp
         return mp_const_none;
     }
 
-    // Find statically allocated candidate that can be re-used again because
-    // it was never used or used and exhausted. If it stays at NULL then a new
-    // awaitable is allocated.
-    pb_type_async_t *reuse = NULL;
-    for (uint32_t i = 0; i < MP_ARRAY_SIZE(waits); i++) {
-        if (waits[i].parent_obj == MP_OBJ_NULL) {
-            reuse = &waits[i];
-            break;
-        }
-    }
-
     pb_type_async_t config = {
         // Not associated with any parent object.
         .parent_obj = mp_const_none,
@@ -95,9 +80,11 @@ static mp_obj_t pb_module_tools_wait(size_t n_args, const mp_obj_t *pos_args, mp
         .iter_once = time == 0 ? NULL : pb_module_tools_wait_iter_once,
         // No protothread here; use it to encode end time.
         .state = pbdrv_clock_get_ms() + (uint32_t)time,
+        .state_is_end_time = true,
     };
 
-    return pb_type_async_wait_or_await(&config, &reuse, false);
+    // Not associated with a parent, so any free awaitable can be used.
+    return pb_type_async_wait_or_await(&config, NULL, false);
 }
 static MP_DEFINE_CONST_FUN_OBJ_KW(pb_module_tools_wait_obj, 0, pb_module_tools_wait);
 
@@ -175,7 +162,15 @@ static mp_obj_t pb_module_tools_run_task(size_t n_args, const mp_obj_t *pos_args
     if (nlr_push(&nlr) == 0) {
         run_loop_is_active = true;
         mp_obj_t iterable = mp_getiter(task_in, &iter_buf);
-        while (mp_iternext(iterable) != MP_OBJ_STOP_ITERATION) {
+        mp_obj_t yielded;
+        while ((yielded = mp_iternext(iterable)) != MP_OBJ_STOP_ITERATION) {
+            // If all tasks are waiting, sleep until the first one is done.
+            // This keeps running system processes and stops on exception.
+            mp_int_t skip_time = pb_type_async_get_skip_time(yielded);
+            if (skip_time) {
+                mp_hal_delay_ms(skip_time);
+                continue;
+            }
             // Keep running system processes.
             MICROPY_VM_HOOK_LOOP
             // Stop on exception such as SystemExit.
@@ -193,7 +188,7 @@ static MP_DEFINE_CONST_FUN_OBJ_KW(pb_module_tools_run_task_obj, 0, pb_module_too
 
 // Reset global awaitable state when user program starts.
 void pb_module_tools_init(void) {
-    memset(waits, 0, sizeof(waits));
+    pb_type_async_init();
     run_loop_is_active = false;
 }
 
@@ -295,6 +290,74 @@ static MP_DEFINE_CONST_FUN_OBJ_VAR(pb_module_tools_hub_menu_obj, 2, pb_module_to
 
 #endif // PYBRICKS_PY_TOOLS_HUB_MENU
 
+#if PBIO_CONFIG_MOTOR_PROCESS_STATS
+
+static mp_obj_t pb_module_tools_motor_loop_stats(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_FUNCTION(n_args, pos_args, kw_args,
+        PB_ARG_DEFAULT_FALSE(reset));
+
+    const pbio_motor_process_stats_t *stats = pbio_motor_process_get_stats();
+
+    mp_obj_t histogram[PBIO_MOTOR_PROCESS_HISTOGRAM_SIZE];
+    for (size_t i = 0; i < MP_ARRAY_SIZE(histogram); i++) {
+        histogram[i] = mp_obj_new_int_from_uint(stats->latency_histogram[i]);
+    }
+
+    mp_map_elem_t info[] = {
+        {MP_OBJ_NEW_QSTR(MP_QSTR_ticks), mp_obj_new_int_from_uint(stats->num_ticks)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_missed), mp_obj_new_int_from_uint(stats->num_missed)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_exec_time), mp_obj_new_int_from_uint(stats->exec_time_last)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_exec_time_max), mp_obj_new_int_from_uint(stats->exec_time_max)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_latency_max), mp_obj_new_int_from_uint(stats->latency_max)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_latency_histogram), mp_obj_new_tuple(MP_ARRAY_SIZE(histogram), histogram)},
+    };
+    mp_obj_t info_dict = mp_obj_new_dict(MP_ARRAY_SIZE(info));
+
+    for (size_t i = 0; i < MP_ARRAY_SIZE(info); i++) {
+        mp_map_elem_t *elem = &info[i];
+        mp_obj_dict_store(info_dict, elem->key, elem->value);
+    }
+
+    if (mp_obj_is_true(reset_in)) {
+        pbio_motor_process_reset_stats();
+    }
+
+    return info_dict;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(pb_module_tools_motor_loop_stats_obj, 0, pb_module_tools_motor_loop_stats);
+
+#endif // PBIO_CONFIG_MOTOR_PROCESS_STATS
+
+#if PYBRICKS_OPT_EXTRA_LEVEL1
+
+static mp_obj_t pb_module_tools_async_pool_stats(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    PB_PARSE_ARGS_FUNCTION(n_args, pos_args, kw_args,
+        PB_ARG_DEFAULT_FALSE(reset));
+
+    const pb_type_async_pool_stats_t *stats = pb_type_async_get_pool_stats();
+
+    mp_map_elem_t info[] = {
+        {MP_OBJ_NEW_QSTR(MP_QSTR_size), mp_obj_new_int_from_uint(stats->size)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_used_max), mp_obj_new_int_from_uint(stats->used_max)},
+        {MP_OBJ_NEW_QSTR(MP_QSTR_exhausted), mp_obj_new_int_from_uint(stats->num_exhausted)},
+    };
+    mp_obj_t info_dict = mp_obj_new_dict(MP_ARRAY_SIZE(info));
+
+    for (size_t i = 0; i < MP_ARRAY_SIZE(info); i++) {
+        mp_map_elem_t *elem = &info[i];
+        mp_obj_dict_store(info_dict, elem->key, elem->value);
+    }
+
+    if (mp_obj_is_true(reset_in)) {
+        pb_type_async_reset_pool_stats();
+    }
+
+    return info_dict;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(pb_module_tools_async_pool_stats_obj, 0, pb_module_tools_async_pool_stats);
+
+#endif // PYBRICKS_OPT_EXTRA_LEVEL1
+
 static const mp_rom_map_elem_t tools_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__),    MP_ROM_QSTR(MP_QSTR_tools)                    },
     { MP_ROM_QSTR(MP_QSTR_wait),        MP_ROM_PTR(&pb_module_tools_wait_obj)         },
@@ -306,6 +369,12 @@ static const mp_rom_map_elem_t tools_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_hub_menu),    MP_ROM_PTR(&pb_module_tools_hub_menu_obj)     },
     #endif // PYBRICKS_PY_TOOLS_HUB_MENU
     { MP_ROM_QSTR(MP_QSTR_run_task),    MP_ROM_PTR(&pb_module_tools_run_task_obj)     },
+    #if PYBRICKS_OPT_EXTRA_LEVEL1
+    { MP_ROM_QSTR(MP_QSTR_async_pool_stats), MP_ROM_PTR(&pb_module_tools_async_pool_stats_obj) },
+    #endif // PYBRICKS_OPT_EXTRA_LEVEL1
+    #if PBIO_CONFIG_MOTOR_PROCESS_STATS
+    { MP_ROM_QSTR(MP_QSTR_motor_loop_stats), MP_ROM_PTR(&pb_module_tools_motor_loop_stats_obj) },
+    #endif // PBIO_CONFIG_MOTOR_PROCESS_STATS
     { MP_ROM_QSTR(MP_QSTR_StopWatch),   MP_ROM_PTR(&pb_type_StopWatch)                },
     { MP_ROM_QSTR(MP_QSTR_multitask),   MP_ROM_PTR(&pb_type_Task)                     },
     #if MICROPY_PY_BUILTINS_FLOAT
@@ -8,30 +8,114 @@
 
 #include "pb_type_async.h"
 
+#include <pbdrv/clock.h>
+
 #include <pybricks/tools.h>
 #include <pybricks/util_pb/pb_error.h>
 
+// Awaitables shared by all operations, so that async programs don't have
+// to allocate a new one for each operation. Free awaitables have parent_obj
+// set to MP_OBJ_NULL. The pool is allocated once when the program starts.
+MP_REGISTER_ROOT_POINTER(struct _pb_type_async_t *pb_type_async_pool);
+
+static pb_type_async_pool_stats_t pool_stats;
+
+/**
+ * Allocates the pool of awaitables. Must be called on each program start.
+ */
+void pb_type_async_init(void) {
+    MP_STATE_VM(pb_type_async_pool) = m_new0(pb_type_async_t, PYBRICKS_OPT_ASYNC_POOL_SIZE);
+    pb_type_async_reset_pool_stats();
+}
+
+/**
+ * Gets usage statistics of the pool of awaitables.
+ *
+ * @return  The statistics.
+ */
+const pb_type_async_pool_stats_t *pb_type_async_get_pool_stats(void) {
+    return &pool_stats;
+}
+
+/**
+ * Resets usage statistics of the pool of awaitables.
+ */
+void pb_type_async_reset_pool_stats(void) {
+    pool_stats = (pb_type_async_pool_stats_t) {
+        .size = PYBRICKS_OPT_ASYNC_POOL_SIZE,
+    };
+}
+
+/**
+ * Gets the first free awaitable from the pool. If they are all in use, a new
+ * one is allocated on the heap.
+ *
+ * @return  The awaitable.
+ */
+static pb_type_async_t *pb_type_async_pool_take(void) {
+    pb_type_async_t *pool = MP_STATE_VM(pb_type_async_pool);
+    pb_type_async_t *iter = NULL;
+    uint32_t used = 1;
+    for (size_t i = 0; i < PYBRICKS_OPT_ASYNC_POOL_SIZE; i++) {
+        if (pool[i].parent_obj != MP_OBJ_NULL) {
+            used++;
+        } else if (!iter) {
+            iter = &pool[i];
+        }
+    }
+
+    if (!iter) {
+        pool_stats.num_exhausted++;
+        return m_new_obj(pb_type_async_t);
+    }
+
+    if (used > pool_stats.used_max) {
+        pool_stats.used_max = used;
+    }
+    return iter;
+}
+
+/**
+ * Tests whether an awaitable reference still refers to the awaitable that
+ * was made for it, so that it wasn't freed and taken by another operation.
+ *
+ * @param [in] prev Reference to the awaitable.
+ * @return          Whether it is valid.
+ */
+static bool pb_type_async_is_owned_by(pb_type_async_t **prev) {
+    return prev && *prev && (*prev)->owner == prev;
+}
+
 /**
  * Makes the iterable exhaust the next time it is iterated.
  *
- * This will not call close(). Safe to call even if iter is NULL or if it is
- * already complete.
+ * This will not call close(). Safe to call even if there is no iterable or if
+ * it is already complete.
  *
  * This is useful when all we need is for the ongoing awaitable to stop, with
  * the newly created iterable taking care of the hardware. For example, if the
  * new operation takes over the speaker, the old one only has to stop iterating,
  * not stop the speaker as it would do with close().
  *
- * @param [in] iter The awaitable object.
+ * If the awaitable was never iterated, it is freed right away. Otherwise it
+ * would keep its place in the pool and its parent alive if it is never
+ * awaited, for example when a motor command is followed by another without
+ * awaiting the first.
+ *
+ * @param [in] prev Reference to the awaitable object.
  */
-void pb_type_async_schedule_stop_iteration(pb_type_async_t *iter) {
-    if (!iter || iter->parent_obj == MP_OBJ_NULL) {
-        // Don't schedule if already complete.
+void pb_type_async_schedule_stop_iteration(pb_type_async_t **prev) {
+    if (!pb_type_async_is_owned_by(prev) || (*prev)->parent_obj == MP_OBJ_NULL) {
+        // Don't schedule if already complete or taken by another operation.
+        return;
+    }
+    if (!(*prev)->started) {
+        (*prev)->parent_obj = MP_OBJ_NULL;
         return;
     }
     // Don't set it to MP_OBJ_NULL right away, or the calling code wouldn't
     // know it was exhausted, and it would await on the renewed operation.
-    iter->parent_obj = MP_OBJ_SENTINEL;
+    (*prev)->parent_obj = MP_OBJ_SENTINEL;
 }
 
 mp_obj_t pb_type_async_close(mp_obj_t iter_in) {
@@ -60,18 +144,23 @@ static mp_obj_t pb_type_async_iternext(mp_obj_t iter_in) {
         iter->parent_obj = MP_OBJ_NULL;
         return MP_OBJ_STOP_ITERATION;
     }
+    iter->started = true;
 
     // Special case without iterator means yield exactly once and then complete.
     if (!iter->iter_once) {
-        pb_type_async_schedule_stop_iteration(iter);
+        iter->parent_obj = MP_OBJ_SENTINEL;
         return mp_const_none;
     }
 
     // Run one iteration of the protothread.
     pbio_error_t err = iter->iter_once(&iter->state, iter->parent_obj);
 
-    // Yielded, keep going.
+    // Yielded, keep going. Let the scheduler know if we can be skipped for a
+    // while, so that it doesn't have to keep polling us.
     if (err == PBIO_ERROR_AGAIN) {
+        if (iter->state_is_end_time) {
+            return pb_type_async_new_skip_time((int32_t)(iter->state - pbdrv_clock_get_ms()));
+        }
         return mp_const_none;
     }
 
@@ -116,22 +205,23 @@ mp_obj_t pb_type_async_wait_or_await(pb_type_async_t *config, pb_type_async_t **
     if (pb_module_tools_run_loop_is_active()) {
 
         // Optionally schedule ongoing awaitable to stop (next time) if busy.
-        if (prev && stop_prev) {
-            pb_type_async_schedule_stop_iteration(*prev);
+        if (stop_prev) {
+            pb_type_async_schedule_stop_iteration(prev);
         }
 
-        // Re-use existing awaitable if exists and is free, otherwise allocate
-        // another one. This allows many resources with one concurrent physical
-        // operation like a motor to operate without re-allocation.
-        pb_type_async_t *iter = (prev && *prev && (*prev)->parent_obj == MP_OBJ_NULL) ?
-            *prev : (pb_type_async_t *)m_malloc(sizeof(pb_type_async_t));
+        // Re-use existing awaitable if exists and is free, otherwise take
+        // one from the pool. This allows resources with one concurrent
+        // physical operation like a motor to keep using the same one.
+        pb_type_async_t *iter = (pb_type_async_is_owned_by(prev) && (*prev)->parent_obj == MP_OBJ_NULL) ?
+            *prev : pb_type_async_pool_take();
 
-        // Copy the confuration to the object on heap so it lives on.
+        // Copy the confuration to the pool object so it lives on.
         *iter = *config;
+        iter->owner = prev;
 
         // Attaches newly defined awaitable (or no-op if reused) to the parent
         // object. The object that was here before is detached, so we no longer
-        // prevent it from being garbage collected.
+        // prevent it from being garbage collected if it was on the heap.
         if (prev) {
             *prev = iter;
         }
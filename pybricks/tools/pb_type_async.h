@@ -7,8 +7,13 @@
 #include "py/mpconfig.h"
 
 #include "py/obj.h"
+#include "py/smallint.h"
+
+#include <stdbool.h>
+#include <stdint.h>
 
 #include <pbio/os.h>
+#include <pbio/util.h>
 
 /**
  * Called on cancel/close. Used to stop hardware operation in unhandled
@@ -41,7 +46,7 @@ typedef mp_obj_t (*pb_type_async_return_map_t)(mp_obj_t parent_obj);
 typedef pbio_error_t (*pb_type_async_iterate_once_t)(pbio_os_state_t *state, mp_obj_t parent_obj);
 
 /** Object representing the iterable that is returned by an awaitable operation. */
-typedef struct {
+typedef struct _pb_type_async_t {
     mp_obj_base_t base;
     /**
      * The object instance whose method made us. Usually a class instance whose
@@ -71,10 +76,96 @@ typedef struct {
      * State of the protothread used by the iterable.
      */
     pbio_os_state_t state;
+    /**
+     * Whether the state is not a protothread state but the clock time in
+     * milliseconds at which the operation completes. If so, the iterable
+     * yields the time remaining until then, so that schedulers can skip it
+     * until it is done.
+     */
+    bool state_is_end_time;
+    /**
+     * Whether this iterable has been iterated at least once. If not, nothing
+     * is awaiting it, so it can be freed right away when it is stopped.
+     */
+    bool started;
+    /**
+     * Extra value for iterate functions that need more than the state, such
+     * as the sensor mode to wait for. Use ::pb_type_async_get_context to get
+     * it from within the iterate function.
+     */
+    uint8_t context;
+    /**
+     * The reference to this iterable kept by the object that made it, if any.
+     * Iterables are shared, so this is used to check that the reference is
+     * still valid. It is only compared, never dereferenced, since the object
+     * may no longer exist.
+     */
+    struct _pb_type_async_t **owner;
 } pb_type_async_t;
 
+/** Usage statistics of the pool of awaitables shared by all operations. */
+typedef struct {
+    /** Number of awaitables in the pool. */
+    uint32_t size;
+    /** Highest number of awaitables in use at once. */
+    uint32_t used_max;
+    /** Number of awaitables allocated on the heap because the pool was full. */
+    uint32_t num_exhausted;
+} pb_type_async_pool_stats_t;
+
+/**
+ * Makes the value to yield if an awaitable can't make progress for a while.
+ *
+ * @param [in]  remaining   Time in milliseconds until it can make progress.
+ * @return                  Value to yield.
+ */
+static inline mp_obj_t pb_type_async_new_skip_time(int32_t remaining) {
+    if (remaining <= 0) {
+        return MP_OBJ_NEW_SMALL_INT(0);
+    }
+    return MP_OBJ_NEW_SMALL_INT(remaining < MP_SMALL_INT_MAX ? remaining : MP_SMALL_INT_MAX);
+}
+
+/**
+ * Gets how long a task can be skipped, given the value it yielded.
+ *
+ * Awaitables that can't make progress for a while yield the number of
+ * milliseconds until they can. Anything else, usually None, means that the
+ * task should run again on the next pass.
+ *
+ * User generators that yield a non-negative int are treated the same way, so
+ * ``yield 100`` in a task skips it for 100 ms, as ``await wait(100)`` would.
+ *
+ * @param [in]  yielded     The value yielded by the task.
+ * @return                  Time to skip the task in milliseconds, or 0 if it
+ *                          should not be skipped.
+ */
+static inline mp_int_t pb_type_async_get_skip_time(mp_obj_t yielded) {
+    if (!mp_obj_is_small_int(yielded) || MP_OBJ_SMALL_INT_VALUE(yielded) < 0) {
+        return 0;
+    }
+    return MP_OBJ_SMALL_INT_VALUE(yielded);
+}
+
+/**
+ * Gets the extra value of the iterable, given the state that was passed to
+ * its iterate function.
+ *
+ * @param [in]  state       The state passed to the iterate function.
+ * @return                  The value of ::pb_type_async_t.context.
+ */
+static inline uint8_t pb_type_async_get_context(pbio_os_state_t *state) {
+    return PBIO_CONTAINER_OF(state, pb_type_async_t, state)->context;
+}
+
+void pb_type_async_init(void);
+
+const pb_type_async_pool_stats_t *pb_type_async_get_pool_stats(void);
+
+void pb_type_async_reset_pool_stats(void);
+
 mp_obj_t pb_type_async_wait_or_await(pb_type_async_t *config, pb_type_async_t **prev, bool stop_prev);
 
-void pb_type_async_schedule_stop_iteration(pb_type_async_t *iter);
+void pb_type_async_schedule_stop_iteration(pb_type_async_t **prev);
 
 #endif // PYBRICKS_INCLUDED_ASYNC_H
@@ -9,9 +9,14 @@
 #include "py/objmodule.h"
 #include "py/runtime.h"
 
+#include <pbdrv/clock.h>
+
+#include <pbio/util.h>
+
 #include <pybricks/parameters.h>
 #include <pybricks/common.h>
 #include <pybricks/tools.h>
+#include <pybricks/tools/pb_type_async.h>
 
 #include <pybricks/util_mp/pb_kwarg_helper.h>
 #include <pybricks/util_mp/pb_obj_helper.h>
@@ -25,6 +30,14 @@ typedef struct {
     mp_obj_iter_buf_t iter_buf;
     mp_obj_t iterable;
     bool done;
+    /**
+     * Whether the task is waiting until ::wake_time, so it can be skipped.
+     */
+    bool sleeping;
+    /**
+     * Clock time in milliseconds at which a sleeping task runs again.
+     */
+    uint32_t wake_time;
 } pb_type_Task_progress_t;
 
 typedef struct {
@@ -74,6 +87,12 @@ static mp_obj_t pb_type_Task_iternext(mp_obj_t self_in) {
 
         size_t done_total = 0;
 
+        // Whether all unfinished tasks are sleeping, and the earliest time
+        // at which one of them wakes up.
+        bool all_sleeping = true;
+        uint32_t now = pbdrv_clock_get_ms();
+        uint32_t wake_time = now + INT32_MAX;
+
         for (size_t i = 0; i < self->num_tasks; i++) {
 
             pb_type_Task_progress_t *task = &self->tasks[i];
@@ -84,36 +103,60 @@ static mp_obj_t pb_type_Task_iternext(mp_obj_t self_in) {
                 continue;
             }
 
+            // This task is waiting and would not make progress, skip.
+            if (task->sleeping && !pbio_util_time_has_passed(now, task->wake_time)) {
+                if (pbio_util_time_has_passed(wake_time, task->wake_time)) {
+                    wake_time = task->wake_time;
+                }
+                continue;
+            }
+            task->sleeping = false;
+
             // Do one task iteration.
             mp_obj_t result = mp_iternext(task->iterable);
 
+            // Not done yet, but may be skipped for a while.
+            mp_int_t skip_time = pb_type_async_get_skip_time(result);
+            if (skip_time) {
+                task->sleeping = true;
+                task->wake_time = now + skip_time;
+                if (pbio_util_time_has_passed(wake_time, task->wake_time)) {
+                    wake_time = task->wake_time;
+                }
+                continue;
+            }
+
             // Not done yet, try next time.
-            if (result == mp_const_none) {
+            if (result != MP_OBJ_STOP_ITERATION) {
+                all_sleeping = false;
                 continue;
             }
 
             // Task is done, save return value.
-            if (result == MP_OBJ_STOP_ITERATION) {
-                if (MP_STATE_THREAD(stop_iteration_arg) != MP_OBJ_NULL) {
-                    task->return_val = MP_STATE_THREAD(stop_iteration_arg);
-                }
-                task->done = true;
-                done_total++;
-
-                // If enough tasks are done, don't finish this round. This way,
-                // in race(), there is only one winner.
-                if (done_total >= self->num_tasks_required) {
-                    // Cancel everything else.
-                    pb_type_Task_close(self_in);
-                    break;
-                }
+            if (MP_STATE_THREAD(stop_iteration_arg) != MP_OBJ_NULL) {
+                task->return_val = MP_STATE_THREAD(stop_iteration_arg);
+            }
+            task->done = true;
+            done_total++;
+
+            // If enough tasks are done, don't finish this round. This way,
+            // in race(), there is only one winner.
+            if (done_total >= self->num_tasks_required) {
+                // Cancel everything else.
+                pb_type_Task_close(self_in);
+                break;
             }
         }
         // Successfully did one iteration of all tasks.
         nlr_pop();
 
-        // If collection not done yet, indicate that it should run again.
+        // If collection not done yet, indicate that it should run again. If
+        // all tasks are waiting, tell our own scheduler how long it can skip
+        // us, so that it can sleep instead of polling.
         if (done_total < self->num_tasks_required) {
+            if (all_sleeping) {
+                return pb_type_async_new_skip_time((int32_t)(wake_time - pbdrv_clock_get_ms()));
+            }
             return mp_const_none;
         }
 
@@ -150,6 +193,7 @@ static mp_obj_t pb_type_Task_new(const mp_obj_type_t *type, size_t n_args, size_
         task->return_val = mp_const_none;
         task->iterable = mp_getiter(args[i], &task->iter_buf);
         task->done = false;
+        task->sleeping = false;
     }
     return MP_OBJ_FROM_PTR(self);
 }
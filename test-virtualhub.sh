@@ -28,7 +28,16 @@ make -s -j $(nproc --all) -C "$BRICK_DIR" BUILD="$BUILD_DIR_NAME" CI_MODE=1
 export MICROPY_MICROPYTHON="$BUILD_DIR/firmware.elf"
 
 cd "$MP_TEST_DIR"
-./run-tests.py --test-dirs $(find "$PB_TEST_DIR/virtualhub" -type d -and ! -wholename "*/build/*"  -and ! -wholename "*/run_test.py") "$@" || \
+# Packages hold modules that are imported by the tests, so they are skipped.
+./run-tests.py --test-dirs $(find "$PB_TEST_DIR/virtualhub" -type d -and ! -wholename "*/build/*"  -and ! -wholename "*/run_test.py" -and ! -exec test -e "{}/__init__.py" \; -print) "$@" || \
+    (code=$?; ./run-tests.py --print-failures; exit $code)
+
+# Run the virtual clock tests on a build that uses the virtual clock of the
+# local build instead of the counting clock.
+VIRTUAL_CLOCK_BUILD_DIR_NAME="build-virtual-clock"
+make -s -j $(nproc --all) -C "$BRICK_DIR" BUILD="$VIRTUAL_CLOCK_BUILD_DIR_NAME" CI_MODE=1 VIRTUAL_CLOCK=1 COVERAGE=
+MICROPY_MICROPYTHON="$BRICK_DIR/$VIRTUAL_CLOCK_BUILD_DIR_NAME/firmware.elf" PBIO_VIRTUAL_HUB_SPEED=max \
+    ./run-tests.py --test-dirs "$PB_TEST_DIR/virtualclock" "$@" || \
     (code=$?; ./run-tests.py --print-failures; exit $code)
 
 if [[ $COVERAGE ]]; then
@@ -0,0 +1,42 @@
+# SPDX-License-Identifier: MIT
+# Copyright (c) 2025 The Pybricks Authors
+
+"""
+Hardware Module: 1
+
+Description: Verify that reflection(fresh=True) waits for new sensor data,
+so a loop runs at the data rate of the sensor instead of oversampling.
+"""
+
+from pybricks.pupdevices import ColorSensor
+from pybricks.parameters import Port
+from pybricks.tools import StopWatch
+
+# Initialize device.
+color_sensor = ColorSensor(Port.B)
+watch = StopWatch()
+
+# Without waiting for new data, reading is much faster than the data rate.
+color_sensor.reflection()
+watch.reset()
+for i in range(100):
+    color_sensor.reflection()
+time_stale = watch.time()
+
+# Waiting for new data makes each reading take about one sample period.
+watch.reset()
+for i in range(100):
+    color_sensor.reflection(fresh=True)
+time_fresh = watch.time()
+
+assert time_fresh > time_stale * 5, "Expected slower loop, got {0} and {1} ms.".format(
+    time_fresh, time_stale
+)
+
+# The fresh argument is keyword-only.
+try:
+    color_sensor.reflection(True)
+except TypeError:
+    pass
+else:
+    raise AssertionError("Expected positional argument to be refused.")
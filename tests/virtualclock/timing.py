@@ -0,0 +1,42 @@
+from pybricks.parameters import Port
+from pybricks.pupdevices import Motor
+from pybricks.tools import StopWatch, multitask, run_task, wait
+
+motor = Motor(Port.A)
+watch = StopWatch()
+
+
+def rounded(value, step):
+    return round(value / step) * step
+
+
+# The clock jumps ahead while the hub is idle, but the program still sees
+# the full duration pass.
+watch.reset()
+wait(5000)
+print("wait", rounded(watch.time(), 100))
+
+# Timed maneuvers take as long as they would in real time.
+watch.reset()
+motor.run_time(500, 2000)
+print("run_time", rounded(watch.time(), 100))
+
+# The simulated motor reaches its target as it would in real time.
+motor.reset_angle(0)
+motor.run_target(500, 360)
+wait(500)
+print("run_target", rounded(motor.angle(), 10))
+
+motor.run_angle(500, 180)
+wait(500)
+print("run_angle", rounded(motor.angle(), 10))
+
+
+# Tasks wait at the same time.
+async def main():
+    watch.reset()
+    await multitask(wait(1000), wait(3000))
+    print("multitask", rounded(watch.time(), 100))
+
+
+run_task(main())
@@ -0,0 +1,83 @@
+# Imports many modules that were downloaded along with the main program.
+
+from pybricks.tools import StopWatch
+
+from many_modules.many_00 import VALUE as value_00
+from many_modules.many_01 import VALUE as value_01
+from many_modules.many_02 import VALUE as value_02
+from many_modules.many_03 import VALUE as value_03
+from many_modules.many_04 import VALUE as value_04
+from many_modules.many_05 import VALUE as value_05
+from many_modules.many_06 import VALUE as value_06
+from many_modules.many_07 import VALUE as value_07
+from many_modules.many_08 import VALUE as value_08
+from many_modules.many_09 import VALUE as value_09
+from many_modules.many_10 import VALUE as value_10
+from many_modules.many_11 import VALUE as value_11
+from many_modules.many_12 import VALUE as value_12
+from many_modules.many_13 import VALUE as value_13
+from many_modules.many_14 import VALUE as value_14
+from many_modules.many_15 import VALUE as value_15, IMPORTED
+
+print(
+    [
+        value_00,
+        value_01,
+        value_02,
+        value_03,
+        value_04,
+        value_05,
+        value_06,
+        value_07,
+        value_08,
+        value_09,
+        value_10,
+        value_11,
+        value_12,
+        value_13,
+        value_14,
+        value_15,
+    ]
+)
+
+# Modules that are already imported don't have to be found again.
+IMPORTED[0] = True
+from many_modules.many_15 import IMPORTED
+
+print(IMPORTED)
+
+# Modules that don't exist are not found.
+try:
+    import many_16
+except ImportError:
+    print("ImportError")
+
+# Looking up a module that doesn't exist has to check the whole table, and
+# it isn't cached, so it can be repeated. Compare it to the same loop that
+# raises the error without looking anything up.
+LOOKUPS = 1000
+
+
+def missing_modules():
+    watch = StopWatch()
+    for i in range(LOOKUPS):
+        try:
+            __import__("many_16")
+        except ImportError:
+            pass
+    return watch.time()
+
+
+def baseline():
+    watch = StopWatch()
+    for i in range(LOOKUPS):
+        try:
+            raise ImportError
+        except ImportError:
+            pass
+    return watch.time()
+
+
+lookup_time = missing_modules()
+baseline_time = baseline()
+assert lookup_time <= 2 * baseline_time + 10, (lookup_time, baseline_time)
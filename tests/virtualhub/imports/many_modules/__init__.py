@@ -0,0 +1 @@
+# Package of modules imported by many.py.
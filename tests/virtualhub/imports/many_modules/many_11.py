@@ -0,0 +1,3 @@
+# Module imported by ../many.py.
+
+VALUE = 11
@@ -0,0 +1,6 @@
+# Module imported by ../many.py.
+
+VALUE = 15
+
+# Changed by many.py to check that the module is not loaded twice.
+IMPORTED = [False]
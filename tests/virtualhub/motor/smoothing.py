@@ -0,0 +1,36 @@
+from pybricks.parameters import Port
+from pybricks.pupdevices import Motor
+from pybricks.tools import StopWatch
+
+motor = Motor(Port.A)
+watch = StopWatch()
+
+# Smoothing is a percentage, so other values are refused.
+for value in (-1, 101):
+    try:
+        motor.control.limits(smoothing=value)
+    except ValueError:
+        pass
+    else:
+        raise AssertionError("Expected smoothing={0} to be refused.".format(value))
+
+# Getting the limits still gives speed, acceleration, and torque.
+speed, acceleration, torque = motor.control.limits()
+
+# Trapezoidal maneuver.
+watch.reset()
+motor.run_target(500, 720)
+time_trapezoid = watch.time()
+assert abs(motor.angle() - 720) < 5
+
+# Fully smoothed maneuver halves the average acceleration, so it takes longer
+# but still arrives at the target. Other limits are not changed.
+motor.control.limits(smoothing=100)
+assert motor.control.limits() == (speed, acceleration, torque)
+watch.reset()
+motor.run_target(500, 0)
+time_smooth = watch.time()
+assert abs(motor.angle()) < 5
+assert time_smooth > time_trapezoid + 100, "Expected slower maneuver, got {0} and {1} ms.".format(
+    time_smooth, time_trapezoid
+)
@@ -0,0 +1,58 @@
+from pybricks.pupdevices import Motor
+from pybricks.parameters import Port
+from pybricks.tools import async_pool_stats, multitask, run_task, wait
+
+import gc
+
+motor = Motor(Port.A)
+
+
+async def waiter(n):
+    for i in range(n):
+        await wait(0)
+
+
+async def mover(n):
+    for i in range(n // 100):
+        await motor.run_angle(500, 5)
+
+
+async def stepper(n):
+    for i in range(n // 10):
+        await wait(1)
+
+
+def heap_growth(n):
+    # Measure without collecting garbage, so that anything allocated on each
+    # iteration adds up.
+    gc.collect()
+    gc.disable()
+    before = gc.mem_alloc()
+    run_task(multitask(waiter(n), mover(n), stepper(n)))
+    after = gc.mem_alloc()
+    gc.enable()
+    return after - before
+
+
+# Steady state async loops should not allocate awaitables, so the heap should
+# grow just as much for 10000 iterations as it does for 100.
+short = heap_growth(100)
+async_pool_stats(reset=True)
+long = heap_growth(10000)
+print(long - short)
+
+stats = async_pool_stats()
+print(stats["exhausted"], stats["used_max"] <= stats["size"])
+
+
+# Motor commands that are replaced by another one before they are awaited
+# give their awaitable back to the pool right away.
+async def impatient():
+    for i in range(stats["size"] * 2):
+        motor.run_angle(500, 5)
+    await motor.run_angle(500, 5)
+
+
+async_pool_stats(reset=True)
+run_task(impatient())
+print(async_pool_stats()["exhausted"])
@@ -0,0 +1,80 @@
+from pybricks.tools import multitask, run_task, wait, StopWatch
+
+watch = StopWatch()
+DURATION = 500
+NUM_SLEEPERS = 20
+
+
+async def sleeper():
+    while watch.time() < DURATION:
+        await wait(100)
+
+
+async def spinner(counter):
+    # Counts how many times the scheduler gets back to us.
+    while watch.time() < DURATION:
+        counter[0] += 1
+        await wait(0)
+
+
+passes = {}
+
+
+async def measure(num_sleepers):
+    counter = [0]
+    watch.reset()
+    await multitask(spinner(counter), *[sleeper() for _ in range(num_sleepers)])
+    passes[num_sleepers] = counter[0]
+
+
+# Waiting tasks are skipped until they are done, so they should hardly slow
+# down a task that runs on every pass.
+run_task(measure(0))
+run_task(measure(NUM_SLEEPERS))
+overhead = (passes[0] - passes[NUM_SLEEPERS]) / passes[0] / NUM_SLEEPERS
+print("overhead per task below 2.5%:", overhead < 0.025)
+
+# Allowed difference in ms between the expected and actual wake up time.
+TOLERANCE = 5
+
+
+async def timed(delay, done):
+    await wait(delay)
+    done.append((delay, watch.time()))
+
+
+async def nested(done):
+    await multitask(timed(25, done), timed(15, done))
+
+
+# Sleeping tasks still wake up on time, including nested ones.
+done = []
+watch.reset()
+run_task(multitask(timed(50, done), timed(10, done), nested(done), timed(40, done), timed(30, done)))
+print([delay for delay, time in done])
+for delay, time in done:
+    assert abs(time - delay) <= TOLERANCE, (delay, time)
+assert abs(watch.time() - 50) <= TOLERANCE, watch.time()
+
+# Only one task completes.
+done = []
+watch.reset()
+run_task(multitask(timed(50, done), timed(10, done), race=True))
+print([delay for delay, time in done])
+assert abs(watch.time() - 10) <= TOLERANCE, watch.time()
+
+
+def yielder(delay, done):
+    # Yielding a number of milliseconds skips the task for that long, just
+    # like awaiting wait().
+    yield delay
+    done.append((delay, watch.time()))
+
+
+# Generators can also yield how long they can be skipped.
+done = []
+watch.reset()
+run_task(multitask(yielder(30, done), timed(20, done)))
+print([delay for delay, time in done])
+for delay, time in done:
+    assert abs(time - delay) <= TOLERANCE, (delay, time)